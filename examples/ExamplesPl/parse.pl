@@ -0,0 +1,165 @@
+%   parse
+%
+%   Parser benchmark: reads terms from generated inputs
+%   - a term with many named variables (variable dictionary)
+%   - a long list (list parsing)
+%   - a long expression mixing operators (operator lookups)
+
+
+parse(ShowResult) :-
+	parse_inputs(Inputs),
+	parse_all(Inputs, Results),
+	(   ShowResult = true ->
+	    write(Results), nl
+	;   true).
+
+
+parse_all([], []).
+
+parse_all([Input|Inputs], [Result|Results]) :-
+	read_term_from_atom(Input, Term, [end_of_term(eof)]),
+	parse_result(Term, Result),
+	parse_all(Inputs, Results).
+
+
+parse_result(f(Vars), vars(N)) :-
+	!,
+	sort(Vars, Vars1),
+	length(Vars1, N).
+
+parse_result(Term, list(N)) :-
+	Term = [_|_], !,
+	length(Term, N).
+
+parse_result(Term, expr(F/N)) :-
+	functor(Term, F, N).
+
+
+
+
+% the inputs are generated once
+
+parse_inputs(Inputs) :-
+	g_read(parse_inputs, Inputs),
+	Inputs \== 0, !.
+
+parse_inputs(Inputs) :-
+	gen_vars(20000, A1),
+	gen_list(100000, A2),
+	gen_expr(20000, A3),
+	Inputs = [A1, A2, A3],
+	g_assign(parse_inputs, Inputs).
+
+
+
+
+% each input is written on an atom stream
+
+gen_atom(Goal, A) :-
+	open_output_atom_stream(S),
+	call(Goal, S),
+	close_output_atom_stream(S, A).
+
+
+
+
+% f([X1,...,XN,XN,...,X1])
+
+gen_vars(N, A) :-
+	gen_atom(write_vars(N), A).
+
+
+write_vars(N, S) :-
+	write(S, 'f(['),
+	write_vars_up(1, N, S),
+	write_vars_down(N, S),
+	write(S, '])').
+
+
+write_vars_up(I, N, _) :-
+	I > N, !.
+
+write_vars_up(I, N, S) :-
+	write(S, 'X'),
+	write(S, I),
+	write(S, ','),
+	I1 is I + 1,
+	write_vars_up(I1, N, S).
+
+
+write_vars_down(1, S) :-
+	!,
+	write(S, 'X1').
+
+write_vars_down(I, S) :-
+	write(S, 'X'),
+	write(S, I),
+	write(S, ','),
+	I1 is I - 1,
+	write_vars_down(I1, S).
+
+
+
+
+% [1,2,...,N]
+
+gen_list(N, A) :-
+	gen_atom(write_list(N), A).
+
+
+write_list(N, S) :-
+	write(S, '[1'),
+	write_list(2, N, S),
+	write(S, ']').
+
+
+write_list(I, N, _) :-
+	I > N, !.
+
+write_list(I, N, S) :-
+	write(S, ','),
+	write(S, I),
+	I1 is I + 1,
+	write_list(I1, N, S).
+
+
+
+
+% x1 + x2 * x3 - - x4 / ... (with some prefix minus)
+
+gen_expr(N, A) :-
+	gen_atom(write_expr(N), A).
+
+
+write_expr(N, S) :-
+	write(S, x1),
+	write_expr(2, N, S).
+
+
+write_expr(I, N, _) :-
+	I > N, !.
+
+write_expr(I, N, S) :-
+	Op is I mod 4,
+	gen_op(Op, OpA),
+	write(S, OpA),
+	write(S, x),
+	write(S, I),
+	I1 is I + 1,
+	write_expr(I1, N, S).
+
+
+gen_op(0, ' + ').
+gen_op(1, ' * ').
+gen_op(2, ' - - ').
+gen_op(3, ' / ').
+
+
+
+
+% benchmark interface
+
+benchmark(ShowResult) :-
+	parse(ShowResult).
+
+:- include(common).
@@ -43,4 +43,6 @@
 	'$use_fd_bool',
 	'$use_fd_prime',
 	'$use_fd_symbolic',
-	'$use_fd_optim'.
+	'$use_fd_sched',
+	'$use_fd_optim',
+	'$use_fd_parallel'.
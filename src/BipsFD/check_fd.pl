@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : FD constraint solver                                            *
+ * File  : check_fd.pl                                                     *
+ * Descr.: FD solver regression checks                                     *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * GNU Prolog is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU General Public License as published by the   *
+ * Free Software Foundation; either version 2, or any later version.       *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU        *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc.  *
+ * 51 Franklin St, Fifth Floor, Boston, MA  02110-1301, USA.               *
+ *-------------------------------------------------------------------------*/
+
+/* Checks run by make check. Each check/1 goal must succeed
+ * (the program exits with status 1 otherwise).
+ */
+
+:-	initialization(main).
+
+
+main :-
+	(   check(Name),
+	    \+ catch(Name, _, fail),
+	    format('FD check ~w: FAILED~n', [Name]),
+	    halt(1)
+	;   write('FD constraint solver OK'),
+	    nl,
+	    halt
+	).
+
+
+
+
+check(wide_holes).
+check(wide_holes_backtrack).
+check(wide_element).
+check(wide_element_var).
+check(big_relation).
+check(long_sum).
+
+
+	% removing many values from a wide domain (interval list) must not
+	% exhaust the constraint stack (each removal used to copy the list)
+
+wide_holes :-
+	fd_domain(X, 0, 1000000),
+	remove_multiples(X, 3, 1, 20000),
+	fd_size(X, 980001),
+	fd_max(X, 1000000),
+	fd_min(X, 0),
+	X #\= 0,
+	fd_min(X, 1),
+	\+ X = 60000,
+	X = 60001.
+
+
+
+
+	% holes added after a choice point are undone on backtracking
+
+wide_holes_backtrack :-
+	fd_domain(X, 0, 1000000),
+	remove_multiples(X, 7, 1, 300),
+	fd_size(X, S0),
+	(   remove_multiples(X, 5, 1, 500),
+	    remove_multiples(X, 11, 1, 50),
+	    fail
+	;   true
+	),
+	fd_size(X, S0),
+	X #\= 5,
+	fd_size(X, S1),
+	S1 =:= S0 - 1,
+	\+ X = 7,
+	X = 10.
+
+
+
+
+	% fd_element/3 and fd_element_var/3 with more indexes than the
+	% vector max (by default 127 on 32 bits, 255 on 64 bits)
+
+wide_element :-
+	findall(V, (between(1, 300, J), V is J mod 7), L),
+	fd_element(I, L, V),
+	fd_min(I, 1),
+	fd_max(I, 300),
+	V = 3,
+	fd_min(I, 3),
+	fd_max(I, 297),
+	fd_size(I, 43),
+	I #> 290,
+	I == 297.
+
+
+
+
+wide_element_var :-
+	length(L, 300),
+	fd_domain(L, 0, 9),
+	fd_element_var(I, L, V),
+	fd_max(I, 300),
+	V #> 5,
+	nth(300, L, 2),
+	nth(1, L, 0),
+	fd_min(I, 2),
+	fd_max(I, 299),
+	fd_size(I, 298).
+
+
+
+
+	% fd_relation/2 with many tuples (its table is linear in their number)
+
+big_relation :-
+	findall([X, Y, J], (between(1, 100000, J), X is J mod 1000,
+			    Y is J // 7 mod 5000), Tuples),
+	fd_relation(Tuples, [A, B, C]),
+	A = 5,
+	fd_size(C, 100),
+	B = 715,
+	fd_dom(C, [5005, 40005, 75005]).
+
+
+
+
+	% a long linear sum is a single n-ary constraint (the chain of ternary
+	% constraints overflows the trail when labeling such a sum)
+
+long_sum :-
+	length(L, 1500),
+	fd_domain(L, 0, 10),
+	sum_expr(L, E),
+	E #= 7500,
+	fd_labeling(L),
+	sum_list(L, 7500),
+	length(L1, 600),
+	fd_domain(L1, 0, 1),
+	sum_expr(L1, E1),
+	\+ E1 #> 600,
+	E1 #>= 600,
+	sum_list(L1, 600).
+
+
+
+
+sum_expr([X|L], E) :-
+	sum_expr(L, X, E).
+
+sum_expr([], E, E).
+
+sum_expr([X|L], E0, E) :-
+	sum_expr(L, E0 + X, E).
+
+
+
+
+remove_multiples(_, _, I, N) :-
+	I > N, !.
+
+remove_multiples(X, K, I, N) :-
+	V is I * K,
+	X #\= V,
+	I1 is I + 1,
+	remove_multiples(X, K, I1, N).
@@ -188,7 +188,7 @@ Pl_Fd_Dom_2(WamWord fdv_word, WamWord list_word)
 	      list_word = Pl_Unify_Variable();
 	    }
 	}
-      else
+      else if (Is_Sparse(Range(fdv_adr)))
 	{
 	  VECTOR_BEGIN_ENUM(Vec(fdv_adr), vec_elem);
 
@@ -199,6 +199,17 @@ Pl_Fd_Dom_2(WamWord fdv_word, WamWord list_word)
 
 	  VECTOR_END_ENUM;
 	}
+      else			/* interval list */
+	{
+	  RANGE_BEGIN_ENUM(Range(fdv_adr), vec_elem);
+
+	  if (!Pl_Get_List(list_word) || !Pl_Unify_Integer(vec_elem))
+	    return FALSE;
+
+	  list_word = Pl_Unify_Variable();
+
+	  RANGE_END_ENUM;
+	}
     }
 
   return Pl_Get_Nil(list_word);
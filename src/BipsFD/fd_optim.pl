@@ -77,3 +77,96 @@ fd_maximize(Goal, Var) :-
 	    Var = B,
 	    '$call'(Goal, fd_maximize, 2, true)
 	).
+
+
+
+
+fd_minimize(Goal, Var, Options) :-
+	set_bip_name(fd_minimize, 3),
+	'$fd_optim_options'(Options, TimeLimit, NodeLimit),
+	'$fd_optimize'(Goal, Var, 0, TimeLimit, NodeLimit, fd_minimize/3).
+
+
+
+
+fd_maximize(Goal, Var, Options) :-
+	set_bip_name(fd_maximize, 3),
+	'$fd_optim_options'(Options, TimeLimit, NodeLimit),
+	'$fd_optimize'(Goal, Var, 1, TimeLimit, NodeLimit, fd_maximize/3).
+
+
+
+
+	% branch-and-bound without restart: once a solution is found its cost
+	% bounds the objective at each propagation (see fd_optim_c.c) and the
+	% solution is recorded, so the optimal one needs not be recomputed.
+
+'$fd_optimize'(Goal, Var, Maximize, TimeLimit, NodeLimit, Func / Arity) :-
+	fd_max_integer(Inf),
+	'$fd_domain'(Var, 0, Inf),
+	g_read('$fd_bb_sol', Saved),
+	set_bip_name(Func, Arity),
+	'$call_c'('Pl_Fd_Bb_Begin_4'(Var, Maximize, TimeLimit, NodeLimit)),
+	catch('$fd_optimize1'(Goal, Var, Func, Arity), Err,
+	      '$fd_optimize_catch'(Err, Saved)),
+	'$fd_optimize_end'(Saved, 1, SolGoal - Cost),
+	Var = Cost,
+	Goal = SolGoal.
+
+
+'$fd_optimize1'(Goal, Var, Func, Arity) :-
+	'$call'(Goal, Func, Arity, true),
+	'$call_c_test'('Pl_Fd_Bb_Solution_2'(Var, Cost)),
+	g_assign('$fd_bb_sol', Goal - Cost),
+	fail.
+
+'$fd_optimize1'(_, _, _, _).
+
+
+'$fd_optimize_catch'('$fd_bb_stop', _) :-	% a limit is reached
+	!.
+
+'$fd_optimize_catch'(Err, Saved) :-
+	'$fd_optimize_end'(Saved, _, _),
+	throw(Err).
+
+
+'$fd_optimize_end'(Saved, Found, Sol) :-
+	'$call_c_test'('Pl_Fd_Bb_End_1'(Found0)),
+	g_read('$fd_bb_sol', Sol0),
+	g_assign('$fd_bb_sol', Saved),
+	Found = Found0,
+	Sol = Sol0.
+
+
+
+
+'$fd_optim_options'(Options, TimeLimit, NodeLimit) :-
+	'$check_list'(Options),
+	g_assign('$fd_optim_time', 0),
+	g_assign('$fd_optim_nodes', 0),
+	'$fd_optim_options1'(Options),
+	g_read('$fd_optim_time', TimeLimit),
+	g_read('$fd_optim_nodes', NodeLimit).
+
+
+'$fd_optim_options1'([]).
+
+'$fd_optim_options1'([X|Options]) :-
+	'$fd_optim_options2'(X), !,
+	'$fd_optim_options1'(Options).
+
+
+'$fd_optim_options2'(X) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$fd_optim_options2'(time_limit(X)) :-	% checked by Pl_Fd_Bb_Begin_4
+	g_assign('$fd_optim_time', X).
+
+'$fd_optim_options2'(node_limit(X)) :-
+	g_assign('$fd_optim_nodes', X).
+
+'$fd_optim_options2'(X) :-
+	'$pl_err_domain'(fd_optimization_option, X).
+
@@ -0,0 +1,255 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * File  : fd_optim_c.c                                                    *
+ * Descr.: optimization predicate management - C part                      *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+#include "engine_fd.h"
+#include "bips_fd.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define TIME_CHECK_MASK            63	/* check the clock every 64 nodes */
+
+#define STOP_BALL                  "$fd_bb_stop"
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct bb_inf *PBbInf;
+
+typedef struct bb_inf		/* branch-and-bound search information */
+{				/* ------------------------------------ */
+  WamWord *fdv_adr;		/* objective variable (NULL if integer) */
+  Bool maximize;		/* maximize instead of minimize         */
+  Bool found;			/* a solution has been recorded         */
+  int bound;			/* cost of the best solution            */
+  PlLong nb_nodes;		/* number of labeling nodes visited     */
+  PlLong node_limit;		/* max number of nodes (0 = no limit)   */
+  PlLong deadline;		/* real time limit (0 = no limit)       */
+  PBbInf prev;			/* enclosing search (nested calls)      */
+}
+BbInf;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static PBbInf bb_top = NULL;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Set_Engine_Bound(PBbInf bb);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_BB_BEGIN_4                                                        *
+ *                                                                         *
+ * Starts a branch-and-bound search on the objective variable var_word.    *
+ * The searches are stacked to allow an optimization inside another one.   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Bb_Begin_4(WamWord var_word, WamWord maximize_word,
+		 WamWord time_limit_word, WamWord node_limit_word)
+{
+  WamWord word, tag_mask;
+  PBbInf bb;
+  PlLong time_limit, node_limit;
+
+  time_limit = Pl_Rd_Positive_Check(time_limit_word);
+  node_limit = Pl_Rd_Positive_Check(node_limit_word);
+
+  bb = (PBbInf) Malloc(sizeof(BbInf));
+
+  DEREF(var_word, word, tag_mask);
+  bb->fdv_adr = (tag_mask == TAG_FDV_MASK) ? UnTag_FDV(word) : NULL;
+  bb->maximize = Pl_Rd_Integer(maximize_word);
+  bb->found = FALSE;
+  bb->bound = 0;
+  bb->nb_nodes = 0;
+  bb->node_limit = node_limit;
+  bb->deadline = (time_limit > 0) ? Pl_M_Real_Time() + time_limit : 0;
+
+  bb->prev = bb_top;
+  bb_top = bb;
+  Set_Engine_Bound(bb);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_BB_END_1                                                          *
+ *                                                                         *
+ * Ends the current search and unifies found_word with 1 if a solution has *
+ * been recorded (0 otherwise).                                            *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Bb_End_1(WamWord found_word)
+{
+  PBbInf bb = bb_top;
+  Bool found;
+
+  if (bb == NULL)
+    return FALSE;
+
+  found = bb->found;
+  bb_top = bb->prev;
+  Free(bb);
+  Set_Engine_Bound(bb_top);
+
+  return Pl_Get_Integer(found, found_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_BB_SOLUTION_2                                                     *
+ *                                                                         *
+ * Called each time the goal succeeds: fails if the solution is not better *
+ * than the best one. Otherwise the new bound is recorded (and from now    *
+ * enforced by each propagation) and unified with cost_word.               *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Bb_Solution_2(WamWord var_word, WamWord cost_word)
+{
+  WamWord word, tag_mask;
+  PBbInf bb = bb_top;
+  WamWord *fdv_adr;
+  int cost;
+
+  if (bb == NULL)
+    return FALSE;
+
+  DEREF(var_word, word, tag_mask);
+  if (tag_mask == TAG_INT_MASK)
+    cost = UnTag_INT(word);
+  else if (tag_mask == TAG_FDV_MASK)
+    {
+      fdv_adr = UnTag_FDV(word);
+      cost = (bb->maximize) ? Max(fdv_adr) : Min(fdv_adr);
+    }
+  else
+    return FALSE;
+
+  if (bb->found && ((bb->maximize) ? cost <= bb->bound : cost >= bb->bound))
+    return FALSE;
+
+  bb->found = TRUE;
+  bb->bound = cost;
+  Set_Engine_Bound(bb);
+
+  return Pl_Get_Integer(cost, cost_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_BB_NODE                                                           *
+ *                                                                         *
+ * Called by the labeling before each choice: counts the node and checks   *
+ * the limits. When a limit is reached the search is aborted by throwing   *
+ * STOP_BALL (caught by fd_minimize/3 and fd_maximize/3).                  *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Bb_Node(void)
+{
+  PBbInf bb = bb_top;
+
+  if (bb == NULL)
+    return;
+
+  bb->nb_nodes++;
+  if ((bb->node_limit > 0 && bb->nb_nodes > bb->node_limit) ||
+      (bb->deadline > 0 && (bb->nb_nodes & TIME_CHECK_MASK) == 0 &&
+       Pl_M_Real_Time() >= bb->deadline))
+    Pl_Throw(Tag_ATM(Pl_Create_Atom(STOP_BALL)));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SET_ENGINE_BOUND                                                        *
+ *                                                                         *
+ * Installs the bound of bb (if any) in the solver. It is then enforced at *
+ * each constraint addition (see Pl_Fd_After_Add_Cstr).                    *
+ *-------------------------------------------------------------------------*/
+static void
+Set_Engine_Bound(PBbInf bb)
+{
+  if (bb == NULL || bb->fdv_adr == NULL || !bb->found)
+    {
+      pl_fd_bound_adr = NULL;
+      return;
+    }
+
+  pl_fd_bound_adr = bb->fdv_adr;
+  if (bb->maximize)
+    {
+      pl_fd_bound_min = bb->bound + 1;
+      pl_fd_bound_max = INTERVAL_MAX_INTEGER;
+    }
+  else
+    {
+      pl_fd_bound_min = 0;
+      pl_fd_bound_max = bb->bound - 1;
+    }
+}
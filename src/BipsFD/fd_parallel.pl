@@ -0,0 +1,414 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * File  : fd_parallel.pl                                                  *
+ * Descr.: parallel search management                                      *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in_fd.
+
+'$use_fd_parallel'.
+
+
+	% Embarrassingly parallel search: the first variables of the search
+	% (split variables) are labeled by the master, each assignment which
+	% survives propagation is a subproblem solved by a worker process
+	% (fork_prolog/1). Tasks and replies are exchanged with fast_write/2
+	% and fast_read/2 through pipes, the master waits on the replies with
+	% a poller. A worker only handles one task at a time, so its pipes
+	% never contain more than one pending message.
+
+
+fd_parallel_labeling(List, Options) :-
+	set_bip_name(fd_parallel_labeling, 2),
+	'$check_list'(List),
+	'$fd_par_options'(Options, Workers, Depth, LabOptions),
+	set_bip_name(fd_parallel_labeling, 2),	% reset by '$fd_par_options'
+	'$set_labeling_defaults',	% check the labeling options now
+	'$get_labeling_options'(LabOptions, _),
+	'$fd_par_prefix'(Depth, Workers, List, Prefix),
+	(   Workers > 1,
+	    '$fd_par_subproblems'(Prefix, Subs),
+	    Subs = [_, _|_] ->
+	    '$fd_par_run'(labeling(List, Prefix, LabOptions), Subs, Workers, 0,
+			  sol(List))
+	;   once('$fd_labeling'(List, LabOptions))
+	).
+
+
+
+
+fd_parallel_minimize(Goal, Var, List, Options) :-
+	set_bip_name(fd_parallel_minimize, 4),
+	'$fd_par_optimize'(Goal, Var, List, Options, 0, fd_parallel_minimize/4).
+
+
+
+
+fd_parallel_maximize(Goal, Var, List, Options) :-
+	set_bip_name(fd_parallel_maximize, 4),
+	'$fd_par_optimize'(Goal, Var, List, Options, 1, fd_parallel_maximize/4).
+
+
+
+
+'$fd_par_optimize'(Goal, Var, List, Options, Maximize, Func) :-
+	'$check_list'(List),
+	'$fd_par_options'(Options, Workers, Depth, OptOptions),
+	fd_max_integer(Inf),
+	Func = Name / Arity,
+	set_bip_name(Name, Arity),	% reset by '$fd_par_options'
+	'$fd_optim_options'(OptOptions, TimeLimit, NodeLimit),
+	'$fd_domain'(Var, 0, Inf),
+	'$fd_par_prefix'(Depth, Workers, List, Prefix),
+	(   Workers > 1,
+	    '$fd_par_subproblems'(Prefix, Subs),
+	    Subs = [_, _|_] ->
+	    '$fd_par_run'(optim(Goal, Var, Prefix, Maximize, NodeLimit, Func),
+			  Subs, Workers, TimeLimit, best(Var, Goal))
+	;   '$fd_optimize'(Goal, Var, Maximize, TimeLimit, NodeLimit, Func)
+	).
+
+
+
+
+'$fd_par_options'(Options, Workers, Depth, Others) :-
+	'$check_list'(Options),
+	'$fd_par_options1'(Options, 0, Workers0, 0, Depth, Others),
+	(   Workers0 > 0 ->
+	    Workers = Workers0
+	;   '$call_c_test'('Pl_Fd_Par_Nb_Cpus_1'(Workers))
+	).
+
+
+'$fd_par_options1'([], W, W, D, D, []).
+
+'$fd_par_options1'([X|Options], W0, W, D0, D, Others) :-
+	'$fd_par_option'(X, W0, W1, D0, D1, Others, Others1), !,
+	'$fd_par_options1'(Options, W1, W, D1, D, Others1).
+
+
+'$fd_par_option'(X, _, _, _, _, _, _) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$fd_par_option'(workers(W), _, W, D, D, Others, Others) :-
+	'$fd_par_check_count'(W).
+
+'$fd_par_option'(split_depth(D), W, W, _, D, Others, Others) :-
+	'$fd_par_check_count'(D).
+
+'$fd_par_option'(X, W, W, D, D, [X|Others], Others).
+
+
+'$fd_par_check_count'(X) :-
+	'$check_nonvar'(X),
+	(   integer(X) ->
+	    true
+	;   '$pl_err_type'(integer, X)
+	),
+	(   X @< 0 ->
+	    '$pl_err_domain'(not_less_than_zero, X)
+	;   true
+	).
+
+
+
+
+	% the split variables are given by split_depth(D) or are the shortest
+	% prefix giving at least 8 assignments per worker.
+
+'$fd_par_prefix'(0, Workers, List, Prefix) :-
+	!,
+	Goal is Workers * 8,
+	'$fd_par_auto_prefix'(List, 1, Goal, Prefix).
+
+'$fd_par_prefix'(Depth, _, List, Prefix) :-
+	'$fd_par_take'(List, Depth, Prefix).
+
+
+'$fd_par_auto_prefix'([X|List], Nb, Goal, [X|Prefix]) :-
+	Nb < Goal, !,
+	fd_size(X, Size),
+	Nb1 is Nb * Size,
+	'$fd_par_auto_prefix'(List, Nb1, Goal, Prefix).
+
+'$fd_par_auto_prefix'(_, _, _, []).
+
+
+'$fd_par_take'([X|List], N, [X|Prefix]) :-
+	N > 0, !,
+	N1 is N - 1,
+	'$fd_par_take'(List, N1, Prefix).
+
+'$fd_par_take'(_, _, []).
+
+
+'$fd_par_subproblems'(Prefix, Subs) :-
+	findall(Prefix, '$fd_labeling'(Prefix, []), Subs).
+
+
+
+
+	% master: spawns the workers, distributes the subproblems and collects
+	% the replies. The result is sol(List) for a labeling (the first
+	% solution stops the search) or best(Var, Goal) for an optimization
+	% (each task is sent with the best bound known so far).
+
+'$fd_par_run'(Search, Subs, Workers, TimeLimit, Result) :-
+	length(Subs, NbSubs),
+	(   NbSubs < Workers ->
+	    NbWorkers = NbSubs
+	;   NbWorkers = Workers
+	),
+	(   TimeLimit > 0 ->
+	    real_time(T),
+	    Deadline is T + TimeLimit
+	;   Deadline = 0
+	),
+	flush_output(user_output),
+	flush_output(user_error),
+	'$fd_par_spawn'(NbWorkers, Search, [], Ws),
+	poller_create(Poller),
+	(   catch('$fd_par_master'(Ws, Poller, Search, Subs, Deadline, Best),
+		  Err, true) ->
+	    true
+	;   Best = none
+	),
+	'$fd_par_stop'(Ws),
+	poller_close(Poller),
+	(   nonvar(Err) ->
+	    throw(Err)
+	;   true
+	),
+	'$fd_par_result'(Best, Result).
+
+
+'$fd_par_result'(sol(Sol), sol(Sol)).
+
+'$fd_par_result'(best(Cost, Sol), best(Cost, Sol)).
+
+
+
+
+'$fd_par_spawn'(0, _, Ws, Ws) :-
+	!.
+
+'$fd_par_spawn'(N, Search, Ws, Ws1) :-
+	create_pipe(TIn, TOut),
+	create_pipe(RIn, ROut),
+	fork_prolog(Pid),
+	(   Pid =:= 0 ->
+	    '$fd_par_child'([w(0, TOut, RIn)|Ws], TIn, ROut, Search)
+	;   close(TIn),
+	    close(ROut),
+	    N1 is N - 1,
+	    '$fd_par_spawn'(N1, Search, [w(Pid, TOut, RIn)|Ws], Ws1)
+	).
+
+
+
+
+'$fd_par_stop'([]).
+
+'$fd_par_stop'([w(Pid, TOut, RIn)|Ws]) :-	% busy workers are killed
+	send_signal(Pid, 15),
+	close(TOut, [force(true)]),
+	close(RIn, [force(true)]),
+	wait(Pid, _),
+	'$fd_par_stop'(Ws).
+
+
+
+
+'$fd_par_master'(Ws, Poller, Search, Subs, Deadline, Best) :-
+	'$fd_par_start'(Ws, Poller, Subs, Subs1, Deadline, 0, Busy),
+	'$fd_par_loop'(Busy, Subs1, Ws, Poller, Search, Deadline, none, Best).
+
+
+'$fd_par_start'([], _, Subs, Subs, _, Busy, Busy).
+
+'$fd_par_start'([W|Ws], Poller, Subs, Subs2, Deadline, Busy, Busy2) :-
+	W = w(_, _, RIn),
+	poller_add(Poller, RIn, [read]),
+	'$fd_par_next_task'(Subs, W, none, Deadline, Subs1, Busy, Busy1),
+	'$fd_par_start'(Ws, Poller, Subs1, Subs2, Deadline, Busy1, Busy2).
+
+
+'$fd_par_next_task'([], _, _, _, [], Busy, Busy).
+
+'$fd_par_next_task'([Values|Subs], w(_, TOut, _), Best, Deadline, Subs1, Busy, Busy1) :-
+	(   Best = best(Bound, _) ->
+	    true
+	;   Bound = none
+	),
+	(   Deadline =:= 0 ->
+	    TimeLimit = 0
+	;   real_time(T),
+	    TimeLimit is Deadline - T
+	),
+	(   Deadline > 0, TimeLimit =< 0 ->	% time out: drop the tasks
+	    Subs1 = [],
+	    Busy1 = Busy
+	;   fast_write(TOut, task(Values, Bound, TimeLimit)),
+	    flush_output(TOut),
+	    Subs1 = Subs,
+	    Busy1 is Busy + 1
+	).
+
+
+
+
+'$fd_par_loop'(0, _, _, _, _, _, Best, Best) :-
+	!.
+
+'$fd_par_loop'(_, _, _, _, _, _, Best, Best) :-
+	Best = sol(_), !.
+
+'$fd_par_loop'(Busy, Subs, Ws, Poller, Search, Deadline, Best, Best2) :-
+	poller_wait(Poller, Ready, -1),
+	'$fd_par_replies'(Ready, Ws, Search, Deadline, Busy, Busy1, Subs, Subs1,
+			  Best, Best1),
+	'$fd_par_loop'(Busy1, Subs1, Ws, Poller, Search, Deadline, Best1, Best2).
+
+
+'$fd_par_replies'([], _, _, _, Busy, Busy, Subs, Subs, Best, Best).
+
+'$fd_par_replies'([RIn-_|Ready], Ws, Search, Deadline, Busy, Busy2, Subs, Subs2,
+		  Best, Best2) :-
+	'$fd_par_worker_of'(Ws, RIn, W),
+	fast_read(RIn, Reply),
+	'$fd_par_reply'(Reply, Search, Best, Best1),
+	Busy1 is Busy - 1,
+	(   Best1 = sol(_) ->
+	    Busy2 = Busy1,
+	    Subs2 = Subs,
+	    Best2 = Best1
+	;   '$fd_par_next_task'(Subs, W, Best1, Deadline, Subs1, Busy1, Busy11),
+	    '$fd_par_replies'(Ready, Ws, Search, Deadline, Busy11, Busy2, Subs1, Subs2,
+			      Best1, Best2)
+	).
+
+
+'$fd_par_worker_of'([W|Ws], RIn, W1) :-
+	W = w(_, _, RIn0),
+	(   RIn0 == RIn ->
+	    W1 = W
+	;   '$fd_par_worker_of'(Ws, RIn, W1)
+	).
+
+
+'$fd_par_reply'(error(Err), _, _, _) :-
+	throw(Err).
+
+'$fd_par_reply'(end_of_file, _, _, _) :-	% the worker has died
+	'$pl_err_system'('fd parallel worker terminated').
+
+'$fd_par_reply'(none, _, Best, Best).
+
+'$fd_par_reply'(sol(Sol), labeling(_, _, _), _, sol(Sol)).
+
+'$fd_par_reply'(sol(Cost - Sol), optim(_, _, _, Maximize, _, _), Best, Best1) :-
+	(   Best = best(Bound, _),
+	    (   Maximize =:= 0 ->
+		Cost >= Bound
+	    ;   Cost =< Bound
+	    ) ->
+	    Best1 = Best
+	;   Best1 = best(Cost, Sol)
+	).
+
+
+
+
+	% worker: solves the tasks until end_of_file (or a signal).
+	% It never returns to the caller of the master.
+
+'$fd_par_child'(Ws, TIn, ROut, Search) :-
+	(   '$fd_par_close_master'(Ws),
+	    '$fd_par_worker'(TIn, ROut, Search) ->
+	    Status = 0
+	;   Status = 1
+	),
+	'$call_c'('Pl_Fd_Par_Exit_1'(Status)).
+
+
+'$fd_par_close_master'([]).
+
+'$fd_par_close_master'([w(_, TOut, RIn)|Ws]) :-
+	close(TOut, [force(true)]),
+	close(RIn, [force(true)]),
+	'$fd_par_close_master'(Ws).
+
+
+'$fd_par_worker'(TIn, ROut, Search) :-
+	repeat,
+	catch(fast_read(TIn, Task), _, Task = end_of_file),
+	(   Task = task(Values, Bound, TimeLimit) ->
+	    catch('$fd_par_solve'(Search, Values, Bound, TimeLimit, Reply),
+		  Err, Reply = error(Err)),
+	    fast_write(ROut, Reply),
+	    flush_output(ROut),
+	    fail
+	;   !
+	).
+
+
+'$fd_par_solve'(labeling(List, Prefix, LabOptions), Values, _, _, Reply) :-
+	(   Prefix = Values,
+	    '$fd_labeling'(List, LabOptions) ->
+	    Reply = sol(List)
+	;   Reply = none
+	).
+
+'$fd_par_solve'(optim(Goal, Var, Prefix, Maximize, NodeLimit, Func),
+		Values, Bound, TimeLimit, Reply) :-
+	(   Prefix = Values,
+	    '$fd_par_bound'(Bound, Var, Maximize),
+	    '$fd_optimize'(Goal, Var, Maximize, TimeLimit, NodeLimit, Func) ->
+	    Reply = sol(Var - Goal)
+	;   Reply = none
+	).
+
+
+'$fd_par_bound'(none, _, _) :-
+	!.
+
+'$fd_par_bound'(Bound, Var, 0) :-
+	Max is Bound - 1,
+	'$fd_domain'(Var, 0, Max).
+
+'$fd_par_bound'(Bound, Var, 1) :-
+	fd_max_integer(Inf),
+	Min is Bound + 1,
+	'$fd_domain'(Var, Min, Inf).
@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * File  : fd_parallel_c.c                                                 *
+ * Descr.: parallel search management - C part                             *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+#include "engine_fd.h"
+#include "bips_fd.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_PAR_NB_CPUS_1                                                     *
+ *                                                                         *
+ * Default number of workers: the number of online processors.             *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Par_Nb_Cpus_1(WamWord nb_word)
+{
+  PlLong nb;
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  SYSTEM_INFO si;
+
+  GetSystemInfo(&si);
+  nb = si.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  nb = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  nb = 1;
+#endif
+
+  if (nb < 1)
+    nb = 1;
+
+  return Pl_Get_Integer(nb, nb_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_PAR_EXIT_1                                                        *
+ *                                                                         *
+ * Terminates a worker process. _exit() is used (and not exit()) since     *
+ * the worker shares the stdio buffers and the atexit() handlers of the    *
+ * master (they must be neither flushed nor run twice).                    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Par_Exit_1(WamWord status_word)
+{
+  _exit(Pl_Rd_Integer(status_word));
+}
@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : FD constraint solver buit-in predicates                         *
+ * File  : fd_sched.pl                                                     *
+ * Descr.: scheduling constraints management                               *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in_fd.
+
+'$use_fd_sched'.
+
+
+fd_cumulative(Starts, Durations, Resources, Limit) :-
+	set_bip_name(fd_cumulative, 4),
+	'$fd_sched_check_tasks'(Starts, Durations, Resources),
+	'$fd_sched_check_nat'(Limit),
+	fd_tell(pl_fd_cumulative(Starts, Durations, Resources, Limit)).
+
+
+
+
+fd_disjunctive(Starts, Durations) :-
+	set_bip_name(fd_disjunctive, 2),
+	'$fd_sched_check_tasks'(Starts, Durations, Durations),
+	fd_tell(pl_fd_disjunctive(Starts, Durations)).
+
+
+
+
+	% the lists must have the same length (else fail) and the durations
+	% and resource consumptions must be non-negative integers.
+
+'$fd_sched_check_tasks'(Starts, Durations, Resources) :-
+	'$check_list'(Starts),
+	'$check_list'(Durations),
+	'$check_list'(Resources),
+	'$fd_sched_check_tasks1'(Starts, Durations, Resources).
+
+
+'$fd_sched_check_tasks1'([], [], []).
+
+'$fd_sched_check_tasks1'([_|Starts], [D|Durations], [R|Resources]) :-
+	'$fd_sched_check_nat'(D),
+	'$fd_sched_check_nat'(R),
+	'$fd_sched_check_tasks1'(Starts, Durations, Resources).
+
+
+
+
+'$fd_sched_check_nat'(X) :-
+	'$check_nonvar'(X),
+	(   integer(X) ->
+	    true
+	;   '$pl_err_type'(integer, X)
+	),
+	(   X @< 0 ->
+	    '$pl_err_domain'(not_less_than_zero, X)
+	;   true
+	).
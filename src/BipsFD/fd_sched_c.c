@@ -0,0 +1,761 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : FD constraint solver buit-in predicates                         *
+ * File  : fd_sched_c.c                                                    *
+ * Descr.: scheduling constraints management - C part                      *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+#include "engine_fd.h"
+#include "bips_fd.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define SCHED_INF                  ((PlLong) 1 << 40)
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct			/* a task (using the resource) */
+{
+  PlLong est;			/* earliest start time */
+  PlLong lct;			/* latest completion time */
+  PlLong p;			/* duration (> 0) */
+  PlLong c;			/* resource consumption (> 0) */
+  int var;			/* index of its start variable */
+}
+SchedTask;
+
+typedef struct			/* a Theta-Lambda tree node (Vilim 2004) */
+{
+  PlLong sp;			/* sum of the durations of Theta */
+  PlLong ect;			/* earliest completion time of Theta */
+  PlLong spb;			/* same as sp with at most one Lambda task */
+  PlLong ectb;			/* same as ect with at most one Lambda task */
+  int resp_spb;			/* Lambda task responsible for spb (or -1) */
+  int resp_ectb;		/* Lambda task responsible for ectb (or -1) */
+}
+SchedNode;
+
+typedef struct			/* a compulsory part event */
+{
+  PlLong t;
+  PlLong h;
+}
+SchedEvent;
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+	  /* scratch arrays, grown on demand (propagators are never nested) */
+
+static int sch_size;		/* capacity of the arrays below (tasks) */
+static SchedTask *sch_task;
+static PlLong *sch_new;		/* bounds updated by a filtering rule */
+static int *sch_order;
+static int *sch_order1;
+static int *sch_pos;		/* leaf of each task in the tree */
+static SchedNode *sch_tree;	/* 2 * (power of 2 >= sch_size) nodes */
+static int sch_nb_leaf;
+static SchedEvent *sch_event;	/* these 2 ones: 2 * sch_size */
+static SchedEvent *sch_seg;	/* segments: [t, t of next) of height h */
+static PlLong *sch_om_est;	/* these 2 ones: edge-finding sets */
+static PlLong *sch_om_e;
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Sched_Alloc(int n);
+
+static Bool Sched_Propagate(WamWord **array, WamWord *dur, WamWord *res,
+			    int limit);
+
+static void Sched_Mirror(int n);
+
+static Bool Sched_Commit_Est(int n);
+
+static Bool Sched_Commit_Lct(int n);
+
+static void Sched_Sort(int *order, int n, int (*cmp) (const void *,
+						   const void *));
+
+static int Sched_Cmp_Est(const void *a, const void *b);
+
+static int Sched_Cmp_Lct(const void *a, const void *b);
+
+static int Sched_Cmp_Lst(const void *a, const void *b);
+
+static int Sched_Cmp_Event(const void *a, const void *b);
+
+static Bool Sched_Time_Table(int n, PlLong limit);
+
+static Bool Sched_Edge_Finding(int n, PlLong limit);
+
+static void Sched_Tree_Init(int n, Bool white);
+
+static void Sched_Tree_Combine(SchedNode *v, SchedNode *l, SchedNode *r);
+
+static void Sched_Tree_Set_Leaf(int i, int color);
+
+static Bool Sched_Edge_Finding_Unary(int n);
+
+static Bool Sched_Not_Last(int n);
+
+
+#define Sched_Lst(t)               ((t)->lct - (t)->p)
+#define Sched_Ect(t)               ((t)->est + (t)->p)
+
+#define SCHED_EMPTY                0	/* leaf colors */
+#define SCHED_WHITE                1	/* in Theta */
+#define SCHED_GRAY                 2	/* in Lambda */
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * Both constraints work on the tasks which use the resource (duration and *
+ * consumption > 0). Each filtering rule computes new earliest start times *
+ * (or new latest completion times) from the current bounds and is also    *
+ * applied on the mirrored tasks (t -> -t) to obtain the symmetric rule.   *
+ * The whole is repeated until no bound changes (idempotent constraint).   *
+ *-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_CUMULATIVE                                                        *
+ *                                                                         *
+ * Time-tabling and edge-finding.                                          *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Cumulative(WamWord **array, WamWord *dur, WamWord *res, int limit)
+{
+  return Sched_Propagate(array, dur, res, limit);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_DISJUNCTIVE                                                       *
+ *                                                                         *
+ * Time-tabling, edge-finding and not-first/not-last (Theta-Lambda trees). *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Disjunctive(WamWord **array, WamWord *dur)
+{
+  return Sched_Propagate(array, dur, NULL, 1);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_ALLOC                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Alloc(int n)
+{
+  int nb_leaf;
+
+  if (n <= sch_size)
+    return;
+
+  sch_size = n + n / 2;
+  for (nb_leaf = 1; nb_leaf < sch_size; nb_leaf <<= 1)
+    ;
+
+  sch_task = (SchedTask *) Realloc((char *) sch_task, sch_size * sizeof(SchedTask));
+  sch_new = (PlLong *) Realloc((char *) sch_new, sch_size * sizeof(PlLong));
+  sch_order = (int *) Realloc((char *) sch_order, sch_size * sizeof(int));
+  sch_order1 = (int *) Realloc((char *) sch_order1, sch_size * sizeof(int));
+  sch_pos = (int *) Realloc((char *) sch_pos, sch_size * sizeof(int));
+  sch_tree = (SchedNode *) Realloc((char *) sch_tree, 2 * nb_leaf * sizeof(SchedNode));
+  sch_event = (SchedEvent *) Realloc((char *) sch_event, 2 * sch_size * sizeof(SchedEvent));
+  sch_seg = (SchedEvent *) Realloc((char *) sch_seg, 2 * sch_size * sizeof(SchedEvent));
+  sch_om_est = (PlLong *) Realloc((char *) sch_om_est, sch_size * sizeof(PlLong));
+  sch_om_e = (PlLong *) Realloc((char *) sch_om_e, sch_size * sizeof(PlLong));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_PROPAGATE                                                         *
+ *                                                                         *
+ * res == NULL for a disjunctive resource (consumptions = limit = 1).      *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Propagate(WamWord **array, WamWord *dur, WamWord *res, int limit)
+{
+  int size = (int) (PlLong) array[0];
+  WamWord *fdv_adr;
+  SchedTask *t;
+  Bool changed;
+  int n, i, k;
+
+  Sched_Alloc(size);
+
+  do
+    {
+      n = 0;
+      for (i = 0; i < size; i++)
+	{
+	  if (dur[i + 1] <= 0 || (res && res[i + 1] <= 0))
+	    continue;
+
+	  if (res && res[i + 1] > limit)
+	    return FALSE;
+
+	  t = sch_task + n++;
+	  fdv_adr = array[i + 1];
+	  t->est = Min(fdv_adr);
+	  t->lct = Max(fdv_adr) + dur[i + 1];
+	  t->p = dur[i + 1];
+	  t->c = (res) ? res[i + 1] : 1;
+	  t->var = i;
+	}
+
+      if (n <= 1)
+	return TRUE;
+
+      for (k = 0; k < 2; k++)	/* k = 1: mirrored tasks */
+	{
+	  if (!Sched_Time_Table(n, limit))
+	    return FALSE;
+
+	  if (res)
+	    {
+	      if (!Sched_Edge_Finding(n, limit))
+		return FALSE;
+	    }
+	  else if (!Sched_Edge_Finding_Unary(n) || !Sched_Not_Last(n))
+	    return FALSE;
+
+	  Sched_Mirror(n);
+	}
+
+      changed = FALSE;
+      for (i = 0; i < n; i++)
+	{
+	  t = sch_task + i;
+	  fdv_adr = array[t->var + 1];
+	  if (t->est > Min(fdv_adr) || Sched_Lst(t) < Max(fdv_adr))
+	    {
+	      if (!Pl_Fd_Tell_Interval(fdv_adr, t->est, Sched_Lst(t)))
+		return FALSE;
+	      changed = TRUE;
+	    }
+	}
+    }
+  while (changed);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_MIRROR                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Mirror(int n)
+{
+  SchedTask *t;
+  PlLong x;
+  int i;
+
+  for (i = 0, t = sch_task; i < n; i++, t++)
+    {
+      x = t->est;
+      t->est = -t->lct;
+      t->lct = -x;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_COMMIT_EST                                                        *
+ *                                                                         *
+ * Installs the new earliest start times (sch_new). Fails if a task does   *
+ * no longer fit in its window.                                            *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Commit_Est(int n)
+{
+  SchedTask *t;
+  int i;
+
+  for (i = 0, t = sch_task; i < n; i++, t++)
+    {
+      t->est = sch_new[i];
+      if (Sched_Ect(t) > t->lct)
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_COMMIT_LCT                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Commit_Lct(int n)
+{
+  SchedTask *t;
+  int i;
+
+  for (i = 0, t = sch_task; i < n; i++, t++)
+    {
+      t->lct = sch_new[i];
+      if (Sched_Ect(t) > t->lct)
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_SORT                                                              *
+ *                                                                         *
+ * Sorts the task indexes 0..n-1 in order w.r.t. cmp.                      *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Sort(int *order, int n, int (*cmp) (const void *, const void *))
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    order[i] = i;
+
+  qsort(order, n, sizeof(int), cmp);
+}
+
+
+#define Sched_Cmp(x, y)            (((x) > (y)) - ((x) < (y)))
+
+static int
+Sched_Cmp_Est(const void *a, const void *b)
+{
+  return Sched_Cmp(sch_task[*(int *) a].est, sch_task[*(int *) b].est);
+}
+
+
+static int
+Sched_Cmp_Lct(const void *a, const void *b)
+{
+  return Sched_Cmp(sch_task[*(int *) a].lct, sch_task[*(int *) b].lct);
+}
+
+
+static int
+Sched_Cmp_Lst(const void *a, const void *b)
+{
+  return Sched_Cmp(Sched_Lst(sch_task + *(int *) a),
+		   Sched_Lst(sch_task + *(int *) b));
+}
+
+
+static int
+Sched_Cmp_Event(const void *a, const void *b)
+{
+  return Sched_Cmp(((SchedEvent *) a)->t, ((SchedEvent *) b)->t);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_TIME_TABLE                                                        *
+ *                                                                         *
+ * Builds the profile of the compulsory parts [lst, ect) and delays each   *
+ * task after the segments where it would exceed the limit. O(n^2).        *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Time_Table(int n, PlLong limit)
+{
+  SchedTask *t;
+  SchedEvent *e = sch_event, *seg = sch_seg;
+  PlLong h, s;
+  int nb_ev = 0, nb_seg = 0;
+  int i, k;
+
+  for (i = 0, t = sch_task; i < n; i++, t++)
+    if (Sched_Lst(t) < Sched_Ect(t))
+      {
+	e[nb_ev].t = Sched_Lst(t);
+	e[nb_ev++].h = t->c;
+	e[nb_ev].t = Sched_Ect(t);
+	e[nb_ev++].h = -t->c;
+      }
+
+  if (nb_ev == 0)
+    return TRUE;
+
+  qsort(e, nb_ev, sizeof(SchedEvent), Sched_Cmp_Event);
+
+  h = 0;
+  for (k = 0; k < nb_ev;)
+    {
+      s = e[k].t;
+      do
+	h += e[k++].h;
+      while (k < nb_ev && e[k].t == s);
+
+      if (h > limit)
+	return FALSE;
+
+      seg[nb_seg].t = s;	/* the segment ends at the next one */
+      seg[nb_seg++].h = h;
+    }
+
+  for (i = 0, t = sch_task; i < n; i++, t++)
+    {
+      s = t->est;
+      for (k = 0; k < nb_seg - 1 && seg[k].t < s + t->p; k++)
+	{
+	  if (seg[k + 1].t <= s)
+	    continue;
+
+	  h = seg[k].h;
+	  if (seg[k].t >= Sched_Lst(t) && seg[k + 1].t <= Sched_Ect(t))
+	    h -= t->c;		/* its own compulsory part */
+
+	  if (h + t->c > limit)
+	    s = seg[k + 1].t;
+	}
+
+      sch_new[i] = s;
+    }
+
+  return Sched_Commit_Est(n);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_EDGE_FINDING                                                      *
+ *                                                                         *
+ * Cumulative edge-finding. For a set Omega of tasks and a task i not in   *
+ * Omega (lct(i) > lct(Omega)), if the energy of Omega U {i} exceeds       *
+ * limit * (lct(Omega) - est(Omega U {i})), i ends after Omega and starts  *
+ * after est(W) + ceil(rest(W, c(i)) / c(i)) for each W included in Omega  *
+ * with rest(W, c) = e(W) - (limit - c) * (lct(W) - est(W)) > 0. Only the  *
+ * task intervals Omega(a, b) = {j : est(j) >= est(a), lct(j) <= lct(b)}   *
+ * are considered. Also detects overloaded task intervals. O(n^3).         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Edge_Finding(int n, PlLong limit)
+{
+  SchedTask *t, *ti;
+  PlLong *om_est = sch_om_est, *om_e = sch_om_e;
+  PlLong lct_b, e, rest, upd, best, est;
+  int *by_est = sch_order, *by_lct = sch_order1;
+  int b, i, k, m;
+
+  Sched_Sort(by_est, n, Sched_Cmp_Est);
+  Sched_Sort(by_lct, n, Sched_Cmp_Lct);
+
+  for (i = 0; i < n; i++)
+    sch_new[i] = sch_task[i].est;
+
+  for (b = 0; b < n; b++)
+    {
+      lct_b = sch_task[by_lct[b]].lct;
+      if (b < n - 1 && sch_task[by_lct[b + 1]].lct == lct_b)
+	continue;		/* the same Omegas with the next one */
+
+				/* Omega(a, b) by decreasing est(a) */
+      m = 0;
+      e = 0;
+      for (k = n - 1; k >= 0; k--)
+	{
+	  t = sch_task + by_est[k];
+	  if (t->lct > lct_b)
+	    continue;
+
+	  e += t->p * t->c;
+	  if (e > limit * (lct_b - t->est))
+	    return FALSE;
+
+	  om_est[m] = t->est;
+	  om_e[m++] = e;
+	}
+
+      for (k = b + 1; k < n; k++)
+	{
+	  ti = sch_task + by_lct[k];
+	  e = ti->p * ti->c;
+	  upd = best = -SCHED_INF;
+	  for (i = 0; i < m; i++)
+	    {
+	      rest = om_e[i] - (limit - ti->c) * (lct_b - om_est[i]);
+	      if (rest > 0 && om_est[i] + (rest + ti->c - 1) / ti->c > upd)
+		upd = om_est[i] + (rest + ti->c - 1) / ti->c;
+
+	      est = (ti->est < om_est[i]) ? ti->est : om_est[i];
+	      if (om_e[i] + e > limit * (lct_b - est))
+		best = upd;
+	    }
+
+	  if (best > sch_new[by_lct[k]])
+	    sch_new[by_lct[k]] = best;
+	}
+    }
+
+  return Sched_Commit_Est(n);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_TREE_INIT                                                         *
+ *                                                                         *
+ * Builds a Theta-Lambda tree whose leaves are the tasks sorted by est,    *
+ * all in Theta (white) or all empty.                                      *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Tree_Init(int n, Bool white)
+{
+  int i, k;
+
+  for (sch_nb_leaf = 1; sch_nb_leaf < n; sch_nb_leaf <<= 1)
+    ;
+
+  Sched_Sort(sch_order, n, Sched_Cmp_Est);
+  for (i = 0; i < n; i++)
+    sch_pos[sch_order[i]] = sch_nb_leaf + i;
+
+  for (k = sch_nb_leaf; k < 2 * sch_nb_leaf; k++)
+    {
+      sch_tree[k].sp = sch_tree[k].spb = 0;
+      sch_tree[k].ect = sch_tree[k].ectb = -SCHED_INF;
+      sch_tree[k].resp_spb = sch_tree[k].resp_ectb = -1;
+    }
+
+  if (white)
+    for (i = 0; i < n; i++)
+      {
+	k = sch_pos[i];
+	sch_tree[k].sp = sch_tree[k].spb = sch_task[i].p;
+	sch_tree[k].ect = sch_tree[k].ectb = Sched_Ect(sch_task + i);
+      }
+
+  for (k = sch_nb_leaf - 1; k >= 1; k--)
+    Sched_Tree_Combine(sch_tree + k, sch_tree + 2 * k, sch_tree + 2 * k + 1);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_TREE_COMBINE                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Tree_Combine(SchedNode *v, SchedNode *l, SchedNode *r)
+{
+  PlLong x;
+
+  v->sp = l->sp + r->sp;
+  v->ect = (r->ect > l->ect + r->sp) ? r->ect : l->ect + r->sp;
+
+  if (l->spb + r->sp >= l->sp + r->spb)
+    {
+      v->spb = l->spb + r->sp;
+      v->resp_spb = l->resp_spb;
+    }
+  else
+    {
+      v->spb = l->sp + r->spb;
+      v->resp_spb = r->resp_spb;
+    }
+
+  v->ectb = r->ectb;		/* on a tie prefer a Lambda task */
+  v->resp_ectb = r->resp_ectb;
+  x = l->ect + r->spb;
+  if (x > v->ectb || (x == v->ectb && v->resp_ectb < 0))
+    {
+      v->ectb = x;
+      v->resp_ectb = r->resp_spb;
+    }
+  x = l->ectb + r->sp;
+  if (x > v->ectb || (x == v->ectb && v->resp_ectb < 0))
+    {
+      v->ectb = x;
+      v->resp_ectb = l->resp_ectb;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_TREE_SET_LEAF                                                     *
+ *                                                                         *
+ * Sets the color of the leaf of task i and updates its ancestors.         *
+ *-------------------------------------------------------------------------*/
+static void
+Sched_Tree_Set_Leaf(int i, int color)
+{
+  SchedNode *leaf;
+  int k = sch_pos[i];
+
+  leaf = sch_tree + k;
+  leaf->sp = (color == SCHED_WHITE) ? sch_task[i].p : 0;
+  leaf->ect = (color == SCHED_WHITE) ? Sched_Ect(sch_task + i) : -SCHED_INF;
+  leaf->spb = (color == SCHED_EMPTY) ? 0 : sch_task[i].p;
+  leaf->ectb = (color == SCHED_EMPTY) ? -SCHED_INF : Sched_Ect(sch_task + i);
+  leaf->resp_spb = leaf->resp_ectb = (color == SCHED_GRAY) ? i : -1;
+
+  for (k >>= 1; k >= 1; k >>= 1)
+    Sched_Tree_Combine(sch_tree + k, sch_tree + 2 * k, sch_tree + 2 * k + 1);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_EDGE_FINDING_UNARY                                                *
+ *                                                                         *
+ * Edge-finding for a disjunctive resource with a Theta-Lambda tree (Vilim *
+ * 2004). Also detects overloads. O(n log n).                              *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Edge_Finding_Unary(int n)
+{
+  SchedNode *root = sch_tree + 1;
+  int *by_lct = sch_order1;
+  int i, j, k;
+
+  Sched_Tree_Init(n, TRUE);
+  Sched_Sort(by_lct, n, Sched_Cmp_Lct);
+
+  for (i = 0; i < n; i++)
+    sch_new[i] = sch_task[i].est;
+
+  for (k = n - 1; k > 0; k--)	/* by decreasing lct */
+    {
+      j = by_lct[k];
+      if (root->ect > sch_task[j].lct)
+	return FALSE;
+
+      Sched_Tree_Set_Leaf(j, SCHED_GRAY);
+      j = by_lct[k - 1];
+      while (root->ectb > sch_task[j].lct && root->resp_ectb >= 0)
+	{
+	  i = root->resp_ectb;
+	  if (root->ect > sch_new[i])
+	    sch_new[i] = root->ect;
+	  Sched_Tree_Set_Leaf(i, SCHED_EMPTY);
+	}
+    }
+
+  return Sched_Commit_Est(n);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCHED_NOT_LAST                                                          *
+ *                                                                         *
+ * Not-last rule (Vilim 2004): if the tasks j != i with lst(j) < lct(i)    *
+ * cannot all end before lst(i), i ends before the largest of their lst.   *
+ * O(n log n).                                                             *
+ *-------------------------------------------------------------------------*/
+static Bool
+Sched_Not_Last(int n)
+{
+  SchedTask *ti;
+  int *by_lct = sch_order1, *by_lst = sch_order;
+  int i, j, k, q = 0;
+  PlLong ect;
+
+  Sched_Tree_Init(n, FALSE);	/* uses sch_order (by est) for sch_pos */
+  Sched_Sort(by_lct, n, Sched_Cmp_Lct);
+  Sched_Sort(by_lst, n, Sched_Cmp_Lst);
+
+  for (i = 0; i < n; i++)
+    sch_new[i] = sch_task[i].lct;
+
+  for (k = 0; k < n; k++)
+    {
+      i = by_lct[k];
+      ti = sch_task + i;
+      while (q < n && ti->lct > Sched_Lst(sch_task + by_lst[q]))
+	Sched_Tree_Set_Leaf(by_lst[q++], SCHED_WHITE);
+
+      j = by_lst[q - 1];	/* q > 0 since lst(i) < lct(i) */
+      if (j == i)
+	{
+	  if (q == 1)
+	    continue;
+	  j = by_lst[q - 2];
+	}
+
+      Sched_Tree_Set_Leaf(i, SCHED_EMPTY);
+      ect = sch_tree[1].ect;
+      Sched_Tree_Set_Leaf(i, SCHED_WHITE);
+
+      if (ect > Sched_Lst(ti) && Sched_Lst(sch_task + j) < sch_new[i])
+	sch_new[i] = Sched_Lst(sch_task + j);
+    }
+
+  return Sched_Commit_Lct(n);
+}
@@ -47,6 +47,71 @@ fd_all_different(L) :-
 
 
 
+
+fd_all_different(L, Options) :-
+	set_bip_name(fd_all_different, 2),
+	'$fd_all_diff_options'(Options, Consistency),
+	'$fd_all_different'(Consistency, L).
+
+
+'$fd_all_different'(value, L) :-
+	'$call_c_test'('Pl_Fd_All_Different_1'(L, L)).
+
+'$fd_all_different'(bounds, L) :-
+	'$check_list'(L),
+	'$fd_all_diff_state'(L, S),
+	fd_tell(pl_fd_all_different_bounds(L, S)).
+
+'$fd_all_different'(domain, L) :-
+	'$check_list'(L),
+	'$fd_all_diff_state'(L, S),
+	fd_tell(pl_fd_all_different_domain(L, S)).
+
+
+
+
+	% the state of the global propagators (see fd_symbolic_c.c) is an
+	% array of 2*N+2 integers initialized to 0.
+
+'$fd_all_diff_state'([], [0, 0]).
+
+'$fd_all_diff_state'([_|L], [0, 0|S]) :-
+	'$fd_all_diff_state'(L, S).
+
+
+
+
+'$fd_all_diff_options'(Options, Consistency) :-
+	'$check_list'(Options),
+	g_assign('$fd_all_diff_cons', value),
+	'$fd_all_diff_options1'(Options),
+	g_read('$fd_all_diff_cons', Consistency).
+
+
+'$fd_all_diff_options1'([]).
+
+'$fd_all_diff_options1'([X|Options]) :-
+	'$fd_all_diff_options2'(X), !,
+	'$fd_all_diff_options1'(Options).
+
+
+'$fd_all_diff_options2'(X) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$fd_all_diff_options2'(consistency(X)) :-
+	'$check_nonvar'(X),
+	(   X = value
+	;   X = bounds
+	;   X = domain
+	),
+	g_assign('$fd_all_diff_cons', X).
+
+'$fd_all_diff_options2'(X) :-
+	'$pl_err_domain'(fd_all_different_option, X).
+
+
+
 fd_element(I, List, V) :-
 	set_bip_name(fd_element, 3),
 	'$fd_element'(I, List, V).
@@ -90,8 +155,14 @@ fd_relation(Tuples, Vars) :-
 	set_bip_name(fd_relation, 2),
 	'$check_list'(Tuples),
 	'$check_list_or_partial_list'(Vars),
-	'$lines_to_columns'(Tuples, CTuples),
-	'$fd_relationc1'(CTuples, Vars, _).
+	Tuples = [T|_],		% an empty relation has no solution
+	'$check_list'(T),
+	length(T, N),
+	length(Vars, N),
+	'$fd_relation_check'(Tuples, N),
+	length(Tuples, M),
+	'$call_c'('Pl_Fd_Relation_Check_Size_2'(N, M)),
+	fd_tell(pl_fd_relation(Vars, Tuples, 0, [0])).
 
 
 
@@ -99,31 +170,39 @@ fd_relationc(CTuples, Vars) :-
 	set_bip_name(fd_relationc, 2),
 	'$check_list'(CTuples),
 	'$check_list_or_partial_list'(Vars),
-	'$fd_relationc1'(CTuples, Vars, _).
-
-
-
-
-'$fd_relationc1'([], [], _).
+	length(CTuples, N),
+	length(Vars, N),
+	(   CTuples = [C|_] ->
+	    '$check_list'(C),
+	    length(C, M),
+	    '$call_c'('Pl_Fd_Relation_Check_Size_2'(N, M))
+	;   true
+	),
+	'$fd_relation_check'(CTuples, M),
+	fd_tell(pl_fd_relation(Vars, CTuples, 1, [0])).
 
-'$fd_relationc1'([C|CTuples], [X|Vars], R) :-
-	'$fd_element'(R, C, X),
-	'$fd_relationc1'(CTuples, Vars, R).
 
 
 
+	% each line (resp. column) is a list of N integers
 
-'$lines_to_columns'([[]|_], []) :-
-	!.
+'$fd_relation_check'([], _).
 
-'$lines_to_columns'(Tuples, [Column|Columns]) :-
-	'$create_column'(Tuples, Column, Tuples1),
-	'$lines_to_columns'(Tuples1, Columns).
+'$fd_relation_check'([L|Lines], N) :-
+	'$check_list'(L),
+	length(L, N),
+	'$fd_relation_check_int'(L),
+	'$fd_relation_check'(Lines, N).
 
 
 
 
-'$create_column'([], [], []).
+'$fd_relation_check_int'([]).
 
-'$create_column'([[X|L]|Tuples], [X|Column], [L|Tuples1]) :-
-	'$create_column'(Tuples, Column, Tuples1).
+'$fd_relation_check_int'([X|L]) :-
+	(   integer(X) ->
+	    true
+	;   '$check_nonvar'(X),
+	    '$pl_err_type'(integer, X)
+	),
+	'$fd_relation_check_int'(L).
@@ -36,6 +36,8 @@
  *-------------------------------------------------------------------------*/
 
 
+#include <string.h>
+
 #include "engine_pl.h"
 #include "bips_pl.h"
 
@@ -49,14 +51,85 @@
  * Constants                       *
  *---------------------------------*/
 
+#define AD_MAX_SPAN                65536	/* beyond: bounds consistency */
+
+#define CT_MAX_TELL_NOT            8	/* beyond: tell the range of supports */
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* a variable for bounds consistency */
+{
+  int min, max;
+  int minrank, maxrank;		/* ranks of min and max+1 in ad_bounds */
+}
+AdInterval;
+
+typedef struct			/* a variable of a compact table */
+{
+  int nb_val;			/* nb of distinct values in its column */
+  int *val;			/* these values (sorted) */
+  int *residue;			/* per value: last support entry found valid */
+  int *sup_start;		/* per value: its 1st support entry (nb_val+1) */
+  int *sup_no;			/* support entries: word nb (increasing) */
+  VecWord *sup_word;		/* support entries: non-zero word */
+  WamWord last_size;		/* domain size at last update (trailed) */
+}
+CtVar;
+
+typedef struct			/* a compact table (allocated on CS) */
+{
+  int nb_word;			/* nb of words of the bitsets */
+  int max_nb_val;		/* max nb_val of the variables */
+  WamWord limit;		/* nb of non-zero words (trailed) */
+  int *index;			/* index[0..limit-1]: the non-zero words */
+  VecWord *word;		/* bitset of the valid tuples (trailed) */
+  CtVar var[1];			/* one per variable (arity) */
+}
+CtTable;
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
 
+	  /* scratch arrays of the global all_different propagators, grown  *
+	   * on demand (propagators are never nested)                        */
+
+static int ad_size_var;		/* capacity of the arrays below (vars) */
+static AdInterval *ad_iv;
+static int *ad_min_sorted;
+static int *ad_max_sorted;
+static int *ad_bounds;		/* these 4 ones: 2 * ad_size_var + 2 */
+static int *ad_t;
+static int *ad_d;
+static int *ad_h;
+
+static int ad_size_node;	/* capacity of the arrays below (nodes) */
+static int *ad_val_mate;
+static int *ad_rm;
+static int *ad_num;
+static int *ad_low;
+static int *ad_comp;
+static int *ad_it;
+static int *ad_cstack;
+static int *ad_tstack;
+static char *ad_reach;
+static char *ad_comp_reach;
+static unsigned *ad_val_stamp;	/* == ad_stamp: val_mate is valid */
+static unsigned *ad_node_stamp;	/* == ad_stamp: node visited */
+static unsigned *ad_val_seen;	/* == ad_seen: value seen by Augment */
+static unsigned ad_stamp;
+static unsigned ad_seen;
+
+	  /* scratch arrays of the compact table propagator */
+
+static int ct_size_word;	/* capacity of ct_mask */
+static VecWord *ct_mask;
+static int ct_size_val;		/* capacity of ct_idx and ct_rm */
+static int *ct_idx;
+static int *ct_rm;
+
 /*---------------------------------*
  * Function Prototypes             *
  *---------------------------------*/
@@ -64,6 +137,47 @@
 static Bool Fd_All_Different_Rec(WamWord list_word, PlLong x_tag, WamWord x_word,
 				 WamWord save_list_word);
 
+static void All_Diff_Alloc_Vars(int n);
+
+static void All_Diff_Alloc_Nodes(int nb);
+
+static void All_Diff_Sort(int *order, int n, Bool by_max);
+
+static int All_Diff_Sort_Ranks(int n);
+
+static void All_Diff_Path_Set(int *t, int start, int end, int to);
+
+static int All_Diff_Path_Min(int *t, int i);
+
+static int All_Diff_Path_Max(int *t, int i);
+
+static Bool All_Diff_Filter_Lower(int n, int nb);
+
+static Bool All_Diff_Filter_Upper(int n, int nb);
+
+static Bool All_Diff_Bounds(WamWord **fdv, int n, WamWord *order,
+			    Bool *changed);
+
+static Bool All_Diff_Augment(WamWord **fdv, WamWord *var_mate, int x0, int lo);
+
+static void All_Diff_Scc(WamWord **fdv, WamWord *var_mate, int n, int lo);
+
+static void *Ct_Alloc(int nb_bytes);
+
+static int Ct_Cmp_Int(const void *a, const void *b);
+
+static CtTable *Ct_Build(int arity, WamWord *tuples, Bool columns);
+
+static void Ct_Alloc_Scratch(CtTable *tab);
+
+static int Ct_Find_Value(CtVar *cv, int v);
+
+static int Ct_Dom_Index(CtVar *cv, WamWord *fdv_adr);
+
+static Bool Ct_Update(CtTable *tab, CtVar *cv, WamWord *fdv_adr);
+
+static Bool Ct_Filter(CtTable *tab, CtVar *cv, WamWord *fdv_adr);
+
 
 
 
@@ -146,6 +260,647 @@ Fd_All_Different_Rec(WamWord list_word, PlLong x_tag, WamWord x_word,
 
 
 
+/*-------------------------------------------------------------------------*
+ * The global all_different propagators below receive the variables (an    *
+ * l_fdv array) and a state array (an l_int array of 2*N+2 cells set to 0  *
+ * by fd_all_different/2). The state is not trailed: it only records a     *
+ * sort order (bounds consistency) or a matching (domain consistency)      *
+ * which are revised at each call, so they remain usable after the         *
+ * domains have been enlarged by backtracking.                             *
+ *                                                                         *
+ * Cells of the state array:                                               *
+ *   [1]      : 0 while the orders are not yet initialized                 *
+ *   [3..]    : bounds: the variables sorted by min then sorted by max     *
+ *              domain: the value (+1) matched to each variable (0 if none)*
+ *-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_ALLOC_VARS                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Alloc_Vars(int n)
+{
+  if (n <= ad_size_var)
+    return;
+
+  ad_size_var = n + n / 2;
+  ad_iv = (AdInterval *) Realloc((char *) ad_iv, ad_size_var * sizeof(AdInterval));
+  ad_min_sorted = (int *) Realloc((char *) ad_min_sorted, ad_size_var * sizeof(int));
+  ad_max_sorted = (int *) Realloc((char *) ad_max_sorted, ad_size_var * sizeof(int));
+  ad_bounds = (int *) Realloc((char *) ad_bounds, (2 * ad_size_var + 2) * sizeof(int));
+  ad_t = (int *) Realloc((char *) ad_t, (2 * ad_size_var + 2) * sizeof(int));
+  ad_d = (int *) Realloc((char *) ad_d, (2 * ad_size_var + 2) * sizeof(int));
+  ad_h = (int *) Realloc((char *) ad_h, (2 * ad_size_var + 2) * sizeof(int));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_ALLOC_NODES                                                    *
+ *                                                                         *
+ * Stamp arrays are reset when they grow (stamps only increase).           *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Alloc_Nodes(int nb)
+{
+  if (nb <= ad_size_node)
+    return;
+
+  ad_size_node = nb + nb / 2;
+  ad_val_mate = (int *) Realloc((char *) ad_val_mate, ad_size_node * sizeof(int));
+  ad_rm = (int *) Realloc((char *) ad_rm, ad_size_node * sizeof(int));
+  ad_num = (int *) Realloc((char *) ad_num, ad_size_node * sizeof(int));
+  ad_low = (int *) Realloc((char *) ad_low, ad_size_node * sizeof(int));
+  ad_comp = (int *) Realloc((char *) ad_comp, ad_size_node * sizeof(int));
+  ad_it = (int *) Realloc((char *) ad_it, ad_size_node * sizeof(int));
+  ad_cstack = (int *) Realloc((char *) ad_cstack, ad_size_node * sizeof(int));
+  ad_tstack = (int *) Realloc((char *) ad_tstack, ad_size_node * sizeof(int));
+  ad_reach = Realloc(ad_reach, ad_size_node);
+  ad_comp_reach = Realloc(ad_comp_reach, ad_size_node);
+
+  ad_val_stamp = (unsigned *) Realloc((char *) ad_val_stamp, ad_size_node * sizeof(unsigned));
+  ad_val_seen = (unsigned *) Realloc((char *) ad_val_seen, ad_size_node * sizeof(unsigned));
+  ad_node_stamp = (unsigned *) Realloc((char *) ad_node_stamp, ad_size_node * sizeof(unsigned));
+  memset(ad_val_stamp, 0, ad_size_node * sizeof(unsigned));
+  memset(ad_val_seen, 0, ad_size_node * sizeof(unsigned));
+  memset(ad_node_stamp, 0, ad_size_node * sizeof(unsigned));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_SORT                                                           *
+ *                                                                         *
+ * Insertion sort of an order of the variables by min or by max. It is     *
+ * linear when the order is (almost) unchanged since the previous call.    *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Sort(int *order, int n, Bool by_max)
+{
+  int i, j, k, key;
+
+  for (i = 1; i < n; i++)
+    {
+      k = order[i];
+      key = (by_max) ? ad_iv[k].max : ad_iv[k].min;
+      for (j = i; j > 0 && ((by_max) ? ad_iv[order[j - 1]].max :
+			    ad_iv[order[j - 1]].min) > key; j--)
+	order[j] = order[j - 1];
+      order[j] = k;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_SORT_RANKS                                                     *
+ *                                                                         *
+ * Merges the sorted mins and max+1 into ad_bounds (with a sentinel at     *
+ * each end) and records the rank of each bound. Returns the number of     *
+ * distinct bounds.                                                        *
+ *-------------------------------------------------------------------------*/
+static int
+All_Diff_Sort_Ranks(int n)
+{
+  int min, max, last;
+  int nb = 0, i = 0, j = 0;
+
+  min = ad_iv[ad_min_sorted[0]].min;
+  max = ad_iv[ad_max_sorted[0]].max + 1;
+  ad_bounds[0] = last = min - 2;
+
+  for (;;)
+    {
+      if (i < n && min <= max)
+	{
+	  if (min != last)
+	    ad_bounds[++nb] = last = min;
+	  ad_iv[ad_min_sorted[i]].minrank = nb;
+	  if (++i < n)
+	    min = ad_iv[ad_min_sorted[i]].min;
+	}
+      else
+	{
+	  if (max != last)
+	    ad_bounds[++nb] = last = max;
+	  ad_iv[ad_max_sorted[j]].maxrank = nb;
+	  if (++j == n)
+	    break;
+	  max = ad_iv[ad_max_sorted[j]].max + 1;
+	}
+    }
+
+  ad_bounds[nb + 1] = ad_bounds[nb] + 2;
+
+  return nb;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * Path compression helpers on the forests of ALL_DIFF_FILTER_LOWER/UPPER. *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Path_Set(int *t, int start, int end, int to)
+{
+  int k, l;
+
+  for (l = start; (k = l) != end; t[k] = to)
+    l = t[k];
+}
+
+
+static int
+All_Diff_Path_Min(int *t, int i)
+{
+  while (t[i] < i)
+    i = t[i];
+
+  return i;
+}
+
+
+static int
+All_Diff_Path_Max(int *t, int i)
+{
+  while (t[i] > i)
+    i = t[i];
+
+  return i;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_FILTER_LOWER                                                   *
+ *                                                                         *
+ * Updates the mins w.r.t. the Hall intervals, visiting the variables by   *
+ * increasing max (Lopez-Ortiz, Quimper, Tromp, van Beek, IJCAI 2003).     *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Filter_Lower(int n, int nb)
+{
+  int *t = ad_t, *d = ad_d, *h = ad_h, *bounds = ad_bounds;
+  AdInterval *iv;
+  int i, j, w, x, y, z;
+
+  for (i = 1; i <= nb + 1; i++)
+    {
+      t[i] = h[i] = i - 1;
+      d[i] = bounds[i] - bounds[i - 1];
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      iv = ad_iv + ad_max_sorted[i];
+      x = iv->minrank;
+      y = iv->maxrank;
+      z = All_Diff_Path_Max(t, x + 1);
+      j = t[z];
+      if (--d[z] == 0)
+	{
+	  t[z] = z + 1;
+	  z = All_Diff_Path_Max(t, t[z]);
+	  t[z] = j;
+	}
+      All_Diff_Path_Set(t, x + 1, z, z);
+      if (d[z] < bounds[z] - bounds[y])
+	return FALSE;
+
+      if (h[x] > x)
+	{
+	  w = All_Diff_Path_Max(h, h[x]);
+	  iv->min = bounds[w];
+	  All_Diff_Path_Set(h, x, w, w);
+	}
+
+      if (d[z] == bounds[z] - bounds[y])
+	{
+	  All_Diff_Path_Set(h, h[y], j - 1, y);
+	  h[y] = j - 1;
+	}
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_FILTER_UPPER                                                   *
+ *                                                                         *
+ * Symmetric of ALL_DIFF_FILTER_LOWER for the maxs (by decreasing min).    *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Filter_Upper(int n, int nb)
+{
+  int *t = ad_t, *d = ad_d, *h = ad_h, *bounds = ad_bounds;
+  AdInterval *iv;
+  int i, j, w, x, y, z;
+
+  for (i = 0; i <= nb; i++)
+    {
+      t[i] = h[i] = i + 1;
+      d[i] = bounds[i + 1] - bounds[i];
+    }
+
+  for (i = n - 1; i >= 0; i--)
+    {
+      iv = ad_iv + ad_min_sorted[i];
+      x = iv->maxrank;
+      y = iv->minrank;
+      z = All_Diff_Path_Min(t, x - 1);
+      j = t[z];
+      if (--d[z] == 0)
+	{
+	  t[z] = z - 1;
+	  z = All_Diff_Path_Min(t, t[z]);
+	  t[z] = j;
+	}
+      All_Diff_Path_Set(t, x - 1, z, z);
+      if (d[z] < bounds[y] - bounds[z])
+	return FALSE;
+
+      if (h[x] < x)
+	{
+	  w = All_Diff_Path_Min(h, h[x]);
+	  iv->max = bounds[w] - 1;
+	  All_Diff_Path_Set(h, x, w, w);
+	}
+
+      if (d[z] == bounds[y] - bounds[z])
+	{
+	  All_Diff_Path_Set(h, h[y], j + 1, y);
+	  h[y] = j + 1;
+	}
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_BOUNDS                                                         *
+ *                                                                         *
+ * One bounds consistency pass. order is the persistent part of the state  *
+ * (or NULL to sort from scratch). Sets *changed if a bound was updated.   *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Bounds(WamWord **fdv, int n, WamWord *order, Bool *changed)
+{
+  int i, nb;
+
+  All_Diff_Alloc_Vars(n);
+
+  for (i = 0; i < n; i++)
+    {
+      ad_iv[i].min = Min(fdv[i]);
+      ad_iv[i].max = Max(fdv[i]);
+      ad_min_sorted[i] = (order) ? (int) order[i] : i;
+      ad_max_sorted[i] = (order) ? (int) order[n + i] : i;
+    }
+
+  All_Diff_Sort(ad_min_sorted, n, FALSE);
+  All_Diff_Sort(ad_max_sorted, n, TRUE);
+
+  if (order)
+    for (i = 0; i < n; i++)
+      {
+	order[i] = ad_min_sorted[i];
+	order[n + i] = ad_max_sorted[i];
+      }
+
+  nb = All_Diff_Sort_Ranks(n);
+  if (!All_Diff_Filter_Lower(n, nb) || !All_Diff_Filter_Upper(n, nb))
+    return FALSE;
+
+  *changed = FALSE;
+  for (i = 0; i < n; i++)
+    if (ad_iv[i].min != Min(fdv[i]) || ad_iv[i].max != Max(fdv[i]))
+      {
+	if (!Pl_Fd_Tell_Interval(fdv[i], ad_iv[i].min, ad_iv[i].max))
+	  return FALSE;
+	*changed = TRUE;
+      }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_ALL_DIFFERENT_BOUNDS                                              *
+ *                                                                         *
+ * Bounds consistency: O(n log n) per pass (linear once the orders are     *
+ * sorted), repeated until the bounds no longer change (idempotent).       *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_All_Different_Bounds(WamWord **array, WamWord *state)
+{
+  int n = (int) (PlLong) array[0];
+  WamWord *order = state + 3;
+  Bool changed;
+  int i;
+
+  if (n <= 1)
+    return TRUE;
+
+  if (state[1] == 0)
+    {
+      for (i = 0; i < n; i++)
+	order[i] = order[n + i] = i;
+      state[1] = 1;
+    }
+
+  do
+    if (!All_Diff_Bounds(array + 1, n, order, &changed))
+      return FALSE;
+  while (changed);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_AUGMENT                                                        *
+ *                                                                         *
+ * Searches (iterative DFS) an alternating path from the unmatched         *
+ * variable x0 to a free value and flips it. Values are offsets from lo.   *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Augment(WamWord **fdv, WamWord *var_mate, int x0, int lo)
+{
+  int *stack = ad_cstack, *it = ad_it;
+  int sp = 0, x, y, v, a, k;
+
+  if (++ad_seen == 0)
+    {
+      memset(ad_val_seen, 0, ad_size_node * sizeof(unsigned));
+      ad_seen = 1;
+    }
+
+  stack[sp++] = x0;
+  it[x0] = -1;
+
+  while (sp > 0)
+    {
+      x = stack[sp - 1];
+      v = Pl_Range_Next_After(Range(fdv[x]), it[x]);
+      if (v < 0)		/* no more value: backtrack */
+	{
+	  sp--;
+	  continue;
+	}
+      it[x] = v;
+      a = v - lo;
+      if (ad_val_seen[a] == ad_seen)
+	continue;
+      ad_val_seen[a] = ad_seen;
+
+      if (ad_val_stamp[a] != ad_stamp)	/* free value: flip the path */
+	{
+	  for (k = sp - 1; k >= 0; k--)
+	    {
+	      y = stack[k];
+	      a = it[y] - lo;
+	      var_mate[y] = it[y] + 1;
+	      ad_val_mate[a] = y;
+	      ad_val_stamp[a] = ad_stamp;
+	    }
+	  return TRUE;
+	}
+
+      y = ad_val_mate[a];
+      stack[sp++] = y;
+      it[y] = -1;
+    }
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_SCC                                                            *
+ *                                                                         *
+ * Iterative Tarjan on the graph: variable x (node x) -> its values except *
+ * its matched value, value v (node n+v-lo) -> the variable matched to v.  *
+ * Also computes for each component if a free value can be reached from it.*
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Scc(WamWord **fdv, WamWord *var_mate, int n, int lo)
+{
+  int *num = ad_num, *low = ad_low, *comp = ad_comp, *it = ad_it;
+  int *cstack = ad_cstack, *tstack = ad_tstack;
+  char *reach = ad_reach, *comp_reach = ad_comp_reach;
+  int csp = 0, tsp = 0, counter = 0, nb_comp = 0;
+  int x0, u, w, v, p, k;
+  char r;
+
+#define Visit(node)							\
+  do									\
+    {									\
+      ad_node_stamp[node] = ad_stamp;					\
+      num[node] = low[node] = counter++;				\
+      comp[node] = -1;							\
+      reach[node] = (node >= n && ad_val_stamp[node - n] != ad_stamp);	\
+      it[node] = -1;							\
+      cstack[csp++] = tstack[tsp++] = node;				\
+    }									\
+  while (0)
+
+  for (x0 = 0; x0 < n; x0++)
+    {
+      if (ad_node_stamp[x0] == ad_stamp)
+	continue;
+
+      Visit(x0);
+      while (csp > 0)
+	{
+	  u = cstack[csp - 1];
+	  w = -1;
+	  if (u < n)		/* variable: next value except its mate */
+	    {
+	      while ((v = Pl_Range_Next_After(Range(fdv[u]), it[u])) >= 0)
+		{
+		  it[u] = v;
+		  if (v + 1 != var_mate[u])
+		    {
+		      w = n + v - lo;
+		      break;
+		    }
+		}
+	    }
+	  else if (it[u] < 0)	/* value: its mate (if any) */
+	    {
+	      it[u] = 0;
+	      if (ad_val_stamp[u - n] == ad_stamp)
+		w = ad_val_mate[u - n];
+	    }
+
+	  if (w >= 0)
+	    {
+	      if (ad_node_stamp[w] != ad_stamp)
+		Visit(w);
+	      else if (comp[w] < 0)
+		{
+		  if (num[w] < low[u])
+		    low[u] = num[w];
+		}
+	      else
+		reach[u] |= comp_reach[comp[w]];
+	      continue;
+	    }
+
+	  csp--;		/* u is done */
+	  if (low[u] == num[u])
+	    {
+	      r = 0;
+	      k = tsp;
+	      do
+		r |= reach[tstack[--k]];
+	      while (tstack[k] != u);
+	      comp_reach[nb_comp] = r;
+	      while (tsp > k)
+		comp[tstack[--tsp]] = nb_comp;
+	      nb_comp++;
+	    }
+
+	  if (csp > 0)
+	    {
+	      p = cstack[csp - 1];
+	      if (comp[u] < 0)
+		{
+		  if (low[u] < low[p])
+		    low[p] = low[u];
+		  reach[p] |= reach[u];
+		}
+	      else
+		reach[p] |= comp_reach[comp[u]];
+	    }
+	}
+    }
+
+#undef Visit
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_ALL_DIFFERENT_DOMAIN                                              *
+ *                                                                         *
+ * Domain consistency (Regin, AAAI 1994): the maximum matching kept in the *
+ * state is repaired by augmenting paths, then a value is removed from a   *
+ * variable if the edge belongs to no maximum matching, i.e. if it is not  *
+ * the matched edge, joins two distinct strongly connected components and  *
+ * no free value is reachable from the value. O(sum of domain sizes).      *
+ * Values spanning more than AD_MAX_SPAN only get bounds consistency.      *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_All_Different_Domain(WamWord **array, WamWord *state)
+{
+  int n = (int) (PlLong) array[0];
+  WamWord **fdv = array + 1;
+  WamWord *var_mate = state + 3;
+  int lo, hi, x, v, w, nb_rm, k;
+  Bool changed;
+
+  if (n <= 1)
+    return TRUE;
+
+  for (;;)
+    {
+      lo = Min(fdv[0]);
+      hi = Max(fdv[0]);
+      for (x = 1; x < n; x++)
+	{
+	  if (Min(fdv[x]) < lo)
+	    lo = Min(fdv[x]);
+	  if (Max(fdv[x]) > hi)
+	    hi = Max(fdv[x]);
+	}
+
+      if (hi - lo < AD_MAX_SPAN)
+	break;
+
+      if (!All_Diff_Bounds(fdv, n, NULL, &changed))
+	return FALSE;
+
+      if (!changed)
+	return TRUE;
+    }
+
+  All_Diff_Alloc_Nodes(n + hi - lo + 1);
+  if (++ad_stamp == 0)
+    {
+      memset(ad_val_stamp, 0, ad_size_node * sizeof(unsigned));
+      memset(ad_node_stamp, 0, ad_size_node * sizeof(unsigned));
+      ad_stamp = 1;
+    }
+
+				/* keep what is still valid in the matching */
+  for (x = 0; x < n; x++)
+    {
+      v = (int) var_mate[x] - 1;
+      if (v < 0)
+	continue;
+
+      if (!Pl_Range_Test_Value(Range(fdv[x]), v) ||
+	  ad_val_stamp[v - lo] == ad_stamp)
+	{
+	  var_mate[x] = 0;
+	  continue;
+	}
+
+      ad_val_mate[v - lo] = x;
+      ad_val_stamp[v - lo] = ad_stamp;
+    }
+
+  for (x = 0; x < n; x++)
+    if (var_mate[x] == 0 && !All_Diff_Augment(fdv, var_mate, x, lo))
+      return FALSE;
+
+  All_Diff_Scc(fdv, var_mate, n, lo);
+
+  for (x = 0; x < n; x++)
+    {
+      if (Fd_Variable_Is_Ground(fdv[x]))
+	continue;
+
+      nb_rm = 0;
+      for (v = Min(fdv[x]); v >= 0; v = Pl_Range_Next_After(Range(fdv[x]), v))
+	{
+	  w = n + v - lo;
+	  if (v + 1 != var_mate[x] && ad_comp[w] != ad_comp[x] &&
+	      !ad_comp_reach[ad_comp[w]])
+	    ad_rm[nb_rm++] = v;
+	}
+
+      for (k = 0; k < nb_rm; k++)
+	if (!Pl_Fd_Tell_Not_Value(fdv[x], ad_rm[k]))
+	  return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_ELEMENT_I                                                         *
  *                                                                         *
@@ -156,7 +911,8 @@ Pl_Fd_Element_I(Range *i, WamWord *l)
   int n = *l;			/* I in 1..N in sparse mode */
 
   Range_Init_Interval(i, 1, n);
-  Pl_Range_Becomes_Sparse(i);
+  if (n <= pl_vec_max_integer)	/* else keep the (exact) interval */
+    Pl_Range_Becomes_Sparse(i);
 }
 
 
@@ -171,6 +927,7 @@ Pl_Fd_Element_I_To_V(Range *v, Range *i, WamWord *l)
 {
   int val;
   int j;
+  Bool wide = FALSE;
 
   /* when I changes -> update V */
 
@@ -182,20 +939,37 @@ Pl_Fd_Element_I_To_V(Range *v, Range *i, WamWord *l)
       for (j = i->min; j <= i->max; j++)
 	{
 	  val = l[j];
-	  Vector_Set_Value(v->vec, val);
+	  if (val <= pl_vec_max_integer)
+	    Vector_Set_Value(v->vec, val);
+	  else
+	    wide = TRUE;
 	}
     }
   else
     {
-      VECTOR_BEGIN_ENUM(i->vec, j);
+      RANGE_BEGIN_ENUM(i, j);
 
       val = l[j];
-      Vector_Set_Value(v->vec, val);
+      if (val <= pl_vec_max_integer)
+	Vector_Set_Value(v->vec, val);
+      else
+	wide = TRUE;
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 
   Pl_Range_From_Vector(v);
+
+  if (!wide)
+    return;
+				/* add values > vec max (interval list) */
+  RANGE_BEGIN_ENUM(i, j);
+
+  val = l[j];
+  if (val > pl_vec_max_integer)
+    Pl_Range_Set_Value(v, val);
+
+  RANGE_END_ENUM;
 }
 
 
@@ -210,7 +984,8 @@ Pl_Fd_Element_V_To_I(Range *i, Range *v, WamWord *l)
 {
   int val;
   int n;
-  int j;
+  int j, k;
+  Range r;
 
   /* when V changes -> update I */
 
@@ -219,7 +994,7 @@ Pl_Fd_Element_V_To_I(Range *i, Range *v, WamWord *l)
 
   n = *l;
 
-  for (j = 1; j <= n; j++)
+  for (j = 1; j <= n && j <= pl_vec_max_integer; j++)
     {
       val = l[j];		/* val=Lj */
       if (Pl_Range_Test_Value(v, val))
@@ -227,6 +1002,16 @@ Pl_Fd_Element_V_To_I(Range *i, Range *v, WamWord *l)
     }
 
   Pl_Range_From_Vector(i);
+				/* add indexes > vec max (interval list) */
+  for (; j <= n; j++)
+    if (Pl_Range_Test_Value(v, l[j]))
+      {
+	for (k = j; k < n && Pl_Range_Test_Value(v, l[k + 1]); k++)
+	  ;
+	Range_Init_Interval(&r, j, k);
+	Pl_Range_Union(i, &r);
+	j = k;
+      }
 }
 
 
@@ -242,7 +1027,8 @@ Pl_Fd_Element_Var_I(Range *i, WamWord *l)
   int n = *l;			/* I in 1..N in sparse mode */
 
   Range_Init_Interval(i, 1, n);
-  Pl_Range_Becomes_Sparse(i);
+  if (n <= pl_vec_max_integer)	/* else keep the (exact) interval */
+    Pl_Range_Becomes_Sparse(i);
 }
 
 
@@ -274,12 +1060,12 @@ Pl_Fd_Element_Var_I_To_V(Range *v, Range *i, WamWord **l)
     }
   else
     {
-      VECTOR_BEGIN_ENUM(i->vec, j);
+      RANGE_BEGIN_ENUM(i, j);
 
       fdv_adr = l[j];
       Pl_Range_Union(v, Range(fdv_adr));
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 }
 
@@ -295,7 +1081,8 @@ Pl_Fd_Element_Var_V_To_I(Range *i, Range *v, WamWord **l)
 {
   WamWord *fdv_adr;
   PlLong n;
-  int j;
+  int j, k;
+  Range r;
 
   Vector_Allocate(i->vec);
   Pl_Vector_Empty(i->vec);
@@ -303,7 +1090,7 @@ Pl_Fd_Element_Var_V_To_I(Range *i, Range *v, WamWord **l)
 
   n = (PlLong) *l;
 
-  for (j = 1; j <= n; j++)
+  for (j = 1; j <= n && j <= pl_vec_max_integer; j++)
     {
       fdv_adr = l[j];
       if (!Pl_Range_Test_Null_Inter(Range(fdv_adr), v))
@@ -311,6 +1098,16 @@ Pl_Fd_Element_Var_V_To_I(Range *i, Range *v, WamWord **l)
     }
 
   Pl_Range_From_Vector(i);
+				/* add indexes > vec max (interval list) */
+  for (; j <= n; j++)
+    if (!Pl_Range_Test_Null_Inter(Range(l[j]), v))
+      {
+	for (k = j; k < n && !Pl_Range_Test_Null_Inter(Range(l[k + 1]), v); k++)
+	  ;
+	Range_Init_Interval(&r, j, k);
+	Pl_Range_Union(i, &r);
+	j = k;
+      }
 }
 
 
@@ -478,3 +1275,505 @@ Pl_Fd_Exactly(int n, WamWord **array, int v)
     }
   return TRUE;
 }
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_RELATION                                                          *
+ *                                                                         *
+ * Compact-Table (Demeulenaere et al., CP 2016): the set of the valid      *
+ * tuples is a reversible sparse bitset (only its non-zero words are       *
+ * visited). Each time the domain of a variable changes, the bitset is     *
+ * intersected with the supports of its remaining values (or with the      *
+ * complement of the supports of its removed values if they are fewer).    *
+ * Then a value is kept iff its support meets the bitset, tested first on  *
+ * the residue word. Ensures generalized arc consistency. The supports are *
+ * sparse (only their non-zero words are stored) so the size of the table *
+ * is linear in the number of tuples (see Pl_Fd_Relation_Check_Size).      *
+ * tuples is either the list of the rows or the list of the columns. The   *
+ * table is built at the first call and its address stored in state[1].    *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Relation(WamWord **array, WamWord *tuples, int columns,
+	       WamWord *state)
+{
+  int arity = (int) (PlLong) array[0];
+  WamWord **fdv = array + 1;
+  CtTable *tab = (CtTable *) state[1];
+  CtVar *cv;
+  int x, size, nb_upd = 0, last_upd = -1;
+
+  if (arity == 0)
+    return columns || tuples[0] > 0;
+
+  if (tab == NULL)
+    {
+      tab = Ct_Build(arity, tuples, columns);
+      state[1] = (WamWord) tab;
+    }
+
+  Ct_Alloc_Scratch(tab);
+
+  for (x = 0; x < arity; x++)
+    {
+      cv = tab->var + x;
+      size = Nb_Elem(fdv[x]);
+      if (size == cv->last_size)
+	continue;
+
+      nb_upd++;
+      last_upd = (cv->last_size == 0) ? -1 : x;	/* 0: never filtered */
+      FD_Bind_OV(&cv->last_size, size);
+      if (!Ct_Update(tab, cv, fdv[x]))
+	return FALSE;
+    }
+
+  if (nb_upd == 0)
+    return TRUE;
+
+  for (x = 0; x < arity; x++)
+    {				/* the only updated var keeps its supports */
+      if (nb_upd == 1 && x == last_upd)
+	continue;
+
+      if (!Ct_Filter(tab, tab->var + x, fdv[x]))
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_RELATION_CHECK_SIZE_2                                             *
+ *                                                                         *
+ * Raises a resource error if the constraint stack cannot hold the table   *
+ * of a relation of nb_tuple tuples of the given arity (see Ct_Build: each *
+ * column has at most nb_tuple values and nb_tuple support entries).       *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Relation_Check_Size_2(WamWord arity_word, WamWord nb_tuple_word)
+{
+  PlLong arity = Pl_Rd_Integer(arity_word);
+  PlLong nb_tuple = Pl_Rd_Integer(nb_tuple_word);
+  PlLong nb_word = (nb_tuple + WORD_SIZE - 1) / WORD_SIZE;
+  PlLong size;
+
+  size = sizeof(CtTable) + arity * sizeof(CtVar) +
+    nb_word * (sizeof(int) + sizeof(VecWord)) +
+    arity * ((4 * nb_tuple + 1) * sizeof(int) + nb_tuple * sizeof(VecWord));
+
+  if (size / sizeof(WamWord) + 4 * arity + 8 >= Cstr_Size - Cstr_Used_Size)
+    Pl_Err_Resource(pl_resource_too_big_fd_constraint);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_ALLOC                                                                *
+ *                                                                         *
+ * Allocates nb_bytes on the constraint stack.                             *
+ *-------------------------------------------------------------------------*/
+static void *
+Ct_Alloc(int nb_bytes)
+{
+  void *p = (void *) CS;
+
+  CS += (nb_bytes + sizeof(WamWord) - 1) / sizeof(WamWord);
+  return p;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_CMP_INT                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Ct_Cmp_Int(const void *a, const void *b)
+{
+  int x = *(const int *) a;
+  int y = *(const int *) b;
+
+  return (x > y) - (x < y);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_BUILD                                                                *
+ *                                                                         *
+ * Builds the table: for each column, its sorted distinct values and the   *
+ * bitset of the tuples using each of them. All tuples are initially valid *
+ * and all variables are considered as modified (last_size = 0). The       *
+ * tuples have been checked by the Prolog part (integers, same length).    *
+ *-------------------------------------------------------------------------*/
+static CtTable *
+Ct_Build(int arity, WamWord *tuples, Bool columns)
+{
+  WamWord word, tag_mask;
+  WamWord *lst_adr;
+  WamWord list_word;
+  WamWord *cursor = NULL;
+  int *col, *sorted;
+  int nb_tuple, nb_word, max_nb_val = 0;
+  int x, t, i, k, w, e;
+  CtTable *tab;
+  CtVar *cv;
+
+  nb_tuple = (columns) ? Pl_List_Length(tuples[1]) : (int) tuples[0];
+  nb_word = (nb_tuple + WORD_SIZE - 1) / WORD_SIZE;
+
+  tab = (CtTable *) Ct_Alloc(sizeof(CtTable) + (arity - 1) * sizeof(CtVar));
+  tab->nb_word = nb_word;
+  tab->limit = nb_word;
+  tab->index = (int *) Ct_Alloc(nb_word * sizeof(int));
+  tab->word = (VecWord *) Ct_Alloc(nb_word * sizeof(VecWord));
+  for (i = 0; i < nb_word; i++)
+    {
+      tab->index[i] = i;
+      tab->word[i] = ~(VecWord) 0;
+    }
+  if (nb_tuple % WORD_SIZE)
+    tab->word[nb_word - 1] = ((VecWord) 1 << (nb_tuple % WORD_SIZE)) - 1;
+
+  col = (int *) Malloc((nb_tuple + 1) * sizeof(int));
+  sorted = (int *) Malloc((nb_tuple + 1) * sizeof(int));
+  if (!columns)
+    {
+      cursor = (WamWord *) Malloc((nb_tuple + 1) * sizeof(WamWord));
+      for (t = 0; t < nb_tuple; t++)
+	cursor[t] = tuples[t + 1];
+    }
+
+  for (x = 0; x < arity; x++)
+    {
+      cv = tab->var + x;
+      list_word = tuples[x + 1];
+      for (t = 0; t < nb_tuple; t++)
+	{
+	  if (!columns)
+	    list_word = cursor[t];
+
+	  DEREF(list_word, word, tag_mask);
+	  lst_adr = UnTag_LST(word);
+	  DEREF(Car(lst_adr), word, tag_mask);
+	  col[t] = sorted[t] = UnTag_INT(word);
+
+	  if (columns)
+	    list_word = Cdr(lst_adr);
+	  else
+	    cursor[t] = Cdr(lst_adr);
+	}
+
+      qsort(sorted, nb_tuple, sizeof(int), Ct_Cmp_Int);
+      for (i = k = 0; i < nb_tuple; i++)
+	if (k == 0 || sorted[i] != sorted[k - 1])
+	  sorted[k++] = sorted[i];
+
+      cv->nb_val = k;
+      cv->val = (int *) Ct_Alloc(k * sizeof(int));
+      cv->residue = (int *) Ct_Alloc(k * sizeof(int));
+      cv->sup_start = (int *) Ct_Alloc((k + 1) * sizeof(int));
+      cv->last_size = 0;
+      memcpy(cv->val, sorted, k * sizeof(int));
+      memset(cv->sup_start, 0, (k + 1) * sizeof(int));
+
+				/* count the support words of each value */
+      for (i = 0; i < k; i++)	/* sorted: last word seen for each value */
+	sorted[i] = -1;
+      for (t = 0; t < nb_tuple; t++)
+	{
+	  col[t] = i = Ct_Find_Value(cv, col[t]);
+	  if (sorted[i] != Word_No(t))
+	    {
+	      sorted[i] = Word_No(t);
+	      cv->sup_start[i + 1]++;
+	    }
+	}
+      for (i = 0; i < k; i++)
+	cv->sup_start[i + 1] += cv->sup_start[i];
+
+      e = cv->sup_start[k];
+      cv->sup_no = (int *) Ct_Alloc(e * sizeof(int));
+      cv->sup_word = (VecWord *) Ct_Alloc(e * sizeof(VecWord));
+
+				/* fill them (residue: next free entry) */
+      for (i = 0; i < k; i++)
+	{
+	  sorted[i] = -1;
+	  cv->residue[i] = cv->sup_start[i];
+	}
+      for (t = 0; t < nb_tuple; t++)
+	{
+	  i = col[t];
+	  w = Word_No(t);
+	  if (sorted[i] != w)
+	    {
+	      sorted[i] = w;
+	      e = cv->residue[i]++;
+	      cv->sup_no[e] = w;
+	      cv->sup_word[e] = 0;
+	    }
+	  cv->sup_word[cv->residue[i] - 1] |= (VecWord) 1 << Bit_No(t);
+	}
+      for (i = 0; i < k; i++)
+	cv->residue[i] = cv->sup_start[i];
+
+      if (k > max_nb_val)
+	max_nb_val = k;
+    }
+
+  tab->max_nb_val = max_nb_val;
+
+  Free(col);
+  Free(sorted);
+  if (cursor)
+    Free(cursor);
+
+  return tab;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_ALLOC_SCRATCH                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Ct_Alloc_Scratch(CtTable *tab)
+{
+  if (tab->nb_word > ct_size_word)
+    {
+      ct_size_word = tab->nb_word;
+      ct_mask = (VecWord *) Realloc((char *) ct_mask, ct_size_word * sizeof(VecWord));
+    }
+
+  if (tab->max_nb_val > ct_size_val)
+    {
+      ct_size_val = tab->max_nb_val;
+      ct_idx = (int *) Realloc((char *) ct_idx, ct_size_val * sizeof(int));
+      ct_rm = (int *) Realloc((char *) ct_rm, ct_size_val * sizeof(int));
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_FIND_VALUE                                                           *
+ *                                                                         *
+ * Returns the index of v in the values of the variable or -1.             *
+ *-------------------------------------------------------------------------*/
+static int
+Ct_Find_Value(CtVar *cv, int v)
+{
+  int lo = 0, hi = cv->nb_val - 1, mid;
+
+  while (lo <= hi)
+    {
+      mid = (lo + hi) / 2;
+      if (cv->val[mid] < v)
+	lo = mid + 1;
+      else if (cv->val[mid] > v)
+	hi = mid - 1;
+      else
+	return mid;
+    }
+
+  return -1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_DOM_INDEX                                                            *
+ *                                                                         *
+ * Stores in ct_idx the (increasing) indexes of the values of the variable *
+ * which are in its domain and returns their number. Enumerates the        *
+ * domain if it is small wrt the values, else tests each value.            *
+ *-------------------------------------------------------------------------*/
+static int
+Ct_Dom_Index(CtVar *cv, WamWord *fdv_adr)
+{
+  Range *r = Range(fdv_adr);
+  int nb = 0, i, v;
+
+  if (Nb_Elem(fdv_adr) * 4 < cv->nb_val)
+    {
+      for (v = Min(fdv_adr); v >= 0; v = Pl_Range_Next_After(r, v))
+	if ((i = Ct_Find_Value(cv, v)) >= 0)
+	  ct_idx[nb++] = i;
+    }
+  else
+    {
+      for (i = 0; i < cv->nb_val; i++)
+	if (Pl_Range_Test_Value(r, cv->val[i]))
+	  ct_idx[nb++] = i;
+    }
+
+  return nb;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_UPDATE                                                               *
+ *                                                                         *
+ * Removes from the valid tuples those using a value no longer in the      *
+ * domain of the variable (word-parallel). A word becoming zero is swapped *
+ * beyond limit. The permutation of index needs no trailing: words are     *
+ * only swapped below limit, so the set index[0..limit-1] is restored with *
+ * limit.                                                                  *
+ *-------------------------------------------------------------------------*/
+static Bool
+Ct_Update(CtTable *tab, CtVar *cv, WamWord *fdv_adr)
+{
+  int *index = tab->index;
+  VecWord *word = tab->word;
+  int limit = (int) tab->limit;
+  int nb, i, j, p, w, e;
+  VecWord wd;
+  Bool compl;
+
+  nb = Ct_Dom_Index(cv, fdv_adr);
+  if (nb == 0)
+    return FALSE;
+
+  compl = (cv->nb_val - nb < nb);	/* fewer removed values than kept */
+
+  for (p = 0; p < limit; p++)	/* ct_mask is indexed by word nb */
+    ct_mask[index[p]] = 0;
+
+  for (i = j = 0; i < cv->nb_val; i++)
+    {
+      if (j < nb && ct_idx[j] == i)
+	{
+	  j++;
+	  if (compl)
+	    continue;
+	}
+      else if (!compl)
+	continue;
+
+      for (e = cv->sup_start[i]; e < cv->sup_start[i + 1]; e++)
+	ct_mask[cv->sup_no[e]] |= cv->sup_word[e];
+    }
+
+  for (p = limit - 1; p >= 0; p--)
+    {
+      w = index[p];
+      wd = (compl) ? word[w] & ~ct_mask[w] : word[w] & ct_mask[w];
+      if (wd == word[w])
+	continue;
+
+      FD_Bind_OV((WamWord *) (word + w), wd);
+      if (wd == 0)
+	{
+	  index[p] = index[limit - 1];
+	  index[limit - 1] = w;
+	  limit--;
+	}
+    }
+
+  if (limit != tab->limit)
+    {
+      FD_Bind_OV(&tab->limit, limit);
+    }
+
+  return limit > 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CT_FILTER                                                               *
+ *                                                                         *
+ * Removes the values of the variable without valid tuple. The support of  *
+ * a value is first tested on its residue, then on its other entries.      *
+ *-------------------------------------------------------------------------*/
+static Bool
+Ct_Filter(CtTable *tab, CtVar *cv, WamWord *fdv_adr)
+{
+  VecWord *word = tab->word;
+  int nb, nb_sup = 0, nb_rm = 0, size, i, k, e, end, v;
+  Range range;
+  Bool wide = FALSE;
+
+  if (Fd_Variable_Is_Ground(fdv_adr))
+    return TRUE;
+
+  nb = Ct_Dom_Index(cv, fdv_adr);
+  for (k = 0; k < nb; k++)
+    {
+      i = ct_idx[k];
+      e = cv->residue[i];
+      if ((word[cv->sup_no[e]] & cv->sup_word[e]) == 0)
+	{
+	  end = cv->sup_start[i + 1];
+	  for (e = cv->sup_start[i]; e < end; e++)
+	    if (word[cv->sup_no[e]] & cv->sup_word[e])
+	      break;
+
+	  if (e == end)
+	    {
+	      ct_rm[nb_rm++] = cv->val[i];
+	      continue;
+	    }
+	  cv->residue[i] = e;
+	}
+      ct_idx[nb_sup++] = i;
+    }
+
+  size = Nb_Elem(fdv_adr);
+  if (nb_sup == size)
+    return TRUE;
+
+  if (nb_sup == 0)
+    return FALSE;
+
+  if (nb == size && nb_rm <= CT_MAX_TELL_NOT)
+    {
+      for (k = 0; k < nb_rm; k++)
+	if (!Pl_Fd_Tell_Not_Value(fdv_adr, ct_rm[k]))
+	  return FALSE;
+    }
+  else
+    {				/* build the range of the supported values */
+      range.extra_cstr = FALSE;
+      Vector_Allocate(range.vec);
+      Pl_Vector_Empty(range.vec);
+      for (k = 0; k < nb_sup; k++)
+	{
+	  v = cv->val[ct_idx[k]];
+	  if (v <= pl_vec_max_integer)
+	    Vector_Set_Value(range.vec, v);
+	  else
+	    wide = TRUE;
+	}
+      Pl_Range_From_Vector(&range);
+
+      if (wide)
+	for (k = 0; k < nb_sup; k++)
+	  if ((v = cv->val[ct_idx[k]]) > pl_vec_max_integer)
+	    Pl_Range_Set_Value(&range, v);
+
+      if (!Pl_Fd_Tell_Range_Range(fdv_adr, &range))
+	return FALSE;
+    }
+
+				/* the valid tuples already reflect it */
+  FD_Bind_OV(&cv->last_size, Nb_Elem(fdv_adr));
+
+  return TRUE;
+}
@@ -158,6 +158,10 @@ fd_labeling(List, Options) :-
 	    '$sys_var_write'(0, 5)
 	;   X = random,
 	    '$sys_var_write'(0, 6)
+	;   X = dom_wdeg,
+	    '$sys_var_write'(0, 7)
+	;   X = activity,
+	    '$sys_var_write'(0, 8)
 	).
 
 '$get_labeling_options2'(value_method(X)) :-
@@ -198,7 +202,7 @@ fd_labeling(List, Options) :-
 	'$fd_labeling_std'(List, ValMethod).
 
 '$fd_labeling1'(List, VarMethod, ValMethod, Reorder) :-
-	'$fd_sel_array_from_list'(List, SelArray),
+	'$fd_sel_array_from_list'(List, VarMethod, SelArray),
 	'$fd_labeling_mth'(SelArray, VarMethod, ValMethod, Reorder).
 
 
@@ -225,8 +229,8 @@ fd_labeling(List, Options) :-
 
 
 
-'$fd_sel_array_from_list'(List, SelArray) :-
-	'$call_c_test'('Pl_Fd_Sel_Array_From_List_2'(List, SelArray)).
+'$fd_sel_array_from_list'(List, Method, SelArray) :-
+	'$call_c_test'('Pl_Fd_Sel_Array_From_List_3'(List, Method, SelArray)).
 
 
 
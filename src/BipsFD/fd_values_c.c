@@ -70,6 +70,10 @@
 #define METHOD_LARGEST             4
 #define METHOD_MAX_REGRET          5
 #define METHOD_RANDOM              6
+#define METHOD_DOM_WDEG            7
+#define METHOD_ACTIVITY            8
+
+#define ACTIVITY_DECAY             0.999
 
 
 
@@ -101,6 +105,10 @@ static Bool Cmp_Largest(WamWord *last_fdv_adr, WamWord *new_fdv_adr);
 
 static Bool Cmp_Max_Regret(WamWord *last_fdv_adr, WamWord *new_fdv_adr);
 
+static WamWord **Pick_Dom_Wdeg(WamWord **array, PlLong n);
+
+static WamWord **Pick_Activity(WamWord **array, PlLong n);
+
 
 
 #define INDOMAIN_ALT               X1_24696E646F6D61696E5F616C74
@@ -117,6 +125,11 @@ Prolog_Prototype(EXTRA_CSTR_ALT, 0);
 Bool pl_fd_domain_r(WamWord x_word, WamWord r_word);
 
 
+  /* defined in fd_optim_c.c */
+
+void Pl_Fd_Bb_Node(void);
+
+
 
 
 /*-------------------------------------------------------------------------*
@@ -341,6 +354,9 @@ Pl_Indomain_2(WamWord x_word, WamWord method_word)
 
   fdv_adr = UnTag_FDV(word);
 
+  if (tag_mask != TAG_INT_MASK)
+    Pl_Fd_Bb_Node();		/* counts the node (throws at a limit) */
+
  bisect_terminal_rec:
   if (tag_mask == TAG_INT_MASK)
     return TRUE;
@@ -391,6 +407,8 @@ Pl_Indomain_Alt_0(void)
   value_method = A(1);
   value = A(2);
 
+  Pl_Fd_Bb_Node();
+
   if (value_method == METHOD_LIMITS_MIN)
     value_method = METHOD_LIMITS_MAX;
   else if (value_method == METHOD_LIMITS_MAX)
@@ -462,11 +480,16 @@ Pl_Extra_Cstr_Alt_0(void)
 
 
 /*-------------------------------------------------------------------------*
- * PL_FD_SEL_ARRAY_FROM_LIST_2                                             *
+ * PL_FD_SEL_ARRAY_FROM_LIST_3                                             *
  *                                                                         *
+ * The selection array is [n, fdv_1, ..., fdv_n] in the constraint stack.  *
+ * For the activity method it is followed by the size of each domain at    *
+ * the last selection (n words) and the activity of each variable (n       *
+ * doubles), neither trailed (see Pick_Activity).                          *
  *-------------------------------------------------------------------------*/
 Bool
-Pl_Fd_Sel_Array_From_List_2(WamWord list_word, WamWord sel_array_word)
+Pl_Fd_Sel_Array_From_List_3(WamWord list_word, WamWord method_word,
+			    WamWord sel_array_word)
 {
   WamWord word, tag_mask;
   WamWord save_list_word;
@@ -475,6 +498,8 @@ Pl_Fd_Sel_Array_From_List_2(WamWord list_word, WamWord sel_array_word)
   WamWord *fdv_adr;
   WamWord *array;
   WamWord *save_array;
+  double *act;
+  int i;
 
 
   array = CS;
@@ -519,6 +544,17 @@ Pl_Fd_Sel_Array_From_List_2(WamWord list_word, WamWord sel_array_word)
 
   *save_array = n;
 
+  if (Pl_Rd_Integer_Check(method_word) == METHOD_ACTIVITY)
+    {				/* see Pick_Activity */
+      act = (double *) (array + n);
+      for (i = 0; i < n; i++)
+	{
+	  array[i] = Nb_Elem((WamWord *) save_array[1 + i]);
+	  act[i] = 0.0;
+	}
+      array = (WamWord *) (act + n);
+    }
+
   CS = array;
 
   return Pl_Get_Integer(Cstr_Offset(save_array), sel_array_word);
@@ -585,6 +621,14 @@ Pl_Fd_Sel_Array_Pick_Var_4(WamWord sel_array_word, WamWord method_word,
       cmp_meth = Cmp_Max_Regret;
       break;
 
+    case METHOD_DOM_WDEG:
+      res_elem = Pick_Dom_Wdeg(array, n);
+      goto picked;
+
+    case METHOD_ACTIVITY:
+      res_elem = Pick_Activity(array, n);
+      goto picked;
+
     case METHOD_RANDOM:
       for (;;)
 	{
@@ -654,6 +698,10 @@ Pl_Fd_Sel_Array_Pick_Var_4(WamWord sel_array_word, WamWord method_word,
     }
 #endif
 
+picked:
+  if (res_elem == NULL)
+    return FALSE;
+
   fdv_adr = *res_elem;
 
 finish:
@@ -747,3 +795,89 @@ Cmp_Max_Regret(WamWord *last_fdv_adr, WamWord *new_fdv_adr)
   return n_diff > l_diff ||
     (n_diff == l_diff && Nb_Cstr(new_fdv_adr) > Nb_Cstr(last_fdv_adr));
 }
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PICK_DOM_WDEG                                                           *
+ *                                                                         *
+ * Selects the variable with the smallest ratio domain size / weighted     *
+ * degree, i.e. the largest wdeg/dom (the weights of the constraints count *
+ * the failures they have caused, see Pl_Fd_Weighted_Degree).              *
+ *-------------------------------------------------------------------------*/
+static WamWord **
+Pick_Dom_Wdeg(WamWord **array, PlLong n)
+{
+  WamWord **p, **end = array + n;
+  WamWord **res_elem = NULL;
+  WamWord *fdv_adr;
+  double score, best = 0.0;
+
+  for (p = array; p < end; p++)
+    {
+      fdv_adr = *p;
+      if (Fd_Variable_Is_Ground(fdv_adr))
+	continue;
+
+      score = (double) Pl_Fd_Weighted_Degree(fdv_adr) / Nb_Elem(fdv_adr);
+      if (res_elem == NULL || score > best)
+	{
+	  res_elem = p;
+	  best = score;
+	}
+    }
+
+  return res_elem;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PICK_ACTIVITY                                                           *
+ *                                                                         *
+ * Activity-based selection. At each call, the activity of each variable   *
+ * decays and is increased by 1 if its domain has been reduced since the   *
+ * previous call (i.e. by the last choice and its propagation). Activities *
+ * and sizes are not trailed: they are learnt across backtracking (after a *
+ * backtrack a domain is larger, which is not counted as a reduction).     *
+ * Selects the variable with the largest (activity + 1) / domain size (so  *
+ * that first-fail is used until activities have been learnt).             *
+ *-------------------------------------------------------------------------*/
+static WamWord **
+Pick_Activity(WamWord **array, PlLong n)
+{
+  PlLong *last_size = (PlLong *) (array + n);
+  double *act = (double *) (last_size + n);
+  WamWord **res_elem = NULL;
+  WamWord *fdv_adr;
+  Bool ground;
+  PlLong size;
+  double score, best = 0.0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      fdv_adr = array[i];
+      ground = Fd_Variable_Is_Ground(fdv_adr);
+      size = (ground) ? 1 : Nb_Elem(fdv_adr);
+
+      act[i] *= ACTIVITY_DECAY;
+      if (size < last_size[i])
+	act[i] += 1.0;
+      last_size[i] = size;
+
+      if (ground)
+	continue;
+
+      score = (act[i] + 1.0) / size;
+      if (res_elem == NULL || score > best)
+	{
+	  res_elem = array + i;
+	  best = score;
+	}
+    }
+
+  return res_elem;
+}
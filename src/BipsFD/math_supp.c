@@ -67,6 +67,13 @@
 
 #define MAX_COEF_FOR_SORT          100
 
+	  /* from this size a side is loaded as a single n-ary constraint: each
+	   * wake-up of the n-ary constraint scans all its variables, so the
+	   * chain is faster for shorter sums but its trail grows quadratically
+	   * during labeling (overflow from ~1500 terms) */
+
+#define MIN_MONOMS_FOR_LINEAR      500
+
 
 #define PLUS_1                     0
 #define PLUS_2                     1
@@ -157,6 +164,11 @@ static WamWord vars_tbl[VARS_STACK_SIZE];
 static WamWord *vars_sp;
 
 
+static WamWord lin_x[MAX_MONOMS + 1];	/* args of an n-ary linear constraint */
+static WamWord lin_a[MAX_MONOMS + 1];
+static WamWord lin_s[2 * MAX_MONOMS + 6];
+
+
 static Bool sort;
 
 
@@ -191,6 +203,8 @@ static Bool Load_Poly(int nb_monom, Monom *m, WamWord pref_load_word,
 
 static Bool Load_Poly_Rec(int nb_monom, Monom *m, WamWord load_word);
 
+static Bool Load_Poly_Linear(int nb_monom, Monom *m, WamWord load_word);
+
 static Bool Load_Delay_Cstr_Part(void);
 
 
@@ -210,6 +224,31 @@ void Pl_Write_1(WamWord term_word);
 
 
 
+	  /* new bounds min..max of Xi (old ones in bnd[0..1]) -> update sums */
+
+#define Linear_Update_Sums(ai, min, max, bnd)			\
+  do								\
+    {								\
+      int new_min = (min), new_max = (max);			\
+								\
+      if ((ai) > 0)						\
+	{							\
+	  sum_min += (ai) * (new_min - (PlLong) (bnd)[0]);	\
+	  sum_max += (ai) * (new_max - (PlLong) (bnd)[1]);	\
+	}							\
+      else							\
+	{							\
+	  sum_min += (ai) * (new_max - (PlLong) (bnd)[1]);	\
+	  sum_max += (ai) * (new_min - (PlLong) (bnd)[0]);	\
+	}							\
+      FD_Bind_OV((bnd), new_min);				\
+      FD_Bind_OV((bnd) + 1, new_max);				\
+    }								\
+  while (0)
+
+
+
+
 
 /*-------------------------------------------------------------------------*
  * MATH_SUPP_INITIALIZER                                                   *
@@ -1161,6 +1200,9 @@ Load_Poly(int nb_monom, Monom *m, WamWord pref_load_word,
   else
     *load_word = New_Tagged_Fd_Variable;
 
+  if (nb_monom >= MIN_MONOMS_FOR_LINEAR && !pl_full_ac)
+    return Load_Poly_Linear(nb_monom, m, *load_word);
+
   return Load_Poly_Rec(nb_monom, m, *load_word);
 }
 
@@ -1242,6 +1284,48 @@ Load_Poly_Rec(int nb_monom, Monom *m, WamWord load_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * LOAD_POLY_LINEAR                                                        *
+ *                                                                         *
+ * This function loads a polynomial term into a word with a single n-ary   *
+ * constraint a1*X1 + ... + an*Xn - load_word = 0 instead of a chain of    *
+ * ternary/quaternary constraints (and intermediate variables). The        *
+ * monomial terms are sorted by decreasing coefficients (see               *
+ * Pl_Fd_Linear_Eq). Only used for partial AC (bounds consistency).        *
+ *-------------------------------------------------------------------------*/
+static Bool
+Load_Poly_Linear(int nb_monom, Monom *m, WamWord load_word)
+{
+  WamWord x_word, a_word, s_word;
+  int i;
+
+  qsort(m, nb_monom, sizeof(Monom),
+	(int (*)(const void *, const void *)) Compar_Monom);
+
+  for (i = 0; i < nb_monom; i++)
+    {
+      lin_x[i] = m[i].x_word;
+      lin_a[i] = Tag_INT(m[i].a);
+    }
+  lin_x[nb_monom] = load_word;
+  lin_a[nb_monom] = Tag_INT(-1);
+  nb_monom++;
+
+  for (i = 0; i < 2 * nb_monom + 4; i++)
+    lin_s[i] = Tag_INT(0);
+
+  x_word = Pl_Mk_Proper_List(nb_monom, lin_x);
+  a_word = Pl_Mk_Proper_List(nb_monom, lin_a);
+  s_word = Pl_Mk_Proper_List(2 * nb_monom + 4, lin_s);
+
+  PRIM_CSTR_3(pl_linear_eq, x_word, a_word, s_word);
+
+  return TRUE;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * LOAD_DELAY_CSTR_PART                                                    *
  *                                                                         *
@@ -1383,6 +1467,121 @@ pl_x_eq_c(WamWord x, WamWord c)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_FD_LINEAR_EQ                                                         *
+ *                                                                         *
+ * Bounds consistency of a1*X1 + ... + an*Xn = 0 (ai != 0). The state      *
+ * records the min and max of the sum together with the bounds of each Xi  *
+ * they were computed from (all trailed): at each call only the variables  *
+ * whose bounds have changed update the sums. With rest = sum - ai*Xi, the *
+ * bounds of Xi are then filtered by ai*Xi in -max(rest) .. -min(rest).    *
+ * Since the ai are sorted by decreasing |ai|, the filtering loop stops as *
+ * soon as |ai| * (largest width of a domain) does not exceed the slack    *
+ * (-min(sum) and max(sum)): no variable after can be pruned. The loop is  *
+ * repeated until a fixpoint is reached (the constraint is idempotent).    *
+ *                                                                         *
+ * state[1]: 1 if initialized, state[2]/state[3]: min/max of the sum,      *
+ * state[4 + 2*i]/state[5 + 2*i]: min/max of Xi used in these sums.        *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Linear_Eq(WamWord *array, WamWord *coef, WamWord *state)
+{
+  int n = (int) array[0];
+  WamWord **fdv = (WamWord **) (array + 1);
+  WamWord *a = coef + 1;
+  WamWord *bnd = state + 4;
+  PlLong sum_min, sum_max, ai, lo, hi, slack, max_width = 0;
+  int i, min, max;
+  Bool change;
+
+  if (state[1] == 0)
+    {
+      sum_min = sum_max = 0;
+      for (i = 0; i < n; i++)
+	{
+	  min = Min(fdv[i]);
+	  max = Max(fdv[i]);
+	  ai = a[i];
+	  sum_min += (ai > 0) ? ai * min : ai * max;
+	  sum_max += (ai > 0) ? ai * max : ai * min;
+	  FD_Bind_OV(bnd + 2 * i, min);
+	  FD_Bind_OV(bnd + 2 * i + 1, max);
+	  if (max - min > max_width)
+	    max_width = max - min;
+	}
+      FD_Bind_OV(state + 1, 1);
+    }
+  else
+    {
+      sum_min = state[2];
+      sum_max = state[3];
+      for (i = 0; i < n; i++)
+	{
+	  min = Min(fdv[i]);
+	  max = Max(fdv[i]);
+	  if (min != bnd[2 * i] || max != bnd[2 * i + 1])
+	    {
+	      ai = a[i];
+	      Linear_Update_Sums(ai, min, max, bnd + 2 * i);
+	    }
+	  if (max - min > max_width)
+	    max_width = max - min;
+	}
+    }
+
+  do
+    {
+      if (sum_min > 0 || sum_max < 0)
+	return FALSE;
+
+      slack = math_min(-sum_min, sum_max);
+      change = FALSE;
+      for (i = 0; i < n; i++)
+	{
+	  ai = a[i];
+	  if ((ai > 0 ? ai : -ai) * max_width <= slack)
+	    break;
+
+	  min = bnd[2 * i];
+	  max = bnd[2 * i + 1];
+	  if (ai > 0)
+	    {
+	      lo = max - sum_max / ai;
+	      hi = min - sum_min / ai;
+	    }
+	  else
+	    {
+	      lo = max - sum_min / ai;
+	      hi = min + sum_max / -ai;
+	    }
+
+	  if (lo <= min && hi >= max)
+	    continue;
+
+	  if (!Pl_Fd_Tell_Interval(fdv[i], math_max(lo, min), math_min(hi, max)))
+	    return FALSE;
+
+	  Linear_Update_Sums(ai, Min(fdv[i]), Max(fdv[i]), bnd + 2 * i);
+	  if (sum_min > 0 || sum_max < 0)
+	    return FALSE;
+
+	  change = TRUE;
+	}
+    }
+  while (change);
+
+  if (sum_min != state[2])
+    FD_Bind_OV(state + 2, sum_min);
+
+  if (sum_max != state[3])
+    FD_Bind_OV(state + 3, sum_max);
+
+  return TRUE;
+}
+
+
+
+
 #ifdef DEBUG
 
 /*-------------------------------------------------------------------------*
@@ -93,6 +93,8 @@ Bool Pl_Term_Math_Loading(WamWord l_word, WamWord r_word);
 
 Bool Pl_Fd_Math_Unify_X_Y(WamWord x, WamWord y);
 
+Bool Pl_Fd_Linear_Eq(WamWord *array, WamWord *coef, WamWord *state);
+
 
 
 #ifdef DEBUG
@@ -159,6 +161,8 @@ Bool pl_ax_plus_y_plus_z_eq_t(WamWord a, WamWord x, WamWord y, WamWord z,
 Bool pl_ax_plus_by_plus_z_eq_t(WamWord a, WamWord x, WamWord b, WamWord y,
 			    WamWord z, WamWord t);
 
+Bool pl_linear_eq(WamWord x, WamWord a, WamWord s);
+
 Bool pl_ax_eq_y_F(WamWord a, WamWord x, WamWord y);
 
 Bool pl_x_plus_y_eq_z_F(WamWord x, WamWord y, WamWord z);
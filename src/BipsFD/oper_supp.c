@@ -414,11 +414,11 @@ Pl_Full_Coeff_Power_Var(Range *y, int a, Range *n)
 	  an0 *= a;
 	}
     }
-  else				/* N is Sparse */
+  else				/* N is Sparse or a List */
     {
       y->extra_cstr = n->extra_cstr;
 
-      VECTOR_BEGIN_ENUM(n->vec, vec_elem);
+      RANGE_BEGIN_ENUM(n, vec_elem);
 
       an = Pl_Power(a, vec_elem);
       if (an > (unsigned) pl_vec_max_integer)
@@ -426,7 +426,7 @@ Pl_Full_Coeff_Power_Var(Range *y, int a, Range *n)
 
       Vector_Set_Value(y->vec, an);
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 end_loop:
 
@@ -469,9 +469,9 @@ Pl_Full_Find_Expon(Range *n, int a, Range *y)
 	    }
 	}
     }
-  else				/* Y is Sparse */
+  else				/* Y is Sparse or a List */
     {
-      VECTOR_BEGIN_ENUM(y->vec, vec_elem);
+      RANGE_BEGIN_ENUM(y, vec_elem);
 
       e = Pl_Find_Expon_Exact(a, vec_elem);
 
@@ -483,7 +483,7 @@ Pl_Full_Find_Expon(Range *n, int a, Range *y)
 	  Vector_Set_Value(n->vec, e);
 	}
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 
   n->min = min;
@@ -528,11 +528,11 @@ Pl_Full_Var_Power_Coeff(Range *y, Range *x, int a)
 	  Vector_Set_Value(y->vec, xa);
 	}
     }
-  else				/* X is Sparse */
+  else				/* X is Sparse or a List */
     {
       y->extra_cstr = x->extra_cstr;
 
-      VECTOR_BEGIN_ENUM(x->vec, vec_elem);
+      RANGE_BEGIN_ENUM(x, vec_elem);
 
       xa = Pl_Power(vec_elem, a);
       if (xa > (unsigned) pl_vec_max_integer)
@@ -540,7 +540,7 @@ Pl_Full_Var_Power_Coeff(Range *y, Range *x, int a)
 
       Vector_Set_Value(y->vec, xa);
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 end_loop:
 
@@ -582,9 +582,9 @@ Pl_Full_Nth_Root(Range *x, Range *y, int a)
 	    }
 	}
     }
-  else				/* Y is Sparse */
+  else				/* Y is Sparse or a List */
     {
-      VECTOR_BEGIN_ENUM(y->vec, vec_elem);
+      RANGE_BEGIN_ENUM(y, vec_elem);
 
       e = Pl_Nth_Root_Exact(vec_elem, a);
 
@@ -596,7 +596,7 @@ Pl_Full_Nth_Root(Range *x, Range *y, int a)
 	  Vector_Set_Value(x->vec, e);
 	}
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 
   x->min = min;
@@ -641,11 +641,11 @@ Pl_Full_Var_Power_2(Range *y, Range *x)
 	  Vector_Set_Value(y->vec, x2);
 	}
     }
-  else				/* X is Sparse */
+  else				/* X is Sparse or a List */
     {
       y->extra_cstr = x->extra_cstr;
 
-      VECTOR_BEGIN_ENUM(x->vec, vec_elem);
+      RANGE_BEGIN_ENUM(x, vec_elem);
 
       x2 = vec_elem * vec_elem;
       if (x2 > (unsigned) pl_vec_max_integer)
@@ -653,7 +653,7 @@ Pl_Full_Var_Power_2(Range *y, Range *x)
 
       Vector_Set_Value(y->vec, x2);
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 end_loop:
 
@@ -695,9 +695,9 @@ Pl_Full_Sqrt_Var(Range *x, Range *y)
 	    }
 	}
     }
-  else				/* Y is Sparse */
+  else				/* Y is Sparse or a List */
     {
-      VECTOR_BEGIN_ENUM(y->vec, vec_elem);
+      RANGE_BEGIN_ENUM(y, vec_elem);
 
       e = Pl_Sqrt_Exact(vec_elem);
 
@@ -709,7 +709,7 @@ Pl_Full_Sqrt_Var(Range *x, Range *y)
 	  Vector_Set_Value(x->vec, e);
 	}
 
-      VECTOR_END_ENUM;
+      RANGE_END_ENUM;
     }
 
   x->min = min;
@@ -65,6 +65,11 @@
 	'$use_g_var_inl',
 	'$use_stat',
 	'$use_dec10io',
+	'$use_fact_store',
+	'$use_htable',
+	'$use_omap',
+	'$use_g_num',
+	'$use_fast_io',
 	'$use_format',
 	'$use_os_interf',
 	'$use_expand',
@@ -846,7 +846,6 @@ static Bool
 String_To_Number(char *str, WamWord number_word)
 {
   WamWord word;
-  int stm;
   StmInf *pstm;
   Bool eof;
 
@@ -861,8 +860,7 @@ String_To_Number(char *str, WamWord number_word)
     }
 #endif
 
-  stm = Pl_Add_Str_Stream(str, TERM_STREAM_ATOM);
-  pstm = pl_stm_tbl[stm];
+  pstm = Pl_Open_Buffer_Stream_In(str, strlen(str));
 
   word = Pl_Read_Number(pstm);
   eof = (Pl_Stream_Peekc(pstm) == EOF);
@@ -872,8 +870,6 @@ String_To_Number(char *str, WamWord number_word)
 			  pstm->line_count + 1, pstm->line_pos + 1,
 			  "non numeric character");
 
-  Pl_Delete_Str_Stream(stm);
-
   if (word == NOT_A_WAM_WORD || !eof)
     {
 #if 0
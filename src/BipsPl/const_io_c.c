@@ -36,6 +36,8 @@
  *-------------------------------------------------------------------------*/
 
 
+#include <string.h>
+
 #include "engine_pl.h"
 #include "bips_pl.h"
 
@@ -82,11 +84,11 @@ void Pl_Format_3(WamWord sora_word, WamWord format_word, WamWord args_word);
 
 	  /* from read_c.c */
 
-Bool Pl_Read_Term_5(WamWord sora_word, WamWord term_word,
-		    WamWord vars_word, WamWord var_names_word,
-		    WamWord sing_names_word);
+Bool Pl_Read_Term_From_Stream(StmInf *pstm, WamWord term_word,
+			      WamWord vars_word, WamWord var_names_word,
+			      WamWord sing_names_word);
 
-Bool Pl_Read_Token_2(WamWord sora_word, WamWord token_word);
+Bool Pl_Read_Token_From_Stream(StmInf *pstm, WamWord token_word);
 
 
 
@@ -115,6 +117,29 @@ Bool Pl_Read_Token_2(WamWord sora_word, WamWord token_word);
 
 
 
+	  /* same as OUT_TO_STR but gives the atom of the output (no copy) */
+
+#define OUT_TO_ATOM(atom, stm_word, code_out, code_after)		\
+{									\
+  int stm;								\
+  WamWord stm_word;							\
+  int atom;								\
+									\
+  stm = Pl_Add_Str_Stream(NULL, TERM_STREAM_ATOM);			\
+  stm_word = Pl_Make_Stream_Tagged_Word(stm);				\
+									\
+  { code_out; }								\
+									\
+  atom = Pl_Term_Write_Str_Stream_Atom(stm);				\
+									\
+  { code_after; }							\
+									\
+  Pl_Delete_Str_Stream(stm);						\
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_WRITE_TO_STRING (foreign interface)                                  *
  *                                                                         *
@@ -191,6 +216,87 @@ Pl_Display_To_String(WamWord term_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * The following functions write a term into a buffer given by the caller  *
+ * (foreign interface). No stream is created: the output is directly done  *
+ * into buff which receives at most size - 1 chars followed by '\0'. Like  *
+ * snprintf, they return the length of the whole output (it has thus been  *
+ * truncated iff the returned value is >= size).                           *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * WRITE_TO_BUFFER                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Write_To_Buffer(WamWord term_word, char *buff, int size, int mask)
+{
+  StmInf *pstm = Pl_Open_Buffer_Stream_Out(buff, size);
+
+  Pl_Write_Term(pstm, -1, MAX_PREC, mask, NULL, term_word);
+
+  return (int) Pl_Close_Buffer_Stream_Out(pstm);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_WRITE_TO_BUFFER (foreign interface)                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Write_To_Buffer(WamWord term_word, char *buff, int size)
+{
+  return Write_To_Buffer(term_word, buff, size,
+			 WRITE_NUMBER_VARS | WRITE_NAME_VARS);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_WRITEQ_TO_BUFFER (foreign interface)                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Writeq_To_Buffer(WamWord term_word, char *buff, int size)
+{
+  return Write_To_Buffer(term_word, buff, size,
+			 WRITE_NUMBER_VARS | WRITE_NAME_VARS | WRITE_QUOTED);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_WRITE_CANONICAL_TO_BUFFER (foreign interface)                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Write_Canonical_To_Buffer(WamWord term_word, char *buff, int size)
+{
+  return Write_To_Buffer(term_word, buff, size,
+			 WRITE_IGNORE_OP | WRITE_QUOTED);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_DISPLAY_TO_BUFFER (foreign interface)                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Display_To_Buffer(WamWord term_word, char *buff, int size)
+{
+  return Write_To_Buffer(term_word, buff, size, WRITE_IGNORE_OP);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_WRITE_TO_ATOM_2                                                      *
  *                                                                         *
@@ -200,9 +306,9 @@ Pl_Write_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Write_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -257,9 +363,9 @@ Pl_Writeq_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Writeq_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -314,9 +420,9 @@ Pl_Write_Canonical_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Write_Canonical_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -371,9 +477,9 @@ Pl_Display_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Display_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -428,9 +534,9 @@ Pl_Print_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Print_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -485,9 +591,9 @@ Pl_Write_Term_To_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Write_Term_2(stm_word, term_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -542,9 +648,9 @@ Pl_Format_To_Atom_3(WamWord atom_word, WamWord format_word, WamWord args_word)
 {
   Bool ret;
 
-  OUT_TO_STR(TERM_STREAM_ATOM, str, stm_word,
+  OUT_TO_ATOM(atom, stm_word,
 	     Pl_Format_3(stm_word, format_word, args_word),
-	     ret = Pl_Un_String_Check(str, atom_word));
+	     ret = Pl_Un_Atom_Check(atom, atom_word));
 
   return ret;
 }
@@ -592,17 +698,17 @@ Pl_Format_To_Codes_3(WamWord codes_word, WamWord format_word, WamWord args_word)
 
 /*----- INPUT -----*/
 
-#define IN_FROM_STR(const_stream_type, str, stm_word, code_in)	\
+	  /* the input is read from a buffer stream on str (no stream is */
+	  /* added to the stream table, see Pl_Open_Buffer_Stream_In)    */
+
+#define IN_FROM_STR(str, pstm, code_in)				\
 {								\
-  int stm;							\
-  WamWord stm_word;						\
+  char *in_str = (str);						\
+  StmInf *pstm;							\
 								\
-  stm = Pl_Add_Str_Stream(str, const_stream_type);		\
-  stm_word = Pl_Make_Stream_Tagged_Word(stm);			\
+  pstm = Pl_Open_Buffer_Stream_In(in_str, strlen(in_str));	\
 								\
   { code_in; }							\
-								\
-  Pl_Delete_Str_Stream(stm);					\
 }
 
 
@@ -625,8 +731,8 @@ Pl_Read_From_String(char *str)
   SYS_VAR_SYNTAX_ERROR_ACTON = -1; /* on syntax error use value fo flags syntax_error */
 
 
-  IN_FROM_STR(TERM_STREAM_ATOM, str, stm_word, 
-	      Pl_Read_Term_5(stm_word, term_word, 0, 0, 0));
+  IN_FROM_STR(str, pstm,
+	      Pl_Read_Term_From_Stream(pstm, term_word, 0, 0, 0));
 
   return term_word;
 }
@@ -634,6 +740,33 @@ Pl_Read_From_String(char *str)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_READ_FROM_BUFFER (foreign interface)                                 *
+ *                                                                         *
+ * Same as Pl_Read_From_String() but reads the size chars of buff (which   *
+ * needs not end with '\0'). The parser directly works on buff (no stream  *
+ * is created nor any copy done).                                          *
+ *-------------------------------------------------------------------------*/
+WamWord
+Pl_Read_From_Buffer(const char *buff, int size)
+{
+  WamWord word;
+
+  word = Pl_Read_Term(Pl_Open_Buffer_Stream_In((char *) buff, size),
+		      PARSE_END_OF_TERM_EOF);
+
+  if (word == NOT_A_WAM_WORD)
+    {
+      Pl_Syntax_Error(Flag_Value(syntax_error));
+      return Pl_Mk_Variable();
+    }
+
+  return word;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_READ_FROM_ATOM_2                                                     *
  *                                                                         *
@@ -643,8 +776,8 @@ Pl_Read_From_Atom_2(WamWord atom_word, WamWord term_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_ATOM, pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, stm_word, 
-	      ret = Pl_Read_Term_5(stm_word, term_word, 0, 0, 0));
+  IN_FROM_STR(pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, 0, 0, 0));
 
   return ret;
 }
@@ -661,8 +794,8 @@ Pl_Read_From_Chars_2(WamWord chars_word, WamWord term_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CHARS, Pl_Rd_Chars_Check(chars_word), stm_word,
-	      ret = Pl_Read_Term_5(stm_word, term_word, 0, 0, 0));
+  IN_FROM_STR(Pl_Rd_Chars_Check(chars_word), pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, 0, 0, 0));
 
   return ret;
 }
@@ -679,8 +812,8 @@ Pl_Read_From_Codes_2(WamWord codes_word, WamWord term_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CODES, Pl_Rd_Codes_Check(codes_word), stm_word,
-	      ret = Pl_Read_Term_5(stm_word, term_word, 0, 0, 0));
+  IN_FROM_STR(Pl_Rd_Codes_Check(codes_word), pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, 0, 0, 0));
 
   return ret;
 }
@@ -699,8 +832,8 @@ Pl_Read_Term_From_Atom_5(WamWord atom_word, WamWord term_word,
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_ATOM, pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, stm_word,
-	      ret = Pl_Read_Term_5(stm_word, term_word, vars_word, var_names_word, sing_names_word));
+  IN_FROM_STR(pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, vars_word, var_names_word, sing_names_word));
 
   return ret;
 }
@@ -719,8 +852,8 @@ Pl_Read_Term_From_Chars_5(WamWord chars_word, WamWord term_word,
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CHARS, Pl_Rd_Chars_Check(chars_word), stm_word,
-	      ret = Pl_Read_Term_5(stm_word, term_word, vars_word, var_names_word, sing_names_word));
+  IN_FROM_STR(Pl_Rd_Chars_Check(chars_word), pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, vars_word, var_names_word, sing_names_word));
 
   return ret;
 }
@@ -740,8 +873,8 @@ Pl_Read_Term_From_Codes_5(WamWord codes_word, WamWord term_word,
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CODES, Pl_Rd_Codes_Check(codes_word), stm_word,
-	      ret = Pl_Read_Term_5(stm_word, term_word, vars_word, var_names_word, sing_names_word));
+  IN_FROM_STR(Pl_Rd_Codes_Check(codes_word), pstm,
+	      ret = Pl_Read_Term_From_Stream(pstm, term_word, vars_word, var_names_word, sing_names_word));
 
   return ret;
 }
@@ -758,8 +891,8 @@ Pl_Read_Token_From_Atom_2(WamWord atom_word, WamWord token_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_ATOM, pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, stm_word,
-	      ret = Pl_Read_Token_2(stm_word, token_word));
+  IN_FROM_STR(pl_atom_tbl[Pl_Rd_Atom_Check(atom_word)].name, pstm,
+	      ret = Pl_Read_Token_From_Stream(pstm, token_word));
 
   return ret;
 }
@@ -776,8 +909,8 @@ Pl_Read_Token_From_Chars_2(WamWord chars_word, WamWord token_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CHARS, Pl_Rd_Chars_Check(chars_word), stm_word,
-	      ret = Pl_Read_Token_2(stm_word, token_word));
+  IN_FROM_STR(Pl_Rd_Chars_Check(chars_word), pstm,
+	      ret = Pl_Read_Token_From_Stream(pstm, token_word));
 
   return ret;
 }
@@ -794,8 +927,8 @@ Pl_Read_Token_From_Codes_2(WamWord codes_word, WamWord token_word)
 {
   Bool ret;
 
-  IN_FROM_STR(TERM_STREAM_CODES, Pl_Rd_Codes_Check(codes_word), stm_word,
-	      ret = Pl_Read_Token_2(stm_word, token_word));
+  IN_FROM_STR(Pl_Rd_Codes_Check(codes_word), pstm,
+	      ret = Pl_Read_Token_From_Stream(pstm, token_word));
 
   return ret;
 }
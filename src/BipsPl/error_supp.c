@@ -188,9 +188,12 @@ Error_Supp_Initializer(void)
   pl_domain_date_time = Pl_Create_Atom("date_time");/* for os_interf */
   pl_domain_selectable_item = Pl_Create_Atom("selectable_item");
 				/* for select_read/3 */
+  pl_domain_poll_event = Pl_Create_Atom("poll_event"); /* for pollers */
 #ifndef NO_USE_SOCKETS
   pl_domain_socket_domain = Pl_Create_Atom("socket_domain"); /* for sockets */
   pl_domain_socket_address = Pl_Create_Atom("socket_address"); /* for sockets */
+  pl_domain_ordered_map = Pl_Create_Atom("ordered_map"); /* for ordered maps */
+  pl_domain_g_num_type = Pl_Create_Atom("g_num_type"); /* for numeric arrays */
 #endif
 
   pl_existence_procedure = Pl_Create_Atom("procedure");
@@ -198,6 +201,13 @@ Error_Supp_Initializer(void)
   pl_existence_stream = Pl_Create_Atom("stream");
   pl_existence_sr_descriptor = Pl_Create_Atom("sr_descriptor");
 				/* for source reader */
+  pl_existence_fact_store = Pl_Create_Atom("fact_store");
+				/* for fact stores */
+  pl_existence_hash_table = Pl_Create_Atom("hash_table");
+				/* for hash tables */
+  pl_existence_g_num_array = Pl_Create_Atom("g_num_array");
+				/* for numeric arrays */
+  pl_existence_poller = Pl_Create_Atom("poller"); /* for pollers */
 
 
   pl_permission_operation_access = Pl_Create_Atom("access");
@@ -230,6 +240,8 @@ Error_Supp_Initializer(void)
   pl_representation_integer_32bits = Pl_Create_Atom("integer_32bits");
   pl_representation_too_many_variables = Pl_Create_Atom("too_many_variables");
 				/* for Pl_Copy_Term(),... */
+  pl_representation_cyclic_term = Pl_Create_Atom("cyclic_term");
+				/* for fast term records */
 
   pl_evaluation_float_overflow = Pl_Create_Atom("float_overflow");
   pl_evaluation_int_overflow = Pl_Create_Atom("int_overflow");
@@ -240,6 +252,9 @@ Error_Supp_Initializer(void)
 
   pl_resource_print_object_not_linked = Pl_Create_Atom("print_object_not_linked");
 				/* for print and format */
+  pl_resource_too_many_variables = Pl_Create_Atom("too_many_variables");
+  pl_resource_too_big_term = Pl_Create_Atom("too_big_term");
+				/* for fast term records */
   if (pl_fd_init_solver)		/* FD solver linked */
     {
       pl_resource_too_big_fd_constraint = Pl_Create_Atom("too_big_fd_constraint");
@@ -98,16 +98,23 @@ int pl_domain_format_control_sequence;		/* for format/2-3 */
 int pl_domain_os_path;				/* for absolute_file_name/2 */
 int pl_domain_os_file_permission;		/* for file_permission/2 */
 int pl_domain_selectable_item;			/* for select_read/3 */
+int pl_domain_poll_event;			/* for pollers */
 int pl_domain_date_time;			/* for os_interf */
 #ifndef NO_USE_SOCKETS
 int pl_domain_socket_domain;			/* for sockets */
 int pl_domain_socket_address;			/* for sockets */
+int pl_domain_ordered_map;			/* for ordered maps */
+int pl_domain_g_num_type;			/* for numeric arrays */
 #endif
 
 int pl_existence_procedure;
 int pl_existence_source_sink;
 int pl_existence_stream;
 int pl_existence_sr_descriptor;			/* for source reader */
+int pl_existence_fact_store;			/* for fact stores */
+int pl_existence_hash_table;			/* for hash tables */
+int pl_existence_g_num_array;			/* for numeric arrays */
+int pl_existence_poller;			/* for pollers */
 
 int pl_permission_operation_access;
 int pl_permission_operation_close;
@@ -138,6 +145,7 @@ int pl_representation_max_integer;
 int pl_representation_min_integer;
 int pl_representation_integer_32bits;
 int pl_representation_too_many_variables;	/* for Pl_Copy_Term(),... */
+int pl_representation_cyclic_term;		/* for fast term records */
 
 int pl_evaluation_float_overflow;
 int pl_evaluation_int_overflow;
@@ -148,6 +156,8 @@ int pl_evaluation_zero_divisor;
 
 int pl_resource_print_object_not_linked; 	/* for print and format */
 int pl_resource_too_big_fd_constraint; 		/* for FD */
+int pl_resource_too_many_variables; 		/* for fast term records */
+int pl_resource_too_big_term; 			/* for fast term records */
 
 
 #else
@@ -201,10 +211,13 @@ extern int pl_domain_format_control_sequence;	/* for format/2-3 */
 extern int pl_domain_os_path;			/* for absolute_file_name/2 */
 extern int pl_domain_os_file_permission; 	/* for file_permission/2 */
 extern int pl_domain_selectable_item; 		/* for select_read/3 */
+extern int pl_domain_poll_event;		/* for pollers */
 extern int pl_domain_date_time;			/* for os_interf */
 #ifndef NO_USE_SOCKETS
 extern int pl_domain_socket_domain; 		/* for sockets */
 extern int pl_domain_socket_address; 		/* for sockets */
+extern int pl_domain_ordered_map; 		/* for ordered maps */
+extern int pl_domain_g_num_type; 		/* for numeric arrays */
 #endif
 
 
@@ -212,6 +225,10 @@ extern int pl_existence_procedure;
 extern int pl_existence_source_sink;
 extern int pl_existence_stream;
 extern int pl_existence_sr_descriptor; 		/* for source reader */
+extern int pl_existence_fact_store; 		/* for fact stores */
+extern int pl_existence_hash_table; 		/* for hash tables */
+extern int pl_existence_g_num_array; 		/* for numeric arrays */
+extern int pl_existence_poller;			/* for pollers */
 
 
 extern int pl_permission_operation_access;
@@ -243,6 +260,7 @@ extern int pl_representation_max_integer;
 extern int pl_representation_min_integer;
 extern int pl_representation_integer_32bits;
 extern int pl_representation_too_many_variables;/* for Pl_Copy_Term(),... */
+extern int pl_representation_cyclic_term;	/* for fast term records */
 
 
 extern int pl_evaluation_float_overflow;
@@ -255,6 +273,8 @@ extern int pl_evaluation_zero_divisor;
 extern int resource_too_many_open_streams; 	/* for streams */
 extern int pl_resource_print_object_not_linked; /* for print and format */
 extern int pl_resource_too_big_fd_constraint; 	/* for FD */
+extern int pl_resource_too_many_variables; 	/* for fast term records */
+extern int pl_resource_too_big_term; 		/* for fast term records */
 
 #endif
 
@@ -0,0 +1,104 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : fact_store.pl                                                   *
+ * Descr.: memory-mapped fact stores                                       *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_fact_store'.
+
+
+
+fact_store_create(File, Template, Goal) :-
+	set_bip_name(fact_store_create, 3),
+	(   g_read('$fact_store_creating', 0) ->
+	    true
+	;   '$pl_err_permission'(create, fact_store, File)   % nested creation
+	),
+	'$call_c'('Pl_Fact_Store_Create_Begin_2'(File, Template)),
+	g_assignb('$fact_store_creating', 1),
+	'$catch'('$fact_store_create'(Template, Goal), Err,
+		 '$fact_store_create_abort'(Err), fact_store_create, 3, false),
+	g_assignb('$fact_store_creating', 0).
+
+
+'$fact_store_create'(Template, Goal) :-
+	(   '$call'(Goal, fact_store_create, 3, true),
+	    set_bip_name(fact_store_create, 3),
+	    '$call_c'('Pl_Fact_Store_Create_Add_1'(Template)),
+	    fail
+	;   set_bip_name(fact_store_create, 3),
+	    '$call_c_test'('Pl_Fact_Store_Create_End_0')
+	).
+
+
+'$fact_store_create_abort'(Err) :-
+	'$call_c'('Pl_Fact_Store_Create_Abort_0'),
+	throw(Err).
+
+
+
+
+fact_store_open(File, Store) :-
+	set_bip_name(fact_store_open, 2),
+	'$call_c_test'('Pl_Fact_Store_Open_3'(File, Store, _)).
+
+
+
+
+fact_store_close(Store) :-
+	set_bip_name(fact_store_close, 1),
+	'$call_c'('Pl_Fact_Store_Close_1'(Store)).
+
+
+
+
+fact_store_call(Store, Term) :-
+	set_bip_name(fact_store_call, 2),
+	'$call_c_test'('Pl_Fact_Store_Call_2'(Store, Term)).
+
+
+'$fact_store_call_alt' :-           % used by C code to create a choice-point
+	'$call_c_test'('Pl_Fact_Store_Call_Alt_0').
+
+
+
+
+fact_store_attach(File, Store) :-
+	set_bip_name(fact_store_attach, 2),
+	'$call_c_test'('Pl_Fact_Store_Open_3'(File, Store, Head)),
+	retractall(Head),
+	assertz((Head :- fact_store_call(Store, Head))).
@@ -0,0 +1,1401 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : fact_store_c.c                                                  *
+ * Descr.: memory-mapped fact stores - C part                              *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "gp_config.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define FACT_STORE_MAGIC           "GPFSTORE"
+#define FACT_STORE_VERSION         1
+#define FACT_STORE_ENDIAN          0x01020304
+
+#define FS_ATM                     1
+#define FS_INT                     2
+#define FS_FLT                     3
+
+#define FS_INIT_NB_TUPLE           1024
+#define FS_MAX_NB_TUPLE            (1 << 30)
+
+#define ERR_BUILD_ALLOC_FAULT      "Memory allocation fault (fact_store_create/3)"
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct			/* file header (followed by columns) */
+{				/* ------------------------------- */
+  char magic[8];		/* FACT_STORE_MAGIC                */
+  int32_t endian;		/* FACT_STORE_ENDIAN (native order) */
+  int32_t version;		/* FACT_STORE_VERSION              */
+  int64_t arity;		/* arity of the predicate          */
+  int64_t name;			/* atom no of the predicate name   */
+  int64_t nb_tuple;		/* number of tuples                */
+  int64_t nb_atom;		/* number of atoms (dictionary)    */
+  int64_t atom_ofs;		/* nb_atom+1 offsets of atom names */
+  int64_t atom_hash_ofs;	/* atom hash table (atom no + 1)   */
+  int64_t atom_hash_size;	/* its size (a power of 2)         */
+  int64_t file_size;		/* size of the whole file          */
+}
+FSHeader;
+
+
+typedef struct			/* column (one per argument)       */
+{				/* ------------------------------- */
+  int64_t type_ofs;		/* nb_tuple types (FS_ATM,...)     */
+  int64_t val_ofs;		/* nb_tuple values (atom no,...)   */
+  int64_t perm_ofs;		/* nb_tuple tuple nos sorted by val */
+  int64_t hash_ofs;		/* hash table of distinct values   */
+  int64_t hash_size;		/* its size (a power of 2)         */
+}
+FSColumn;
+
+
+typedef struct			/* entry of a column hash table    */
+{				/* ------------------------------- */
+  int64_t key;			/* value (normalized for floats)   */
+  int32_t type;			/* FS_ATM,... (0 if free entry)    */
+  int32_t start;		/* 1st position in the perm array  */
+  int32_t nb;			/* nb of tuples having this value  */
+  int32_t pad;			/* unused (alignment)              */
+}
+FSBucket;
+
+
+typedef struct			/* an opened fact store            */
+{				/* ------------------------------- */
+  Bool in_use;			/* is this entry used ?            */
+  int stamp;			/* identifies this use of the slot */
+  char *base;			/* address of the mapped file      */
+  size_t size;			/* size of the mapped file         */
+  FSHeader *hdr;		/* header (at base)                */
+  FSColumn *col;		/* columns (after the header)      */
+  char **type;			/* type array of each column       */
+  int64_t **val;		/* value array of each column      */
+  int func;			/* predicate name (prolog atom)    */
+  int arity;			/* predicate arity                 */
+  int nb_tuple;			/* number of tuples                */
+  int *atom;			/* atom no -> prolog atom (or -1)  */
+}
+FactStore;
+
+
+typedef struct			/* dictionary atom (when building) */
+{				/* ------------------------------- */
+  PlLong key;			/* prolog atom                     */
+  int no;			/* its no in the dictionary        */
+}
+FSAtom;
+
+
+typedef struct			/* fact store being created        */
+{				/* ------------------------------- */
+  FILE *f;			/* output file (NULL if none)      */
+  char *path;			/* its path (mallocated)           */
+  int64_t pos;			/* current position in the file    */
+  int func;			/* predicate name                  */
+  int arity;			/* predicate arity                 */
+  int nb_tuple;			/* number of tuples added          */
+  int max_tuple;		/* allocated number of tuples      */
+  char *type;			/* types (tuple by tuple)          */
+  int64_t *val;			/* values (tuple by tuple)         */
+  char *atom_htbl;		/* prolog atom -> FSAtom           */
+  int nb_atom;			/* number of atoms                 */
+  int max_atom;			/* allocated number of atoms       */
+  int *atom;			/* atom no -> prolog atom          */
+}
+FSBuild;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static FactStore *fs_tbl = NULL;	/* table (mallocated) */
+static int fs_tbl_size = 0;		/* allocated size */
+static int fs_stamp = 0;
+
+static FSBuild fsb;
+
+static char *sort_type;		/* column being sorted */
+static int64_t *sort_val;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static char *Get_Path(WamWord file_word);
+
+static FactStore *Get_Store(WamWord store_word);
+
+static char *Map_File(char *path, size_t *size);
+
+static void Unmap_File(char *base, size_t size);
+
+static Bool Check_Header(FactStore *fs);
+
+static int64_t Float_Key(double d);
+
+static double Key_Float(int64_t key);
+
+static uint32_t Value_Hash(int type, int64_t key);
+
+static int Store_Atom(FactStore *fs, int64_t no);
+
+static int64_t Find_Atom(FactStore *fs, int atom);
+
+static FSBucket *Find_Value(FactStore *fs, int i, int type, int64_t key);
+
+static WamWord Store_Value(FactStore *fs, int i, int t);
+
+static Bool Match_Arg(FactStore *fs, int i, int t, WamWord word,
+		      WamWord tag_mask);
+
+static int Next_Tuple(FactStore *fs, WamWord *arg_adr, int32_t *perm,
+		      int j, int nb);
+
+void Pl_Fact_Store_Create_Abort_0(void);
+
+static Bool Unify_Tuple(FactStore *fs, WamWord *arg_adr, int t);
+
+static int Build_Atom(int atom);
+
+static void Build_Free(void);
+
+static char *Build_Realloc(char *ptr, size_t size);
+
+static void Build_Write(void *p, size_t size);
+
+static void Build_Align(void);
+
+static void Build_Column(int i, FSColumn *col);
+
+static int Compare_Tuples(const void *p1, const void *p2);
+
+
+
+#define FACT_STORE_CALL_ALT        X1_24666163745F73746F72655F63616C6C5F616C74
+
+Prolog_Prototype(FACT_STORE_CALL_ALT, 0);
+
+
+#define Is_A_Variable(tag_mask)    (tag_mask == TAG_REF_MASK || tag_mask == TAG_FDV_MASK)
+
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A fact store is a read-only file holding the tuples of a relation whose *
+ * arguments are atoms, integers or floats. It is created once with        *
+ * fact_store_create/3 and then mapped in memory by fact_store_open/2: the *
+ * tuples are never copied, calls read them directly from the mapped pages *
+ * (processes using the same file thus share the page cache).             *
+ *                                                                         *
+ * The file contains a header, one column per argument (a type array and a *
+ * value array), a dictionary for the atoms (a value of type FS_ATM is an  *
+ * atom no) and, for each column, an index: the tuple nos sorted by value  *
+ * (perm array) and a hash table giving for each distinct value its range  *
+ * in the perm array. All sections are 8-byte aligned.                     *
+ *                                                                         *
+ * fact_store_call/2 selects the bound argument with the fewest tuples and *
+ * scans them (or all tuples if no argument is bound) like the dynamic     *
+ * clause scanning (see dynam_supp.c): a choice-point is only created if   *
+ * another tuple matches. It records the store, the address of the args,   *
+ * the candidate array (NULL: all tuples), its size and the position of    *
+ * the next matching candidate.                                            *
+ * Dictionary atoms are only created (in the atom table) when they are     *
+ * returned in a solution.                                                 *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CREATE_BEGIN_2                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fact_Store_Create_Begin_2(WamWord file_word, WamWord template_word)
+{
+  char *path;
+  int func, arity;
+
+  path = Get_Path(file_word);
+  Pl_Rd_Callable_Check(template_word, &func, &arity);
+
+  Pl_Fact_Store_Create_Abort_0(); /* due to a previous abort/0 in Goal */
+
+  fsb.path = Strdup(path);
+  fsb.f = fopen(path, "wb");
+  if (fsb.f == NULL)
+    {
+      if (errno == ENOENT || errno == ENOTDIR)
+	Pl_Err_Existence(pl_existence_source_sink, file_word);
+      else
+	Pl_Err_Permission(pl_permission_operation_open,
+			  pl_permission_type_source_sink, file_word);
+    }
+
+  fsb.pos = 0;
+  fsb.func = func;
+  fsb.arity = arity;
+  fsb.nb_tuple = 0;
+  fsb.max_tuple = FS_INIT_NB_TUPLE;
+  fsb.type = Build_Realloc(NULL, (size_t) fsb.max_tuple * arity);
+  fsb.val = (int64_t *) Build_Realloc(NULL, (size_t) fsb.max_tuple * arity *
+				      sizeof(int64_t));
+  fsb.atom_htbl = Pl_Hash_Alloc_Table(256, sizeof(FSAtom));
+  fsb.nb_atom = 0;
+  fsb.max_atom = 256;
+  fsb.atom = (int *) Malloc(fsb.max_atom * sizeof(int));
+
+  Build_Atom(func);		/* the name is the atom no 0 */
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CREATE_ADD_1                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fact_Store_Create_Add_1(WamWord template_word)
+{
+  WamWord word, tag_mask;
+  WamWord *arg_adr;
+  int func, arity;
+  char *type;
+  int64_t *val;
+  int i;
+  union
+  {
+    double d;
+    int64_t i;
+  }
+  u;
+
+  arg_adr = Pl_Rd_Callable_Check(template_word, &func, &arity);
+
+  if (fsb.nb_tuple == fsb.max_tuple)
+    {
+      if (fsb.max_tuple >= FS_MAX_NB_TUPLE)
+	Pl_Err_Representation(pl_representation_max_integer);
+
+      fsb.max_tuple *= 2;
+      fsb.type = (char *) Build_Realloc(fsb.type, (size_t) fsb.max_tuple * arity);
+      fsb.val = (int64_t *) Build_Realloc((char *) fsb.val, (size_t) fsb.max_tuple *
+					  arity * sizeof(int64_t));
+    }
+
+  type = fsb.type + fsb.nb_tuple * arity;
+  val = fsb.val + fsb.nb_tuple * arity;
+
+  for (i = 0; i < arity; i++)
+    {
+      DEREF(arg_adr[i], word, tag_mask);
+      switch (Tag_From_Tag_Mask(tag_mask))
+	{
+	case ATM:
+	  type[i] = FS_ATM;
+	  val[i] = Build_Atom(UnTag_ATM(word));
+	  break;
+
+	case INT:
+	  type[i] = FS_INT;
+	  val[i] = UnTag_INT(word);
+	  break;
+
+	case FLT:
+	  type[i] = FS_FLT;
+	  u.d = Pl_Obtain_Float(UnTag_FLT(word));
+	  val[i] = u.i;
+	  break;
+
+	case REF:
+	case FDV:
+	  Pl_Err_Instantiation();
+	  break;
+
+	default:
+	  Pl_Err_Type(pl_type_atomic, word);
+	}
+    }
+
+  fsb.nb_tuple++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CREATE_END_0                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fact_Store_Create_End_0(void)
+{
+  FSHeader hdr;
+  FSColumn *col;
+  int64_t ofs, size;
+  int32_t *htbl;
+  char *name;
+  uint32_t h;
+  int arity = fsb.arity;
+  int i, ret;
+
+  if (fsb.f == NULL)
+    return FALSE;
+
+  col = (FSColumn *) Calloc(arity + 1, sizeof(FSColumn));
+  memset(&hdr, 0, sizeof(hdr));
+
+  Build_Write(&hdr, sizeof(hdr));	/* rewritten at the end */
+  Build_Write(col, arity * sizeof(FSColumn));
+  Build_Align();
+
+				/* atom dictionary */
+  hdr.atom_ofs = fsb.pos;
+  ofs = fsb.pos + (fsb.nb_atom + 1) * sizeof(int64_t);
+  for (i = 0; i <= fsb.nb_atom; i++)
+    {
+      Build_Write(&ofs, sizeof(int64_t));
+      if (i < fsb.nb_atom)
+	ofs += strlen(pl_atom_tbl[fsb.atom[i]].name) + 1;
+    }
+
+  for (i = 0; i < fsb.nb_atom; i++)
+    {
+      name = pl_atom_tbl[fsb.atom[i]].name;
+      Build_Write(name, strlen(name) + 1);
+    }
+  Build_Align();
+
+  for (size = 2; size < 2 * (int64_t) fsb.nb_atom; size *= 2)
+    ;
+  htbl = (int32_t *) Calloc(size, sizeof(int32_t));
+  for (i = 0; i < fsb.nb_atom; i++)
+    {
+      name = pl_atom_tbl[fsb.atom[i]].name;
+      h = Pl_Hash_Buffer(name, strlen(name)) & (size - 1);
+      while (htbl[h] != 0)
+	h = (h + 1) & (size - 1);
+      htbl[h] = i + 1;
+    }
+
+  hdr.atom_hash_ofs = fsb.pos;
+  hdr.atom_hash_size = size;
+  Build_Write(htbl, size * sizeof(int32_t));
+  Build_Align();
+  Free(htbl);
+
+  for (i = 0; i < arity; i++)
+    Build_Column(i, col + i);
+
+  memcpy(hdr.magic, FACT_STORE_MAGIC, sizeof(hdr.magic));
+  hdr.endian = FACT_STORE_ENDIAN;
+  hdr.version = FACT_STORE_VERSION;
+  hdr.arity = arity;
+  hdr.name = 0;
+  hdr.nb_tuple = fsb.nb_tuple;
+  hdr.nb_atom = fsb.nb_atom;
+  hdr.file_size = fsb.pos;
+
+  fseek(fsb.f, 0, SEEK_SET);
+  Build_Write(&hdr, sizeof(hdr));
+  Build_Write(col, arity * sizeof(FSColumn));
+  Free(col);
+
+  ret = ferror(fsb.f);
+  ret |= fclose(fsb.f);
+  fsb.f = NULL;
+  Build_Free();
+
+  if (ret != 0)
+    {
+      Pl_Os_Error(-1);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CREATE_ABORT_0                                            *
+ *                                                                         *
+ * Called when the creation is interrupted by an exception: the partially  *
+ * written file is removed.                                                *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fact_Store_Create_Abort_0(void)
+{
+  if (fsb.f)
+    {
+      fclose(fsb.f);
+      fsb.f = NULL;
+      remove(fsb.path);
+    }
+
+  Build_Free();
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_COLUMN                                                            *
+ *                                                                         *
+ * Write the values of the ith arg and its index.                          *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Column(int i, FSColumn *col)
+{
+  int arity = fsb.arity;
+  int nb_tuple = fsb.nb_tuple;
+  int32_t *perm;
+  FSBucket *htbl, *b;
+  int64_t key, size, nb_key;
+  uint32_t h;
+  int t, j, type;
+
+  sort_type = Build_Realloc(NULL, nb_tuple);
+  sort_val = (int64_t *) Build_Realloc(NULL, nb_tuple * sizeof(int64_t));
+  perm = (int32_t *) Build_Realloc(NULL, nb_tuple * sizeof(int32_t));
+
+  for (t = 0; t < nb_tuple; t++)
+    {
+      sort_type[t] = fsb.type[(size_t) t * arity + i];
+      sort_val[t] = fsb.val[(size_t) t * arity + i];
+      perm[t] = t;
+    }
+
+  qsort(perm, nb_tuple, sizeof(int32_t), Compare_Tuples);
+
+  col->type_ofs = fsb.pos;
+  Build_Write(sort_type, nb_tuple);
+  Build_Align();
+
+  col->val_ofs = fsb.pos;
+  Build_Write(sort_val, nb_tuple * sizeof(int64_t));
+
+  col->perm_ofs = fsb.pos;
+  Build_Write(perm, nb_tuple * sizeof(int32_t));
+  Build_Align();
+
+  nb_key = 0;
+  for (j = 0; j < nb_tuple; j++)
+    if (j == 0 || Compare_Tuples(perm + j - 1, perm + j) != 0)
+      nb_key++;
+
+  for (size = 2; size < nb_key + nb_key / 3 + 1; size *= 2)
+    ;				/* load factor <= 3/4 */
+  htbl = (FSBucket *) Build_Realloc(NULL, size * sizeof(FSBucket));
+  memset(htbl, 0, size * sizeof(FSBucket));
+
+  b = NULL;
+  for (j = 0; j < nb_tuple; j++)
+    {
+      t = perm[j];
+      type = sort_type[t];
+      key = (type == FS_FLT) ? Float_Key(Key_Float(sort_val[t])) : sort_val[t];
+      if (b && b->type == type && b->key == key)
+	{
+	  b->nb++;
+	  continue;
+	}
+
+      h = Value_Hash(type, key) & (size - 1);
+      while (htbl[h].type != 0)
+	h = (h + 1) & (size - 1);
+
+      b = htbl + h;
+      b->key = key;
+      b->type = type;
+      b->start = j;
+      b->nb = 1;
+    }
+
+  col->hash_ofs = fsb.pos;
+  col->hash_size = size;
+  Build_Write(htbl, size * sizeof(FSBucket));
+
+  free(htbl);
+  free(perm);
+  free(sort_val);
+  free(sort_type);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPARE_TUPLES                                                          *
+ *                                                                         *
+ * Order on the tuple nos of the column being sorted: by type, by value    *
+ * then by tuple no (equal values are consecutive in the clause order).    *
+ *-------------------------------------------------------------------------*/
+static int
+Compare_Tuples(const void *p1, const void *p2)
+{
+  int t1 = *(int32_t *) p1;
+  int t2 = *(int32_t *) p2;
+  double d1, d2;
+  int cmp;
+
+  cmp = sort_type[t1] - sort_type[t2];
+  if (cmp != 0)
+    return cmp;
+
+  if (sort_type[t1] == FS_FLT)
+    {
+      d1 = Key_Float(sort_val[t1]);
+      d2 = Key_Float(sort_val[t2]);
+      cmp = (d1 > d2) - (d1 < d2);
+    }
+  else
+    cmp = (sort_val[t1] > sort_val[t2]) - (sort_val[t1] < sort_val[t2]);
+
+  return (cmp != 0) ? cmp : (t1 > t2) - (t1 < t2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_ATOM                                                              *
+ *                                                                         *
+ * Return the dictionary no of a prolog atom (added if needed).            *
+ *-------------------------------------------------------------------------*/
+static int
+Build_Atom(int atom)
+{
+  FSAtom a, *p;
+
+  p = (FSAtom *) Pl_Hash_Find(fsb.atom_htbl, atom);
+  if (p != NULL)
+    return p->no;
+
+  if (fsb.nb_atom >= Pl_Hash_Table_Size(fsb.atom_htbl))
+    fsb.atom_htbl = Pl_Hash_Realloc_Table(fsb.atom_htbl,
+					  Pl_Hash_Table_Size(fsb.atom_htbl) * 2);
+
+  if (fsb.nb_atom == fsb.max_atom)
+    Pl_Extend_Array((char **) &fsb.atom, &fsb.max_atom, sizeof(int), FALSE);
+
+  a.key = atom;
+  a.no = fsb.nb_atom;
+  Pl_Hash_Insert(fsb.atom_htbl, (char *) &a, FALSE);
+  fsb.atom[fsb.nb_atom] = atom;
+
+  return fsb.nb_atom++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_FREE                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Free(void)
+{
+  if (fsb.f)
+    fclose(fsb.f);
+  fsb.f = NULL;
+
+  if (fsb.type)
+    free(fsb.type);
+  fsb.type = NULL;
+
+  if (fsb.val)
+    free(fsb.val);
+  fsb.val = NULL;
+
+  if (fsb.atom_htbl)
+    Pl_Hash_Free_Table(fsb.atom_htbl);
+  fsb.atom_htbl = NULL;
+
+  if (fsb.atom)
+    Free(fsb.atom);
+  fsb.atom = NULL;
+
+  if (fsb.path)
+    Free(fsb.path);
+  fsb.path = NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_REALLOC                                                           *
+ *                                                                         *
+ * Like Realloc but accepts sizes > 4Gb (+1 since the arity can be 0).     *
+ *-------------------------------------------------------------------------*/
+static char *
+Build_Realloc(char *ptr, size_t size)
+{
+  char *m = realloc(ptr, size + 1);
+
+  if (m == NULL)
+    Pl_Fatal_Error(ERR_BUILD_ALLOC_FAULT);
+
+  return m;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_WRITE                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Write(void *p, size_t size)
+{
+  fwrite(p, 1, size, fsb.f);
+  fsb.pos += size;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_ALIGN                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Align(void)
+{
+  static char zero[8];
+
+  Build_Write(zero, (-fsb.pos) & 7);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_OPEN_3                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fact_Store_Open_3(WamWord file_word, WamWord store_word,
+		     WamWord head_word)
+{
+  FactStore *fs;
+  char *path, *base;
+  size_t size = 0;		/* init for the compiler */
+  int desc, i;
+
+  path = Get_Path(file_word);
+  Pl_Check_For_Un_Variable(store_word);
+
+  base = Map_File(path, &size);
+  if (base == NULL)
+    {
+      if (errno == ENOENT || errno == ENOTDIR)
+	Pl_Err_Existence(pl_existence_source_sink, file_word);
+      else
+	Pl_Err_Permission(pl_permission_operation_open,
+			  pl_permission_type_source_sink, file_word);
+    }
+
+  if (fs_tbl == NULL)		/* first allocation */
+    {
+      fs_tbl_size = 8;
+      fs_tbl = (FactStore *) Calloc(fs_tbl_size, sizeof(FactStore));
+    }
+
+  for (desc = 0; desc < fs_tbl_size; desc++)
+    if (!fs_tbl[desc].in_use)
+      break;
+
+  if (desc == fs_tbl_size)
+    Pl_Extend_Array((char **) &fs_tbl, &fs_tbl_size, sizeof(FactStore), TRUE);
+
+  fs = fs_tbl + desc;
+  fs->base = base;
+  fs->size = size;
+  fs->hdr = (FSHeader *) base;
+  fs->col = (FSColumn *) (fs->hdr + 1);
+
+  if (!Check_Header(fs))
+    {
+      Unmap_File(base, size);
+      Pl_Err_Permission(pl_permission_operation_open,
+			pl_permission_type_source_sink, file_word);
+    }
+
+  fs->arity = fs->hdr->arity;
+  fs->nb_tuple = fs->hdr->nb_tuple;
+  fs->type = (char **) Malloc((fs->arity + 1) * sizeof(char *));
+  fs->val = (int64_t **) Malloc((fs->arity + 1) * sizeof(int64_t *));
+  for (i = 0; i < fs->arity; i++)
+    {
+      fs->type[i] = base + fs->col[i].type_ofs;
+      fs->val[i] = (int64_t *) (base + fs->col[i].val_ofs);
+    }
+
+  fs->atom = (int *) Malloc(fs->hdr->nb_atom * sizeof(int));
+  for (i = 0; i < fs->hdr->nb_atom; i++)
+    fs->atom[i] = -1;
+
+  fs->func = Store_Atom(fs, fs->hdr->name);
+  fs->in_use = TRUE;
+  fs->stamp = ++fs_stamp;
+
+  if (fs->arity == 0)
+    Pl_Get_Atom(fs->func, head_word);
+  else
+    {
+      Pl_Get_Structure(fs->func, fs->arity, head_word);
+      Pl_Unify_Void(fs->arity);
+    }
+
+  return Pl_Get_Integer(desc, store_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CHECK_HEADER                                                            *
+ *                                                                         *
+ * Check that a mapped file is a valid fact store for this machine.        *
+ *-------------------------------------------------------------------------*/
+static Bool
+Check_Header(FactStore *fs)
+{
+  FSHeader *hdr = fs->hdr;
+  int64_t size = (int64_t) fs->size;
+  FSColumn *col;
+  int i;
+
+  if (size < (int64_t) sizeof(FSHeader) ||
+      memcmp(hdr->magic, FACT_STORE_MAGIC, sizeof(hdr->magic)) != 0 ||
+      hdr->endian != FACT_STORE_ENDIAN || hdr->version != FACT_STORE_VERSION ||
+      hdr->file_size != size || hdr->arity < 0 || hdr->arity > MAX_ARITY ||
+      hdr->nb_tuple < 0 || hdr->nb_tuple > FS_MAX_NB_TUPLE ||
+      hdr->nb_atom <= hdr->name || hdr->name < 0 ||
+      hdr->atom_ofs + (hdr->nb_atom + 1) * (int64_t) sizeof(int64_t) > size ||
+      hdr->atom_hash_ofs + hdr->atom_hash_size * (int64_t) sizeof(int32_t) > size ||
+      (int64_t) (sizeof(FSHeader) + hdr->arity * sizeof(FSColumn)) > size)
+    return FALSE;
+
+  for (i = 0; i < hdr->arity; i++)
+    {
+      col = fs->col + i;
+      if (col->type_ofs + hdr->nb_tuple > size ||
+	  col->val_ofs + hdr->nb_tuple * (int64_t) sizeof(int64_t) > size ||
+	  col->perm_ofs + hdr->nb_tuple * (int64_t) sizeof(int32_t) > size ||
+	  col->hash_ofs + col->hash_size * (int64_t) sizeof(FSBucket) > size)
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CLOSE_1                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fact_Store_Close_1(WamWord store_word)
+{
+  FactStore *fs = Get_Store(store_word);
+
+  Unmap_File(fs->base, fs->size);
+  Free(fs->type);
+  Free(fs->val);
+  Free(fs->atom);
+  fs->in_use = FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CALL_2                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fact_Store_Call_2(WamWord store_word, WamWord term_word)
+{
+  WamWord word, tag_mask;
+  FactStore *fs;
+  WamWord *arg_adr;
+  int func, arity;
+  FSBucket *b, *best = NULL;
+  int32_t *perm = NULL;		/* NULL: all tuples are candidates */
+  int nb, i, j, j1;
+  int64_t no;
+
+  fs = Get_Store(store_word);
+
+  DEREF(term_word, word, tag_mask);
+  if (tag_mask == TAG_REF_MASK)	/* unify with Name(_,...,_) */
+    {
+      if (fs->arity == 0)
+	Pl_Get_Atom(fs->func, word);
+      else
+	{
+	  Pl_Get_Structure(fs->func, fs->arity, word);
+	  Pl_Unify_Void(fs->arity);
+	}
+    }
+
+  arg_adr = Pl_Rd_Callable_Check(term_word, &func, &arity);
+  if (func != fs->func || arity != fs->arity)
+    return FALSE;
+
+  nb = fs->nb_tuple;
+  for (i = 0; i < arity; i++)
+    {
+      DEREF(arg_adr[i], word, tag_mask);
+      switch (Tag_From_Tag_Mask(tag_mask))
+	{
+	case REF:
+	case FDV:
+	  continue;
+
+	case ATM:
+	  no = Find_Atom(fs, UnTag_ATM(word));
+	  if (no < 0)
+	    return FALSE;
+	  b = Find_Value(fs, i, FS_ATM, no);
+	  break;
+
+	case INT:
+	  b = Find_Value(fs, i, FS_INT, UnTag_INT(word));
+	  break;
+
+	case FLT:
+	  b = Find_Value(fs, i, FS_FLT,
+			 Float_Key(Pl_Obtain_Float(UnTag_FLT(word))));
+	  break;
+
+	default:
+	  return FALSE;
+	}
+
+      if (b == NULL)
+	return FALSE;
+
+      if (best == NULL || b->nb < best->nb)
+	{
+	  best = b;
+	  perm = (int32_t *) (fs->base + fs->col[i].perm_ofs) + b->start;
+	  nb = b->nb;
+	}
+    }
+
+  j = Next_Tuple(fs, arg_adr, perm, 0, nb);
+  if (j == nb)
+    return FALSE;
+
+  j1 = Next_Tuple(fs, arg_adr, perm, j + 1, nb);
+  if (j1 < nb)
+    {				/* non deterministic case */
+      A(0) = fs - fs_tbl;
+      A(1) = (WamWord) arg_adr;
+      A(2) = (WamWord) perm;
+      A(3) = nb;
+      A(4) = j1;
+      A(5) = fs->stamp;
+      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(FACT_STORE_CALL_ALT, 0),
+			     6);
+    }
+
+  return Unify_Tuple(fs, arg_adr, (perm) ? perm[j] : j);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_STORE_CALL_ALT_0                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fact_Store_Call_Alt_0(void)
+{
+  FactStore *fs;
+  WamWord *arg_adr;
+  int32_t *perm;
+  int nb, j, j1;
+
+  Pl_Update_Choice_Point((CodePtr) Prolog_Predicate(FACT_STORE_CALL_ALT, 0),
+			 0);
+
+  fs = fs_tbl + AB(B, 0);
+  arg_adr = (WamWord *) AB(B, 1);
+  perm = (int32_t *) AB(B, 2);
+  nb = AB(B, 3);
+  j = AB(B, 4);
+
+  if (!fs->in_use || fs->stamp != AB(B, 5))	/* closed meanwhile */
+    {
+      Delete_Last_Choice_Point();
+      return FALSE;
+    }
+
+  j1 = Next_Tuple(fs, arg_adr, perm, j + 1, nb);
+  if (j1 < nb)
+    AB(B, 4) = j1;
+  else
+    Delete_Last_Choice_Point();
+
+  return Unify_Tuple(fs, arg_adr, (perm) ? perm[j] : j);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * NEXT_TUPLE                                                              *
+ *                                                                         *
+ * Return the position (>= j) of the next candidate matching the bound     *
+ * args or nb if none.                                                     *
+ *-------------------------------------------------------------------------*/
+static int
+Next_Tuple(FactStore *fs, WamWord *arg_adr, int32_t *perm, int j, int nb)
+{
+  WamWord word, tag_mask;
+  int arity = fs->arity;
+  int i, t;
+
+  for (; j < nb; j++)
+    {
+      t = (perm) ? perm[j] : j;
+      for (i = 0; i < arity; i++)
+	{
+	  DEREF(arg_adr[i], word, tag_mask);
+	  if (!Is_A_Variable(tag_mask) && !Match_Arg(fs, i, t, word, tag_mask))
+	    break;
+	}
+
+      if (i == arity)
+	break;
+    }
+
+  return j;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UNIFY_TUPLE                                                             *
+ *                                                                         *
+ * Unify the args with the values of the tuple t.                          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Unify_Tuple(FactStore *fs, WamWord *arg_adr, int t)
+{
+  WamWord word, tag_mask;
+  int arity = fs->arity;
+  int i;
+
+  for (i = 0; i < arity; i++)
+    {
+      DEREF(arg_adr[i], word, tag_mask);
+      if (Is_A_Variable(tag_mask))
+	{
+	  if (!Pl_Unify(Store_Value(fs, i, t), word))
+	    return FALSE;
+	}
+      else if (!Match_Arg(fs, i, t, word, tag_mask))	/* e.g. p(X,X) */
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MATCH_ARG                                                               *
+ *                                                                         *
+ * Does the ith value of the tuple t match the (non variable) word ?       *
+ * NB: an atom of the dictionary whose prolog atom is not yet known cannot *
+ * be equal to word (Find_Atom records the atom of bound args).            *
+ *-------------------------------------------------------------------------*/
+static Bool
+Match_Arg(FactStore *fs, int i, int t, WamWord word, WamWord tag_mask)
+{
+  int type = fs->type[i][t];
+  int64_t val = fs->val[i][t];
+
+  switch (Tag_From_Tag_Mask(tag_mask))
+    {
+    case ATM:
+      return type == FS_ATM && fs->atom[val] == (int) UnTag_ATM(word);
+
+    case INT:
+      return type == FS_INT && val == UnTag_INT(word);
+
+    case FLT:
+      return type == FS_FLT &&
+	Key_Float(val) == Pl_Obtain_Float(UnTag_FLT(word));
+    }
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STORE_VALUE                                                             *
+ *                                                                         *
+ * Return (as a WAM word) the ith value of the tuple t.                    *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Store_Value(FactStore *fs, int i, int t)
+{
+  int64_t val = fs->val[i][t];
+
+  switch (fs->type[i][t])
+    {
+    case FS_ATM:
+      return Tag_ATM(Store_Atom(fs, val));
+
+    case FS_INT:
+      return Tag_INT(val);
+    }
+
+  return Pl_Put_Float(Key_Float(val));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STORE_ATOM                                                              *
+ *                                                                         *
+ * Return the prolog atom of a dictionary atom (created if needed).        *
+ *-------------------------------------------------------------------------*/
+static int
+Store_Atom(FactStore *fs, int64_t no)
+{
+  int64_t *ofs;
+
+  if (fs->atom[no] < 0)
+    {
+      ofs = (int64_t *) (fs->base + fs->hdr->atom_ofs);
+      fs->atom[no] = Pl_Create_Allocate_Atom(fs->base + ofs[no]);
+    }
+
+  return fs->atom[no];
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_ATOM                                                               *
+ *                                                                         *
+ * Return the dictionary no of a prolog atom or -1 if it does not appear.  *
+ *-------------------------------------------------------------------------*/
+static int64_t
+Find_Atom(FactStore *fs, int atom)
+{
+  char *name = pl_atom_tbl[atom].name;
+  int64_t *ofs = (int64_t *) (fs->base + fs->hdr->atom_ofs);
+  int32_t *htbl = (int32_t *) (fs->base + fs->hdr->atom_hash_ofs);
+  int64_t mask = fs->hdr->atom_hash_size - 1;
+  int64_t h, no;
+
+  for (h = Pl_Hash_Buffer(name, strlen(name)) & mask; htbl[h] != 0;
+       h = (h + 1) & mask)
+    {
+      no = htbl[h] - 1;
+      if (fs->atom[no] == atom)
+	return no;
+
+      if (fs->atom[no] < 0 && strcmp(fs->base + ofs[no], name) == 0)
+	{
+	  fs->atom[no] = atom;
+	  return no;
+	}
+    }
+
+  return -1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_VALUE                                                              *
+ *                                                                         *
+ * Return the index entry of a value in the ith column (or NULL).          *
+ *-------------------------------------------------------------------------*/
+static FSBucket *
+Find_Value(FactStore *fs, int i, int type, int64_t key)
+{
+  FSColumn *col = fs->col + i;
+  FSBucket *htbl = (FSBucket *) (fs->base + col->hash_ofs);
+  int64_t mask = col->hash_size - 1;
+  int64_t h;
+
+  for (h = Value_Hash(type, key) & mask; htbl[h].type != 0; h = (h + 1) & mask)
+    if (htbl[h].type == type && htbl[h].key == key)
+      return htbl + h;
+
+  return NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VALUE_HASH                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static uint32_t
+Value_Hash(int type, int64_t key)
+{
+  return Pl_Hash_Buffer(&key, sizeof(key)) ^ (uint32_t) type;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FLOAT_KEY                                                               *
+ *                                                                         *
+ * Return the bits of a float (0.0 and -0.0 are unified so share a key).   *
+ *-------------------------------------------------------------------------*/
+static int64_t
+Float_Key(double d)
+{
+  union
+  {
+    double d;
+    int64_t i;
+  }
+  u;
+
+  u.d = (d == 0.0) ? 0.0 : d;
+  return u.i;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * KEY_FLOAT                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static double
+Key_Float(int64_t key)
+{
+  union
+  {
+    double d;
+    int64_t i;
+  }
+  u;
+
+  u.i = key;
+  return u.d;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_PATH                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static char *
+Get_Path(WamWord file_word)
+{
+  WamWord word, tag_mask;
+  char *path;
+
+  DEREF(file_word, word, tag_mask);
+  if (tag_mask == TAG_REF_MASK)
+    Pl_Err_Instantiation();
+  if (tag_mask != TAG_ATM_MASK)
+    Pl_Err_Domain(pl_domain_source_sink, file_word);
+
+  path = pl_atom_tbl[UnTag_ATM(word)].name;
+  if ((path = Pl_M_Absolute_Path_Name(path)) == NULL)
+    Pl_Err_Existence(pl_existence_source_sink, file_word);
+
+  return path;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_STORE                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static FactStore *
+Get_Store(WamWord store_word)
+{
+  int desc = Pl_Rd_Integer_Check(store_word);
+
+  if (desc < 0 || desc >= fs_tbl_size || !fs_tbl[desc].in_use)
+    Pl_Err_Existence(pl_existence_fact_store, store_word);
+
+  return fs_tbl + desc;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_FILE                                                                *
+ *                                                                         *
+ * Map a whole file in memory (read-only, shared). Without mmap the file  *
+ * is simply read in a malloc'ed buffer. Return NULL on error (see errno).*
+ *-------------------------------------------------------------------------*/
+static char *
+Map_File(char *path, size_t *size)
+{
+#ifndef _WIN32
+  struct stat st;
+  char *base;
+  int fd;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return NULL;
+
+  if (fstat(fd, &st) < 0)
+    {
+      close(fd);
+      return NULL;
+    }
+
+  *size = st.st_size;
+  base = (*size == 0) ? MAP_FAILED :
+    mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (base == MAP_FAILED)
+    {
+      if (*size == 0)
+	errno = EINVAL;
+      return NULL;
+    }
+
+  return base;
+#else
+  FILE *f;
+  char *base;
+  long n;
+
+  if ((f = fopen(path, "rb")) == NULL)
+    return NULL;
+
+  fseek(f, 0, SEEK_END);
+  n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  *size = n;
+  base = (char *) Malloc(n + 1);
+  if (fread(base, 1, n, f) != (size_t) n)
+    {
+      Free(base);
+      base = NULL;
+      errno = EIO;
+    }
+  fclose(f);
+
+  return base;
+#endif
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UNMAP_FILE                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Unmap_File(char *base, size_t size)
+{
+#ifndef _WIN32
+  munmap(base, size);
+#else
+  Free(base);
+#endif
+}
@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : fast_io.pl                                                      *
+ * Descr.: compact binary term I/O                                         *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_fast_io'.
+
+
+
+
+fast_write(Term) :-
+	set_bip_name(fast_write, 1),
+	'$call_c'('Pl_Fast_Write_1'(Term)).
+
+
+fast_write(SorA, Term) :-
+	set_bip_name(fast_write, 2),
+	'$call_c'('Pl_Fast_Write_2'(SorA, Term)).
+
+
+
+
+fast_read(Term) :-
+	set_bip_name(fast_read, 1),
+	'$call_c_test'('Pl_Fast_Read_1'(Term)).
+
+
+fast_read(SorA, Term) :-
+	set_bip_name(fast_read, 2),
+	'$call_c_test'('Pl_Fast_Read_2'(SorA, Term)).
+
+
+
+
+term_to_bytes(Term, Bytes) :-
+	set_bip_name(term_to_bytes, 2),
+	'$call_c_test'('Pl_Term_To_Bytes_2'(Term, Bytes)).
+
+
+
+
+bytes_to_term(Bytes, Term) :-
+	set_bip_name(bytes_to_term, 2),
+	'$call_c_test'('Pl_Bytes_To_Term_2'(Bytes, Term)).
@@ -0,0 +1,302 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : fast_io_c.c                                                     *
+ * Descr.: compact binary term I/O - C part                                *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#define OBJ_INIT Fast_IO_Initializer
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define FAST_TERM_MAX_HEADER       7	/* magic + version + size varint */
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static char *rec_buff;		/* the record being read */
+static int rec_buff_size;
+
+static int atom_invalid_fast_term;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Rec_Buff(int size);
+
+static Bool Un_Record(char *rec, int size, WamWord term_word);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * The terms are exchanged as records of the format implemented by         *
+ * Pl_Serialize_Term() / Pl_Deserialize_Term() (see term_supp.c). No       *
+ * check is done on the type of the stream since the sockets and the pipes *
+ * (sockets_c.c, os_interf_c.c) are created as text streams (the bytes are *
+ * written and read unchanged).                                            *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FAST_IO_INITIALIZER                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Fast_IO_Initializer(void)
+{
+  atom_invalid_fast_term = Pl_Create_Atom("invalid fast term");
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FAST_WRITE_2                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fast_Write_2(WamWord sora_word, WamWord term_word)
+{
+  int stm;
+  char *rec;
+  int size;
+
+  stm = (sora_word == NOT_A_WAM_WORD)
+    ? pl_stm_output : Pl_Get_Stream_Or_Alias(sora_word, STREAM_CHECK_OUTPUT);
+
+  pl_last_output_sora = sora_word;
+
+  size = Pl_Serialize_Term(term_word, &rec);
+  Pl_Stream_Write(rec, size, pl_stm_tbl[stm]);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FAST_WRITE_1                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fast_Write_1(WamWord term_word)
+{
+  Pl_Fast_Write_2(NOT_A_WAM_WORD, term_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FAST_READ_2                                                          *
+ *                                                                         *
+ * At the end of the stream Term is unified with end_of_file.              *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fast_Read_2(WamWord sora_word, WamWord term_word)
+{
+  int stm;
+  StmInf *pstm;
+  int c, n;
+  PlLong size;
+
+  stm = (sora_word == NOT_A_WAM_WORD)
+    ? pl_stm_input : Pl_Get_Stream_Or_Alias(sora_word, STREAM_CHECK_INPUT);
+  pstm = pl_stm_tbl[stm];
+
+  pl_last_input_sora = sora_word;
+
+  if ((c = Pl_Stream_Getc(pstm)) == EOF)
+    return Pl_Un_Atom(pl_atom_end_of_file, term_word);
+
+  Rec_Buff(FAST_TERM_MAX_HEADER);
+  rec_buff[0] = c;
+  n = 1;
+  while ((size = Pl_Fast_Term_Size(rec_buff, n)) == 0)
+    {
+      if ((c = Pl_Stream_Getc(pstm)) == EOF)
+	Pl_Err_Syntax(atom_invalid_fast_term);
+      rec_buff[n++] = c;
+    }
+
+  if (size < 0)
+    Pl_Err_Syntax(atom_invalid_fast_term);
+
+  Rec_Buff(size);
+  if (Pl_Stream_Read(rec_buff + n, size - n, pstm) != size - n)
+    Pl_Err_Syntax(atom_invalid_fast_term);
+
+  return Un_Record(rec_buff, size, term_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FAST_READ_1                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fast_Read_1(WamWord term_word)
+{
+  return Pl_Fast_Read_2(NOT_A_WAM_WORD, term_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TERM_TO_BYTES_2                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Term_To_Bytes_2(WamWord term_word, WamWord bytes_word)
+{
+  char *rec;
+  int size, i;
+  WamWord *adr;
+
+  Pl_Check_For_Un_List(bytes_word);
+
+  size = Pl_Serialize_Term(term_word, &rec);
+
+  adr = H;			/* size > 0: the list is built in place */
+  for (i = 0; i < size; i++)
+    {
+      *H++ = Tag_INT((unsigned char) rec[i]);
+      *H = Tag_LST(H + 1);
+      H++;
+    }
+  H[-1] = NIL_WORD;
+
+  return Pl_Unify(Tag_LST(adr), bytes_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_BYTES_TO_TERM_2                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Bytes_To_Term_2(WamWord bytes_word, WamWord term_word)
+{
+  WamWord word, tag_mask;
+  WamWord save_bytes_word = bytes_word;
+  WamWord *lst_adr;
+  int n = 0;
+
+  for (;;)
+    {
+      DEREF(bytes_word, word, tag_mask);
+
+      if (tag_mask == TAG_REF_MASK)
+	Pl_Err_Instantiation();
+
+      if (word == NIL_WORD)
+	break;
+
+      if (tag_mask != TAG_LST_MASK)
+	Pl_Err_Type(pl_type_list, save_bytes_word);
+
+      lst_adr = UnTag_LST(word);
+      if (n >= rec_buff_size)
+	Rec_Buff(n + 1);
+      rec_buff[n++] = Pl_Rd_Byte_Check(Car(lst_adr));
+      bytes_word = Cdr(lst_adr);
+    }
+
+  return Un_Record(rec_buff, n, term_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * REC_BUFF                                                                *
+ *                                                                         *
+ * Ensure the record buffer can contain size bytes (keeping its content).  *
+ *-------------------------------------------------------------------------*/
+static void
+Rec_Buff(int size)
+{
+  if (size > rec_buff_size)
+    {
+      rec_buff_size = (size < 2 * rec_buff_size) ? 2 * rec_buff_size : size;
+      if (rec_buff_size < 1024)
+	rec_buff_size = 1024;
+      rec_buff = (char *) Realloc(rec_buff, rec_buff_size);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UN_RECORD                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Un_Record(char *rec, int size, WamWord term_word)
+{
+  WamWord word = Pl_Deserialize_Term(rec, size);
+
+  if (word == NOT_A_WAM_WORD)
+    Pl_Err_Syntax(atom_invalid_fast_term);
+
+  return Pl_Unify(word, term_word);
+}
@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : g_num.pl                                                        *
+ * Descr.: typed numeric global arrays                                     *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_g_num'.
+
+
+
+
+g_num_array(Name, Type, Size) :-
+	set_bip_name(g_num_array, 3),
+	'$call_c'('Pl_G_Num_Array_3'(Name, Type, Size)).
+
+
+
+
+g_num_set(Name, Index, Value) :-
+	set_bip_name(g_num_set, 3),
+	'$call_c'('Pl_G_Num_Set_4'(Name, Index, Value, 0)).
+
+
+g_num_setb(Name, Index, Value) :-
+	set_bip_name(g_num_setb, 3),
+	'$call_c'('Pl_G_Num_Set_4'(Name, Index, Value, 1)).
+
+
+
+
+g_num_add(Name, Index, Delta) :-
+	set_bip_name(g_num_add, 3),
+	'$call_c'('Pl_G_Num_Add_4'(Name, Index, Delta, 0)).
+
+
+g_num_addb(Name, Index, Delta) :-
+	set_bip_name(g_num_addb, 3),
+	'$call_c'('Pl_G_Num_Add_4'(Name, Index, Delta, 1)).
+
+
+
+
+g_num_get(Name, Index, Value) :-
+	set_bip_name(g_num_get, 3),
+	'$call_c_test'('Pl_G_Num_Get_3'(Name, Index, Value)).
+
+
+
+
+g_num_size(Name, Size) :-
+	set_bip_name(g_num_size, 2),
+	'$call_c_test'('Pl_G_Num_Size_2'(Name, Size)).
+
+
+
+
+g_num_fill(Name, Value) :-
+	set_bip_name(g_num_fill, 2),
+	'$call_c'('Pl_G_Num_Fill_2'(Name, Value)).
+
+
+
+
+g_num_sum(Name, Sum) :-
+	set_bip_name(g_num_sum, 2),
+	'$call_c_test'('Pl_G_Num_Sum_2'(Name, Sum)).
+
+
+
+
+g_num_min(Name, Min) :-
+	set_bip_name(g_num_min, 2),
+	'$call_c_test'('Pl_G_Num_Min_Max_3'(Name, Min, 0)).
+
+
+g_num_max(Name, Max) :-
+	set_bip_name(g_num_max, 2),
+	'$call_c_test'('Pl_G_Num_Min_Max_3'(Name, Max, 1)).
+
+
+
+
+g_num_from_list(Name, List) :-
+	set_bip_name(g_num_from_list, 2),
+	'$call_c'('Pl_G_Num_From_List_2'(Name, List)).
+
+
+
+
+g_num_to_list(Name, List) :-
+	set_bip_name(g_num_to_list, 2),
+	'$call_c_test'('Pl_G_Num_To_List_2'(Name, List)).
@@ -0,0 +1,549 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : g_num_c.c                                                       *
+ * Descr.: typed numeric global arrays - C part                            *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <string.h>
+
+#define OBJ_INIT G_Num_Initializer
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define G_NUM_INT                  0
+#define G_NUM_FLOAT                1
+
+#define G_NUM_UNDO_FRAME_SIZE      (3 + (sizeof(double) + sizeof(WamWord) - 1) / sizeof(WamWord))
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef union			/* an element                     */
+{
+  PlLong i;			/* for G_NUM_INT arrays           */
+  double f;			/* for G_NUM_FLOAT arrays         */
+}
+GNumElt;
+
+
+typedef struct			/* Numeric array                  */
+{				/* ------------------------------ */
+  PlLong atom;			/* key: name of the array         */
+  int type;			/* G_NUM_INT or G_NUM_FLOAT       */
+  int stamp;			/* identifies this creation       */
+  PlLong size;			/* number of elements             */
+  GNumElt *elt;			/* elements (mallocated)          */
+}
+GNumArray;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static char *g_num_tbl;		/* name -> GNumArray */
+static int g_num_stamp = 0;
+
+static int atom_int;
+static int atom_float;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static GNumArray *Get_Array(WamWord name_word);
+
+static GNumElt *Get_Elt(GNumArray *g, WamWord index_word);
+
+static GNumElt Rd_Value(GNumArray *g, WamWord value_word);
+
+static Bool Un_Value(GNumArray *g, GNumElt e, WamWord value_word);
+
+static void Set_Size(GNumArray *g, PlLong size);
+
+static void G_Num_Trail(GNumArray *g, GNumElt *e);
+
+static void G_Num_Untrail(int n, WamWord *arg_frame);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A numeric array is a global array (named by an atom) of C integers or  *
+ * doubles. Unlike g_assign/2 arrays, whose elements are copies of terms, *
+ * the elements are updated in place and bulk operations (fill, sum,     *
+ * min, max) are simple C loops over a contiguous block.                  *
+ *                                                                         *
+ * A backtrackable update pushes on the trail a function call frame with *
+ * the array, its stamp, the index and the previous value (the stamp      *
+ * detects an array recreated meanwhile, the undo is then ignored).       *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_NUM_INITIALIZER                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_Num_Initializer(void)
+{
+  g_num_tbl = Pl_Hash_Alloc_Table(64, sizeof(GNumArray));
+
+  atom_int = Pl_Create_Atom("int");
+  atom_float = Pl_Create_Atom("float");
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_ARRAY_3                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_G_Num_Array_3(WamWord name_word, WamWord type_word, WamWord size_word)
+{
+  int atom = Pl_Rd_Atom_Check(name_word);
+  int type_atom = Pl_Rd_Atom_Check(type_word);
+  PlLong size = Pl_Rd_Positive_Check(size_word);
+  GNumArray g, *p;
+
+  if (type_atom != atom_int && type_atom != atom_float)
+    Pl_Err_Domain(pl_domain_g_num_type, type_word);
+
+  p = (GNumArray *) Pl_Hash_Find(g_num_tbl, atom);
+  if (p == NULL)
+    {
+      g.atom = atom;
+      g.size = 0;
+      g.elt = NULL;
+      p = (GNumArray *) Pl_Hash_Insert(g_num_tbl, (char *) &g, FALSE);
+    }
+
+  p->type = (type_atom == atom_int) ? G_NUM_INT : G_NUM_FLOAT;
+  p->stamp = ++g_num_stamp;
+  Set_Size(p, size);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_SET_4                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_G_Num_Set_4(WamWord name_word, WamWord index_word, WamWord value_word,
+	       WamWord backtrack_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  GNumElt *e = Get_Elt(g, index_word);
+  GNumElt v = Rd_Value(g, value_word);
+
+  if (Pl_Rd_Integer_Check(backtrack_word))
+    G_Num_Trail(g, e);
+
+  *e = v;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_ADD_4                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_G_Num_Add_4(WamWord name_word, WamWord index_word, WamWord delta_word,
+	       WamWord backtrack_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  GNumElt *e = Get_Elt(g, index_word);
+  GNumElt v = Rd_Value(g, delta_word);
+
+  if (Pl_Rd_Integer_Check(backtrack_word))
+    G_Num_Trail(g, e);
+
+  if (g->type == G_NUM_INT)
+    e->i += v.i;
+  else
+    e->f += v.f;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_GET_3                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_G_Num_Get_3(WamWord name_word, WamWord index_word, WamWord value_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  GNumElt *e = Get_Elt(g, index_word);
+
+  return Un_Value(g, *e, value_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_SIZE_2                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_G_Num_Size_2(WamWord name_word, WamWord size_word)
+{
+  GNumArray *g = Get_Array(name_word);
+
+  return Pl_Un_Integer_Check(g->size, size_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_FILL_2                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_G_Num_Fill_2(WamWord name_word, WamWord value_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  GNumElt v = Rd_Value(g, value_word);
+  PlLong i, size = g->size;
+  GNumElt *elt = g->elt;
+
+  for (i = 0; i < size; i++)
+    elt[i] = v;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_SUM_2                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_G_Num_Sum_2(WamWord name_word, WamWord sum_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  PlLong i, size = g->size;
+  GNumElt *elt = g->elt;
+  GNumElt s;
+
+  if (g->type == G_NUM_INT)
+    {
+      s.i = 0;
+      for (i = 0; i < size; i++)
+	s.i += elt[i].i;
+    }
+  else
+    {
+      s.f = 0.0;
+      for (i = 0; i < size; i++)
+	s.f += elt[i].f;
+    }
+
+  return Un_Value(g, s, sum_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_MIN_MAX_3                                                      *
+ *                                                                         *
+ * max_word: 0 for the minimum, 1 for the maximum (fails if empty).        *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_G_Num_Min_Max_3(WamWord name_word, WamWord res_word, WamWord max_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  Bool max = Pl_Rd_Integer_Check(max_word);
+  PlLong i, size = g->size;
+  GNumElt *elt = g->elt;
+  GNumElt m;
+
+  if (size == 0)
+    return FALSE;
+
+  m = elt[0];
+  if (g->type == G_NUM_INT)
+    {
+      if (max)
+	{
+	  for (i = 1; i < size; i++)
+	    if (elt[i].i > m.i)
+	      m.i = elt[i].i;
+	}
+      else
+	{
+	  for (i = 1; i < size; i++)
+	    if (elt[i].i < m.i)
+	      m.i = elt[i].i;
+	}
+    }
+  else
+    {
+      if (max)
+	{
+	  for (i = 1; i < size; i++)
+	    if (elt[i].f > m.f)
+	      m.f = elt[i].f;
+	}
+      else
+	{
+	  for (i = 1; i < size; i++)
+	    if (elt[i].f < m.f)
+	      m.f = elt[i].f;
+	}
+    }
+
+  return Un_Value(g, m, res_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_FROM_LIST_2                                                    *
+ *                                                                         *
+ * The array is resized to the length of the list.                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_G_Num_From_List_2(WamWord name_word, WamWord list_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  WamWord save_list_word = list_word;
+  WamWord *lst_adr;
+  PlLong i, n;
+
+  n = Pl_List_Length(list_word);
+  if (n == -1)
+    Pl_Err_Instantiation();
+  if (n < 0)
+    Pl_Err_Type(pl_type_list, save_list_word);
+
+  Set_Size(g, n);
+  g->stamp = ++g_num_stamp;	/* undo records no longer valid */
+
+  for (i = 0; i < n; i++)
+    {
+      lst_adr = Pl_Rd_List_Check(list_word);
+      g->elt[i] = Rd_Value(g, Car(lst_adr));
+      list_word = Cdr(lst_adr);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_G_NUM_TO_LIST_2                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_G_Num_To_List_2(WamWord name_word, WamWord list_word)
+{
+  GNumArray *g = Get_Array(name_word);
+  WamWord word, lst_word, elt_word;
+  PlLong i;
+
+  Pl_Check_For_Un_List(list_word);
+
+  lst_word = NIL_WORD;		/* built from the end (floats go on the heap) */
+  for (i = g->size - 1; i >= 0; i--)
+    {
+      elt_word = (g->type == G_NUM_INT) ? Pl_Put_Integer(g->elt[i].i) :
+	Pl_Put_Float(g->elt[i].f);
+      word = Pl_Put_List();
+      Pl_Unify_Value(elt_word);
+      Pl_Unify_Value(lst_word);
+      lst_word = word;
+    }
+
+  return Pl_Unify(lst_word, list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_ARRAY                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static GNumArray *
+Get_Array(WamWord name_word)
+{
+  int atom = Pl_Rd_Atom_Check(name_word);
+  GNumArray *g;
+
+  g = (GNumArray *) Pl_Hash_Find(g_num_tbl, atom);
+  if (g == NULL)
+    Pl_Err_Existence(pl_existence_g_num_array, name_word);
+
+  return g;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_ELT                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static GNumElt *
+Get_Elt(GNumArray *g, WamWord index_word)
+{
+  PlLong i = Pl_Rd_Integer_Check(index_word);
+
+  if (i < 0 || i >= g->size)
+    Pl_Err_Domain(pl_domain_g_array_index, index_word);
+
+  return g->elt + i;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RD_VALUE                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static GNumElt
+Rd_Value(GNumArray *g, WamWord value_word)
+{
+  GNumElt v;
+
+  if (g->type == G_NUM_INT)
+    v.i = Pl_Rd_Integer_Check(value_word);
+  else
+    v.f = Pl_Rd_Number_Check(value_word);
+
+  return v;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UN_VALUE                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Un_Value(GNumArray *g, GNumElt e, WamWord value_word)
+{
+  if (g->type == G_NUM_INT)
+    return Pl_Un_Integer_Check(e.i, value_word);
+
+  return Pl_Un_Float_Check(e.f, value_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SET_SIZE                                                                *
+ *                                                                         *
+ * (Re)allocate the elements (all set to 0).                               *
+ *-------------------------------------------------------------------------*/
+static void
+Set_Size(GNumArray *g, PlLong size)
+{
+  if (g->elt)
+    Free(g->elt);
+
+  g->size = size;
+  g->elt = (GNumElt *) Calloc(size + 1, sizeof(GNumElt));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_NUM_TRAIL                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_Num_Trail(GNumArray *g, GNumElt *e)
+{
+  WamWord arg_frame[G_NUM_UNDO_FRAME_SIZE];
+
+  arg_frame[0] = (WamWord) g;
+  arg_frame[1] = g->stamp;
+  arg_frame[2] = e - g->elt;
+  memcpy(arg_frame + 3, e, sizeof(GNumElt));
+
+  Trail_FC(G_Num_Untrail, G_NUM_UNDO_FRAME_SIZE, arg_frame);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_NUM_UNTRAIL                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_Num_Untrail(int n, WamWord *arg_frame)
+{
+  GNumArray *g = (GNumArray *) arg_frame[0];
+
+  if (g->stamp == arg_frame[1])
+    memcpy(g->elt + arg_frame[2], arg_frame + 3, sizeof(GNumElt));
+}
@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : htable.pl                                                       *
+ * Descr.: mutable hash tables                                             *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_htable'.
+
+
+
+ht_new(Table) :-
+	set_bip_name(ht_new, 1),
+	'$call_c_test'('Pl_Ht_New_1'(Table)).
+
+
+
+
+ht_free(Table) :-
+	set_bip_name(ht_free, 1),
+	'$call_c'('Pl_Ht_Free_1'(Table)).
+
+
+
+
+ht_clear(Table) :-
+	set_bip_name(ht_clear, 1),
+	'$call_c'('Pl_Ht_Clear_1'(Table)).
+
+
+
+
+ht_put(Table, Key, Value) :-
+	set_bip_name(ht_put, 3),
+	'$call_c'('Pl_Ht_Put_4'(Table, Key, Value, 0)).
+
+
+ht_putb(Table, Key, Value) :-
+	set_bip_name(ht_putb, 3),
+	'$call_c'('Pl_Ht_Put_4'(Table, Key, Value, 1)).
+
+
+
+
+ht_get(Table, Key, Value) :-
+	set_bip_name(ht_get, 3),
+	'$call_c_test'('Pl_Ht_Get_3'(Table, Key, Value)).
+
+
+
+
+ht_delete(Table, Key) :-
+	set_bip_name(ht_delete, 2),
+	'$call_c_test'('Pl_Ht_Delete_3'(Table, Key, 0)).
+
+
+ht_deleteb(Table, Key) :-
+	set_bip_name(ht_deleteb, 2),
+	'$call_c_test'('Pl_Ht_Delete_3'(Table, Key, 1)).
+
+
+
+
+ht_size(Table, Size) :-
+	set_bip_name(ht_size, 2),
+	'$call_c_test'('Pl_Ht_Size_2'(Table, Size)).
+
+
+
+
+ht_to_list(Table, Pairs) :-
+	set_bip_name(ht_to_list, 2),
+	'$call_c_test'('Pl_Ht_To_List_2'(Table, Pairs)).
+
+
+
+
+ht_member(Table, Key, Value) :-
+	set_bip_name(ht_member, 3),
+	(   ground(Key) ->
+	    '$call_c_test'('Pl_Ht_Get_3'(Table, Key, Value))
+	;   '$call_c_test'('Pl_Ht_To_List_2'(Table, Pairs)),
+	    '$ht_member'(Pairs, Key, Value)
+	).
+
+
+'$ht_member'([Key1-Value1|Pairs], Key, Value) :-
+	(   Key = Key1,
+	    Value = Value1
+	;   '$ht_member'(Pairs, Key, Value)
+	).
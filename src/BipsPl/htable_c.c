@@ -0,0 +1,612 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : htable_c.c                                                      *
+ * Descr.: mutable hash tables - C part                                    *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define HT_INIT_SIZE               64
+
+#define HT_UNDO_FRAME_SIZE         5
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct htitem *PHTItem;
+
+typedef struct htitem		/* Key-Value item                 */
+{				/* ------------------------------ */
+  WamWord *key;			/* copy of the key (ground)       */
+  int key_size;			/* size of this copy              */
+  WamWord *val;			/* copy of the value              */
+  int val_size;			/* size of this copy              */
+  PHTItem next;			/* next item with the same hash   */
+}
+HTItem;
+
+
+typedef struct			/* Hash table entry               */
+{				/* ------------------------------ */
+  PlLong key;			/* hash of the key (term hash)    */
+  HTItem *first;		/* items having this hash         */
+}
+HTEntry;
+
+
+typedef struct			/* Hash table                     */
+{				/* ------------------------------ */
+  Bool in_use;			/* is this entry used ?           */
+  int stamp;			/* identifies this use of the slot */
+  char *htbl;			/* hash -> HTEntry (see hash.c)   */
+  int nb_item;			/* number of Key-Value items      */
+}
+HTable;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static HTable *ht_tbl = NULL;	/* table (mallocated) */
+static int ht_tbl_size = 0;	/* allocated size */
+static int ht_stamp = 0;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static HTable *Get_Table(WamWord table_word);
+
+static unsigned Key_Hash(WamWord key_word);
+
+static HTItem **Find_Item(HTable *ht, WamWord key_word, unsigned hash);
+
+static void Set_Value(HTable *ht, WamWord key_word, unsigned hash,
+		      WamWord *val, int val_size);
+
+static void Delete_Item(HTable *ht, HTItem **p, unsigned hash);
+
+static void Trail_Undo(HTable *ht, WamWord key_word, HTItem *item);
+
+static void Ht_Untrail(int n, WamWord *arg_frame);
+
+static void Free_Items(HTable *ht);
+
+static WamWord *Copy_To_Malloc(WamWord word, int *size);
+
+static WamWord Copy_To_Heap(WamWord *adr, int size);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A hash table maps ground keys to terms (both are copied, like g_assign).*
+ * The engine hash table (hash.c) is indexed by the hash of the key (see   *
+ * Pl_Term_Hash) and gives the chain of items having this hash, the keys   *
+ * are then compared with Pl_Term_Compare.                                 *
+ *                                                                         *
+ * Backtrackable updates (ht_putb/3, ht_deleteb/2) push on the trail a     *
+ * function call frame recording the table, a copy of the key and the     *
+ * previous value (NULL if the key was absent). At backtracking the key    *
+ * gets back this value, even if other (non backtrackable) updates were    *
+ * done on this key meanwhile. The stamp detects undo records whose table  *
+ * has been freed (and whose slot has been reused).                        *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_NEW_1                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Ht_New_1(WamWord table_word)
+{
+  HTable *ht;
+  int desc;
+
+  Pl_Check_For_Un_Variable(table_word);
+
+  if (ht_tbl == NULL)		/* first allocation */
+    {
+      ht_tbl_size = 8;
+      ht_tbl = (HTable *) Calloc(ht_tbl_size, sizeof(HTable));
+    }
+
+  for (desc = 0; desc < ht_tbl_size; desc++)
+    if (!ht_tbl[desc].in_use)
+      break;
+
+  if (desc == ht_tbl_size)
+    Pl_Extend_Array((char **) &ht_tbl, &ht_tbl_size, sizeof(HTable), TRUE);
+
+  ht = ht_tbl + desc;
+  ht->in_use = TRUE;
+  ht->stamp = ++ht_stamp;
+  ht->htbl = Pl_Hash_Alloc_Table(HT_INIT_SIZE, sizeof(HTEntry));
+  ht->nb_item = 0;
+
+  return Pl_Get_Integer(desc, table_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_FREE_1                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Ht_Free_1(WamWord table_word)
+{
+  HTable *ht = Get_Table(table_word);
+
+  Free_Items(ht);
+  Pl_Hash_Free_Table(ht->htbl);
+  ht->htbl = NULL;
+  ht->in_use = FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_CLEAR_1                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Ht_Clear_1(WamWord table_word)
+{
+  HTable *ht = Get_Table(table_word);
+
+  Free_Items(ht);
+  Pl_Hash_Delete_All(ht->htbl);
+  ht->nb_item = 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_PUT_4                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Ht_Put_4(WamWord table_word, WamWord key_word, WamWord val_word,
+	    WamWord backtrack_word)
+{
+  HTable *ht = Get_Table(table_word);
+  unsigned hash = Key_Hash(key_word);
+  HTItem **p;
+  WamWord *val;
+  int val_size;
+
+  p = Find_Item(ht, key_word, hash);
+  if (Pl_Rd_Integer_Check(backtrack_word))
+    Trail_Undo(ht, key_word, *p);
+  else if (*p)
+    Free((*p)->val);
+
+  val = Copy_To_Malloc(val_word, &val_size);
+  if (*p)
+    {
+      (*p)->val = val;
+      (*p)->val_size = val_size;
+    }
+  else
+    Set_Value(ht, key_word, hash, val, val_size);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_GET_3                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Ht_Get_3(WamWord table_word, WamWord key_word, WamWord val_word)
+{
+  HTable *ht = Get_Table(table_word);
+  HTItem *item = *Find_Item(ht, key_word, Key_Hash(key_word));
+
+  return item != NULL &&
+    Pl_Unify(Copy_To_Heap(item->val, item->val_size), val_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_DELETE_3                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Ht_Delete_3(WamWord table_word, WamWord key_word, WamWord backtrack_word)
+{
+  HTable *ht = Get_Table(table_word);
+  unsigned hash = Key_Hash(key_word);
+  HTItem **p;
+
+  p = Find_Item(ht, key_word, hash);
+  if (*p == NULL)
+    return FALSE;
+
+  if (Pl_Rd_Integer_Check(backtrack_word))
+    {
+      Trail_Undo(ht, key_word, *p);
+      (*p)->val = NULL;		/* now owned by the undo record */
+    }
+
+  Delete_Item(ht, p, hash);
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_SIZE_2                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Ht_Size_2(WamWord table_word, WamWord size_word)
+{
+  HTable *ht = Get_Table(table_word);
+
+  return Pl_Un_Integer_Check(ht->nb_item, size_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_HT_TO_LIST_2                                                         *
+ *                                                                         *
+ * Unify list_word with the list of Key-Value pairs (in no specific order).*
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Ht_To_List_2(WamWord table_word, WamWord list_word)
+{
+  HTable *ht = Get_Table(table_word);
+  HashScan scan;
+  HTEntry *e;
+  HTItem *item;
+  WamWord lst_word, word, key_word, val_word;
+
+  Pl_Check_For_Un_List(list_word);
+
+  lst_word = NIL_WORD;
+  for (e = (HTEntry *) Pl_Hash_First(ht->htbl, &scan); e;
+       e = (HTEntry *) Pl_Hash_Next(&scan))
+    for (item = e->first; item; item = item->next)
+      {
+	key_word = Copy_To_Heap(item->key, item->key_size);
+	val_word = Copy_To_Heap(item->val, item->val_size);
+	word = Pl_Put_Structure(ATOM_CHAR('-'), 2);
+	Pl_Unify_Value(key_word);
+	Pl_Unify_Value(val_word);
+
+	val_word = word;
+	word = Pl_Put_List();
+	Pl_Unify_Value(val_word);
+	Pl_Unify_Value(lst_word);
+	lst_word = word;
+      }
+
+  return Pl_Unify(lst_word, list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_TABLE                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static HTable *
+Get_Table(WamWord table_word)
+{
+  int desc = Pl_Rd_Integer_Check(table_word);
+
+  if (desc < 0 || desc >= ht_tbl_size || !ht_tbl[desc].in_use)
+    Pl_Err_Existence(pl_existence_hash_table, table_word);
+
+  return ht_tbl + desc;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * KEY_HASH                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static unsigned
+Key_Hash(WamWord key_word)
+{
+  unsigned hash;
+
+  if (!Pl_Term_Hash(key_word, -1, &hash))
+    Pl_Err_Instantiation();
+
+  return hash;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_ITEM                                                               *
+ *                                                                         *
+ * Return the address of the link to the item of the key (the link is NULL *
+ * if the key is not in the table).                                        *
+ *-------------------------------------------------------------------------*/
+static HTItem **
+Find_Item(HTable *ht, WamWord key_word, unsigned hash)
+{
+  static HTItem *none = NULL;
+  HTEntry *e;
+  HTItem **p;
+
+  e = (HTEntry *) Pl_Hash_Find(ht->htbl, hash);
+  if (e == NULL)
+    {
+      none = NULL;
+      return &none;
+    }
+
+  for (p = &e->first; *p; p = &(*p)->next)
+    if (Pl_Term_Compare(*(*p)->key, key_word) == 0)
+      break;
+
+  return p;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SET_VALUE                                                               *
+ *                                                                         *
+ * Add a new item for key_word (which is not in the table).                *
+ *-------------------------------------------------------------------------*/
+static void
+Set_Value(HTable *ht, WamWord key_word, unsigned hash, WamWord *val,
+	  int val_size)
+{
+  HTEntry e, *pe;
+  HTItem *item;
+  int size;
+
+  pe = (HTEntry *) Pl_Hash_Find(ht->htbl, hash);
+  if (pe == NULL)
+    {
+      size = Pl_Hash_Table_Size(ht->htbl);
+      if (Pl_Hash_Nb_Elements(ht->htbl) >= size)
+	ht->htbl = Pl_Hash_Realloc_Table(ht->htbl, size * 2);
+
+      e.key = hash;
+      e.first = NULL;
+      pe = (HTEntry *) Pl_Hash_Insert(ht->htbl, (char *) &e, FALSE);
+    }
+
+  item = (HTItem *) Malloc(sizeof(HTItem));
+  item->key = Copy_To_Malloc(key_word, &item->key_size);
+  item->val = val;
+  item->val_size = val_size;
+  item->next = pe->first;
+  pe->first = item;
+  ht->nb_item++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DELETE_ITEM                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Delete_Item(HTable *ht, HTItem **p, unsigned hash)
+{
+  HTItem *item = *p;
+
+  *p = item->next;
+  if (item->val)
+    Free(item->val);
+  Free(item->key);
+  Free(item);
+  ht->nb_item--;
+
+  if (((HTEntry *) Pl_Hash_Find(ht->htbl, hash))->first == NULL)
+    Pl_Hash_Delete(ht->htbl, hash);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TRAIL_UNDO                                                              *
+ *                                                                         *
+ * Record the current value of the key (item is NULL if it is absent). The *
+ * previous value (if any) is then owned by the undo record.               *
+ *-------------------------------------------------------------------------*/
+static void
+Trail_Undo(HTable *ht, WamWord key_word, HTItem *item)
+{
+  WamWord arg_frame[HT_UNDO_FRAME_SIZE];
+  int key_size;
+
+  arg_frame[0] = ht - ht_tbl;
+  arg_frame[1] = ht->stamp;
+  arg_frame[2] = (WamWord) Copy_To_Malloc(key_word, &key_size);
+  arg_frame[3] = (WamWord) ((item) ? item->val : NULL);
+  arg_frame[4] = (item) ? item->val_size : 0;
+
+  Trail_FC(Ht_Untrail, HT_UNDO_FRAME_SIZE, arg_frame);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * HT_UNTRAIL                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Ht_Untrail(int n, WamWord *arg_frame)
+{
+  HTable *ht = ht_tbl + arg_frame[0];
+  WamWord *key = (WamWord *) arg_frame[2];
+  WamWord *val = (WamWord *) arg_frame[3];
+  int val_size = arg_frame[4];
+  unsigned hash;
+  HTItem **p;
+
+  if (!ht->in_use || ht->stamp != arg_frame[1])	/* table freed */
+    {
+      if (val)
+	Free(val);
+      Free(key);
+      return;
+    }
+
+  Pl_Term_Hash(*key, -1, &hash);
+  p = Find_Item(ht, *key, hash);
+  if (*p)
+    {
+      Free((*p)->val);
+      if (val)
+	{
+	  (*p)->val = val;
+	  (*p)->val_size = val_size;
+	}
+      else
+	{
+	  (*p)->val = NULL;
+	  Delete_Item(ht, p, hash);
+	}
+    }
+  else if (val)
+    Set_Value(ht, *key, hash, val, val_size);
+
+  Free(key);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FREE_ITEMS                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Free_Items(HTable *ht)
+{
+  HashScan scan;
+  HTEntry *e;
+  HTItem *item, *next;
+
+  for (e = (HTEntry *) Pl_Hash_First(ht->htbl, &scan); e;
+       e = (HTEntry *) Pl_Hash_Next(&scan))
+    for (item = e->first; item; item = next)
+      {
+	next = item->next;
+	if (item->val)
+	  Free(item->val);
+	Free(item->key);
+	Free(item);
+      }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COPY_TO_MALLOC                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord *
+Copy_To_Malloc(WamWord word, int *size)
+{
+  WamWord *adr;
+
+  *size = Pl_Term_Size(word);
+  adr = (WamWord *) Malloc((*size + 1) * sizeof(WamWord));
+  Pl_Copy_Term(adr, &word);
+
+  return adr;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COPY_TO_HEAP                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Copy_To_Heap(WamWord *adr, int size)
+{
+  WamWord word;
+
+  Pl_Copy_Contiguous_Term(H, adr);
+  word = *H;
+  H += size;
+
+  return word;
+}
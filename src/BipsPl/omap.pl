@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : omap.pl                                                         *
+ * Descr.: persistent ordered maps (AVL trees)                             *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_omap'.
+
+
+
+omap_empty(t).
+
+
+
+
+omap_put(Map, Key, Value, Map1) :-
+	set_bip_name(omap_put, 4),
+	'$call_c_test'('Pl_Omap_Put_4'(Map, Key, Value, Map1)).
+
+
+
+
+omap_get(Map, Key, Value) :-
+	set_bip_name(omap_get, 3),
+	'$call_c_test'('Pl_Omap_Get_3'(Map, Key, Value)).
+
+
+
+
+omap_delete(Map, Key, Value, Map1) :-
+	set_bip_name(omap_delete, 4),
+	'$call_c_test'('Pl_Omap_Delete_4'(Map, Key, Value, Map1)).
+
+
+
+
+omap_min(Map, Key, Value) :-
+	set_bip_name(omap_min, 3),
+	'$call_c_test'('Pl_Omap_Min_Max_4'(Map, Key, Value, 0)).
+
+
+omap_max(Map, Key, Value) :-
+	set_bip_name(omap_max, 3),
+	'$call_c_test'('Pl_Omap_Min_Max_4'(Map, Key, Value, 1)).
+
+
+
+
+omap_range(Map, Lo, Hi, Pairs) :-
+	set_bip_name(omap_range, 4),
+	'$call_c_test'('Pl_Omap_Range_4'(Map, Lo, Hi, Pairs)).
+
+
+
+
+omap_to_list(Map, Pairs) :-
+	set_bip_name(omap_to_list, 2),
+	'$call_c_test'('Pl_Omap_To_List_2'(Map, Pairs)).
+
+
+
+
+list_to_omap(Pairs, Map) :-
+	set_bip_name(list_to_omap, 2),
+	'$call_c_test'('Pl_List_To_Omap_2'(Pairs, Map)).
+
+
+
+
+omap_size(Map, Size) :-
+	set_bip_name(omap_size, 2),
+	'$call_c_test'('Pl_Omap_Size_2'(Map, Size)).
+
+
+
+
+omap_member(Map, Key, Value) :-
+	set_bip_name(omap_member, 3),
+	(   ground(Key) ->
+	    '$call_c_test'('Pl_Omap_Get_3'(Map, Key, Value))
+	;   '$call_c_test'('Pl_Omap_To_List_2'(Map, Pairs)),
+	    '$omap_member'(Pairs, Key, Value)
+	).
+
+
+'$omap_member'([Key1-Value1|Pairs], Key, Value) :-
+	(   Key = Key1,
+	    Value = Value1
+	;   '$omap_member'(Pairs, Key, Value)
+	).
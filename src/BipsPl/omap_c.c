@@ -0,0 +1,650 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : omap_c.c                                                        *
+ * Descr.: persistent ordered maps (AVL trees) - C part                    *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#define OBJ_INIT Omap_Initializer
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static int atom_t;
+static WamWord empty_word;	/* the empty map: t */
+
+static WamWord del_val_word;	/* value of the deleted key */
+static WamWord min_key_word;	/* smallest key removed by Delete_Min */
+static WamWord min_val_word;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static WamWord Rd_Map_Check(WamWord map_word);
+
+static WamWord Safe_Word(WamWord start_word);
+
+static int Height(WamWord t_word);
+
+static WamWord Mk_Node(WamWord k, WamWord v, WamWord l, WamWord r);
+
+static WamWord Balance(WamWord k, WamWord v, WamWord l, WamWord r);
+
+static WamWord Insert(WamWord t_word, WamWord key_word, WamWord val_word);
+
+static WamWord Delete(WamWord t_word, WamWord key_word);
+
+static WamWord Delete_Min(WamWord t_word);
+
+static WamWord Mk_Pair_Cons(WamWord k, WamWord v, WamWord tail_word);
+
+static WamWord Range(WamWord t_word, WamWord lo_word, WamWord hi_word,
+		     WamWord tail_word);
+
+static PlLong Size(WamWord t_word);
+
+
+
+#define Node_Key(adr)              Arg(adr, 0)
+#define Node_Val(adr)              Arg(adr, 1)
+#define Node_Height(adr)           UnTag_INT(Arg(adr, 2))
+#define Node_Left(adr)             Arg(adr, 3)
+#define Node_Right(adr)            Arg(adr, 4)
+
+#define Is_Empty(t_word)           ((t_word) == empty_word)
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A map is a term: t (empty map) or t(Key, Value, Height, Left, Right), an *
+ * AVL tree ordered on the keys w.r.t. the standard order (Pl_Term_Compare).*
+ * Updates never modify a tree: the nodes on the path to the key are       *
+ * copied (path copying) on the heap, so previous versions remain valid    *
+ * and are naturally recovered on backtracking.                            *
+ * All operations are in O(log n) (+ the size of the result for ranges).   *
+ * The words stored in the nodes are always dereferenced (except unbound   *
+ * variables which are then global) thus a map can be traversed without   *
+ * DEREF.                                                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * OMAP_INITIALIZER                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Omap_Initializer(void)
+{
+  atom_t = Pl_Create_Atom("t");
+  empty_word = Tag_ATM(atom_t);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_PUT_4                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Put_4(WamWord map_word, WamWord key_word, WamWord val_word,
+	      WamWord map1_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  key_word = Safe_Word(key_word);
+  val_word = Safe_Word(val_word);
+
+  return Pl_Unify(Insert(t_word, key_word, val_word), map1_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_GET_3                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Get_3(WamWord map_word, WamWord key_word, WamWord val_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  WamWord *adr;
+  PlLong cmp;
+
+  while (!Is_Empty(t_word))
+    {
+      adr = UnTag_STC(t_word);
+      cmp = Pl_Term_Compare(key_word, Node_Key(adr));
+      if (cmp == 0)
+	return Pl_Unify(Node_Val(adr), val_word);
+
+      t_word = (cmp < 0) ? Node_Left(adr) : Node_Right(adr);
+    }
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_DELETE_4                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Delete_4(WamWord map_word, WamWord key_word, WamWord val_word,
+		 WamWord map1_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+
+  del_val_word = NOT_A_WAM_WORD;
+  t_word = Delete(t_word, key_word);
+  if (del_val_word == NOT_A_WAM_WORD)	/* key not found */
+    return FALSE;
+
+  return Pl_Unify(del_val_word, val_word) && Pl_Unify(t_word, map1_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_MIN_MAX_4                                                       *
+ *                                                                         *
+ * max_word: 0 for the smallest key, 1 for the greatest key.               *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Min_Max_4(WamWord map_word, WamWord key_word, WamWord val_word,
+		  WamWord max_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  Bool max = Pl_Rd_Integer_Check(max_word);
+  WamWord *adr;
+
+  if (Is_Empty(t_word))
+    return FALSE;
+
+  for (;;)
+    {
+      adr = UnTag_STC(t_word);
+      t_word = (max) ? Node_Right(adr) : Node_Left(adr);
+      if (Is_Empty(t_word))
+	break;
+    }
+
+  return Pl_Unify(Node_Key(adr), key_word) &&
+    Pl_Unify(Node_Val(adr), val_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_RANGE_4                                                         *
+ *                                                                         *
+ * Unify pairs_word with the ordered list of Key-Value such that           *
+ * Lo @=< Key @=< Hi.                                                      *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Range_4(WamWord map_word, WamWord lo_word, WamWord hi_word,
+		WamWord pairs_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  Pl_Check_For_Un_List(pairs_word);
+
+  return Pl_Unify(Range(t_word, lo_word, hi_word, NIL_WORD), pairs_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_TO_LIST_2                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_To_List_2(WamWord map_word, WamWord pairs_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  Pl_Check_For_Un_List(pairs_word);
+
+  return Pl_Unify(Range(t_word, NOT_A_WAM_WORD, NOT_A_WAM_WORD, NIL_WORD),
+		  pairs_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_LIST_TO_OMAP_2                                                       *
+ *                                                                         *
+ * Later pairs replace earlier ones with the same key.                     *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_List_To_Omap_2(WamWord pairs_word, WamWord map_word)
+{
+  WamWord word, tag_mask;
+  WamWord save_pairs_word = pairs_word;
+  WamWord t_word = empty_word;
+  WamWord *adr;
+
+  for (;;)
+    {
+      DEREF(pairs_word, word, tag_mask);
+      if (word == NIL_WORD)
+	break;
+
+      if (tag_mask == TAG_REF_MASK)
+	Pl_Err_Instantiation();
+
+      if (tag_mask != TAG_LST_MASK)
+	Pl_Err_Type(pl_type_list, save_pairs_word);
+
+      adr = UnTag_LST(word);
+      DEREF(Car(adr), word, tag_mask);
+      if (tag_mask == TAG_REF_MASK)
+	Pl_Err_Instantiation();
+
+      if (tag_mask != TAG_STC_MASK ||
+	  Functor_And_Arity(UnTag_STC(word)) != Functor_Arity(ATOM_CHAR('-'), 2))
+	Pl_Err_Type(pl_type_pair, word);
+
+      t_word = Insert(t_word, Safe_Word(Arg(UnTag_STC(word), 0)),
+		      Safe_Word(Arg(UnTag_STC(word), 1)));
+
+      pairs_word = Cdr(adr);
+    }
+
+  return Pl_Unify(t_word, map_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OMAP_SIZE_2                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Omap_Size_2(WamWord map_word, WamWord size_word)
+{
+  WamWord t_word = Rd_Map_Check(map_word);
+  Pl_Check_For_Un_Integer(size_word);
+
+  return Pl_Get_Integer(Size(t_word), size_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RD_MAP_CHECK                                                            *
+ *                                                                         *
+ * Check a map (only its root) and return it dereferenced.                 *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Rd_Map_Check(WamWord map_word)
+{
+  WamWord word, tag_mask;
+
+  DEREF(map_word, word, tag_mask);
+  if (tag_mask == TAG_REF_MASK)
+    Pl_Err_Instantiation();
+
+  if (word != empty_word &&
+      (tag_mask != TAG_STC_MASK ||
+       Functor_And_Arity(UnTag_STC(word)) != Functor_Arity(atom_t, 5)))
+    Pl_Err_Domain(pl_domain_ordered_map, word);
+
+  return word;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SAFE_WORD                                                               *
+ *                                                                         *
+ * Return a word which can be stored in a node (see above).                *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Safe_Word(WamWord start_word)
+{
+  WamWord word, tag_mask;
+  WamWord *adr;
+
+  DEREF(start_word, word, tag_mask);
+  if (tag_mask == TAG_REF_MASK && Is_A_Local_Adr(adr = UnTag_REF(word)))
+    Globalize_Local_Unbound_Var(adr, word);
+
+  Do_Copy_Of_Word(tag_mask, word);
+  return word;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * HEIGHT                                                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Height(WamWord t_word)
+{
+  return (Is_Empty(t_word)) ? 0 : Node_Height(UnTag_STC(t_word));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MK_NODE                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Mk_Node(WamWord k, WamWord v, WamWord l, WamWord r)
+{
+  WamWord *adr = H;
+  int hl = Height(l);
+  int hr = Height(r);
+
+  H[0] = Functor_Arity(atom_t, 5);
+  H[1] = k;
+  H[2] = v;
+  H[3] = Tag_INT(((hl > hr) ? hl : hr) + 1);
+  H[4] = l;
+  H[5] = r;
+  H += 6;
+
+  return Tag_STC(adr);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BALANCE                                                                 *
+ *                                                                         *
+ * Create a node k/v with the subtrees l and r (whose heights differ by 2  *
+ * at most) performing a single or a double rotation if needed.            *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Balance(WamWord k, WamWord v, WamWord l, WamWord r)
+{
+  int hl = Height(l);
+  int hr = Height(r);
+  WamWord *a, *b;
+
+  if (hl > hr + 1)
+    {
+      a = UnTag_STC(l);
+      if (Height(Node_Left(a)) >= Height(Node_Right(a)))
+	return Mk_Node(Node_Key(a), Node_Val(a), Node_Left(a),
+		       Mk_Node(k, v, Node_Right(a), r));
+
+      b = UnTag_STC(Node_Right(a));
+      return Mk_Node(Node_Key(b), Node_Val(b),
+		     Mk_Node(Node_Key(a), Node_Val(a), Node_Left(a),
+			     Node_Left(b)),
+		     Mk_Node(k, v, Node_Right(b), r));
+    }
+
+  if (hr > hl + 1)
+    {
+      a = UnTag_STC(r);
+      if (Height(Node_Right(a)) >= Height(Node_Left(a)))
+	return Mk_Node(Node_Key(a), Node_Val(a),
+		       Mk_Node(k, v, l, Node_Left(a)), Node_Right(a));
+
+      b = UnTag_STC(Node_Left(a));
+      return Mk_Node(Node_Key(b), Node_Val(b),
+		     Mk_Node(k, v, l, Node_Left(b)),
+		     Mk_Node(Node_Key(a), Node_Val(a), Node_Right(b),
+			     Node_Right(a)));
+    }
+
+  return Mk_Node(k, v, l, r);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INSERT                                                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Insert(WamWord t_word, WamWord key_word, WamWord val_word)
+{
+  WamWord *adr;
+  PlLong cmp;
+
+  if (Is_Empty(t_word))
+    return Mk_Node(key_word, val_word, empty_word, empty_word);
+
+  adr = UnTag_STC(t_word);
+  cmp = Pl_Term_Compare(key_word, Node_Key(adr));
+
+  if (cmp == 0)
+    return Mk_Node(key_word, val_word, Node_Left(adr), Node_Right(adr));
+
+  if (cmp < 0)
+    return Balance(Node_Key(adr), Node_Val(adr),
+		   Insert(Node_Left(adr), key_word, val_word),
+		   Node_Right(adr));
+
+  return Balance(Node_Key(adr), Node_Val(adr), Node_Left(adr),
+		 Insert(Node_Right(adr), key_word, val_word));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DELETE                                                                  *
+ *                                                                         *
+ * Return the tree without key_word and set del_val_word to its value (if  *
+ * the key does not exist del_val_word is unchanged and t_word returned).  *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Delete(WamWord t_word, WamWord key_word)
+{
+  WamWord *adr;
+  WamWord l, r;
+  PlLong cmp;
+
+  if (Is_Empty(t_word))
+    return t_word;
+
+  adr = UnTag_STC(t_word);
+  cmp = Pl_Term_Compare(key_word, Node_Key(adr));
+
+  if (cmp < 0)
+    {
+      l = Delete(Node_Left(adr), key_word);
+      return (l == Node_Left(adr)) ? t_word :
+	Balance(Node_Key(adr), Node_Val(adr), l, Node_Right(adr));
+    }
+
+  if (cmp > 0)
+    {
+      r = Delete(Node_Right(adr), key_word);
+      return (r == Node_Right(adr)) ? t_word :
+	Balance(Node_Key(adr), Node_Val(adr), Node_Left(adr), r);
+    }
+
+  del_val_word = Node_Val(adr);
+
+  if (Is_Empty(Node_Left(adr)))
+    return Node_Right(adr);
+
+  if (Is_Empty(Node_Right(adr)))
+    return Node_Left(adr);
+
+  r = Delete_Min(Node_Right(adr));	/* the successor replaces the node */
+  return Balance(min_key_word, min_val_word, Node_Left(adr), r);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DELETE_MIN                                                              *
+ *                                                                         *
+ * Return the (non empty) tree without its smallest key, set min_key_word  *
+ * and min_val_word to this key and its value.                             *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Delete_Min(WamWord t_word)
+{
+  WamWord *adr = UnTag_STC(t_word);
+
+  if (Is_Empty(Node_Left(adr)))
+    {
+      min_key_word = Node_Key(adr);
+      min_val_word = Node_Val(adr);
+      return Node_Right(adr);
+    }
+
+  return Balance(Node_Key(adr), Node_Val(adr), Delete_Min(Node_Left(adr)),
+		 Node_Right(adr));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RANGE                                                                   *
+ *                                                                         *
+ * Return the list of Key-Value (followed by tail_word) of the tree whose  *
+ * keys are in lo_word..hi_word (NOT_A_WAM_WORD: no bound). The tree is    *
+ * traversed from right to left to build the list from its end.            *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Range(WamWord t_word, WamWord lo_word, WamWord hi_word, WamWord tail_word)
+{
+  WamWord *adr;
+  Bool above_lo, below_hi;
+
+  while (!Is_Empty(t_word))
+    {
+      adr = UnTag_STC(t_word);
+      above_lo = (lo_word == NOT_A_WAM_WORD ||
+		  Pl_Term_Compare(Node_Key(adr), lo_word) >= 0);
+      below_hi = (hi_word == NOT_A_WAM_WORD ||
+		  Pl_Term_Compare(Node_Key(adr), hi_word) <= 0);
+
+      if (below_hi)
+	{
+	  tail_word = Range(Node_Right(adr), lo_word, hi_word, tail_word);
+	  if (above_lo)
+	    tail_word = Mk_Pair_Cons(Node_Key(adr), Node_Val(adr), tail_word);
+	}
+
+      if (!above_lo)
+	break;
+
+      t_word = Node_Left(adr);
+    }
+
+  return tail_word;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MK_PAIR_CONS                                                            *
+ *                                                                         *
+ * Return the list [K-V|tail_word].                                        *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Mk_Pair_Cons(WamWord k, WamWord v, WamWord tail_word)
+{
+  WamWord *adr = H;
+
+  H[0] = Functor_Arity(ATOM_CHAR('-'), 2);
+  H[1] = k;
+  H[2] = v;
+  H[3] = Tag_STC(adr);
+  H[4] = tail_word;
+  H += 5;
+
+  return Tag_LST(adr + 3);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SIZE                                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static PlLong
+Size(WamWord t_word)
+{
+  WamWord *adr;
+  PlLong n = 0;
+
+  while (!Is_Empty(t_word))
+    {
+      adr = UnTag_STC(t_word);
+      n += 1 + Size(Node_Left(adr));
+      t_word = Node_Right(adr);
+    }
+
+  return n;
+}
@@ -38,6 +38,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <math.h>
 #include <string.h>
 #include <errno.h>
@@ -61,6 +62,12 @@
 #include <sys/param.h>
 #include <sys/time.h>
 #include <sys/wait.h>
+#include <poll.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#define USE_EPOLL
 #endif
 
 #define OBJ_INIT Os_Interf_Initializer
@@ -83,6 +90,11 @@
 #define MAX_SIGNALS                255
 #define MAX_SPAWN_ARGS             1024
 
+#define POLLER_READ                1
+#define POLLER_WRITE               2
+
+#define POLLER_MAX_EVENTS          1024	/* max ready items per wait */
+
 
 
 
@@ -98,6 +110,31 @@ typedef struct
 InfSig;
 
 
+typedef struct			/* Item registered in a poller    */
+{				/* ------------------------------ */
+  int fd;			/* its file descriptor            */
+  int stm;			/* its stream (-1 if a raw fd)    */
+  int events;			/* POLLER_READ and/or POLLER_WRITE*/
+  int ready;			/* ready events (during a wait)   */
+}
+PollItem;
+
+
+typedef struct			/* Poller                         */
+{				/* ------------------------------ */
+  int epfd;			/* the epoll descriptor           */
+  PollItem *item;		/* registered items (dense)       */
+  int nb_item;			/* number of registered items     */
+  int item_size;		/* allocated size of item         */
+  int *pos;			/* fd -> index in item (or -1)    */
+  int pos_size;			/* allocated size of pos          */
+#ifndef USE_EPOLL
+  struct pollfd *pfd;		/* parallel to item (for poll())  */
+#endif
+}
+PollerInf;
+
+
 
 
 /*---------------------------------*
@@ -121,6 +158,12 @@ static int atom_unknown;
 static InfSig tsig[MAX_SIGNALS];
 static int nb_sig;
 
+static int atom_read;
+static int atom_write;
+
+static PollerInf **poller_tbl;	/* poller number -> PollerInf (or NULL) */
+static int poller_tbl_size;
+
 
 
 
@@ -139,6 +182,25 @@ static int Select_Init_Set(WamWord list_word, fd_set *set, int check);
 static Bool Select_Init_Ready_List(WamWord list_word, fd_set *set,
 				   WamWord ready_list_word);
 
+#ifndef _WIN32
+
+static PollerInf *Get_Poller(WamWord poller_word);
+
+static PollItem *Get_Poll_Item(PollerInf *p, WamWord item_word,
+			       Bool must_exist);
+
+static Bool Poll_Item_Is_Closed(PollItem *it);
+
+static int Rd_Poll_Events(WamWord events_word);
+
+static Bool Poller_Ctl(PollerInf *p, PollItem *it, int op);
+
+static void Poller_Remove_Item(PollerInf *p, PollItem *it);
+
+static WamWord Mk_Poll_Ready(PollItem *it);
+
+#endif
+
 
 
 
@@ -154,6 +216,9 @@ Os_Interf_Initializer(void)
   atom_execute = Pl_Create_Atom("execute");
   atom_search = Pl_Create_Atom("search");
 
+  atom_read = Pl_Create_Atom("read");
+  atom_write = Pl_Create_Atom("write");
+
   atom_regular = Pl_Create_Atom("regular");
   atom_directory = Pl_Create_Atom("directory");
   atom_fifo = Pl_Create_Atom("fifo");
@@ -1336,6 +1401,582 @@ Select_Init_Ready_List(WamWord list_word, fd_set *set,
 
 
 
+/*-------------------------------------------------------------------------*
+ * A poller is a (scalable) alternative to select/5: the set of streams or *
+ * file descriptors to watch is registered once (poller_add/3, ...) and    *
+ * poller_wait/3 returns the list of ready items (at most                  *
+ * POLLER_MAX_EVENTS per call) as Item-Events pairs. It is based on epoll  *
+ * under Linux and on poll() elsewhere (there is no FD_SETSIZE limit).     *
+ *                                                                         *
+ * An input stream with chars (other than layout) already read in its     *
+ * block buffer is ready even if its descriptor is not (e.g. several terms *
+ * received at once). Ready means that chars can be read without waiting, *
+ * not that a whole term is available.                                     *
+ * A closed stream is automatically removed from the poller.               *
+ * A poller is identified by an integer (index in poller_tbl).             *
+ *-------------------------------------------------------------------------*/
+
+#ifdef _WIN32
+
+#define POLLER_NOT_IMPLEMENTED			\
+  Pl_Err_Resource(Pl_Create_Atom("not implemented"))
+
+Bool
+Pl_Poller_Create_1(WamWord poller_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+  return FALSE;
+}
+
+void
+Pl_Poller_Close_1(WamWord poller_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+}
+
+Bool
+Pl_Poller_Add_3(WamWord poller_word, WamWord item_word, WamWord events_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+  return FALSE;
+}
+
+Bool
+Pl_Poller_Modify_3(WamWord poller_word, WamWord item_word,
+		   WamWord events_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+  return FALSE;
+}
+
+Bool
+Pl_Poller_Remove_2(WamWord poller_word, WamWord item_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+  return FALSE;
+}
+
+Bool
+Pl_Poller_Wait_3(WamWord poller_word, WamWord ready_word,
+		 WamWord time_out_word)
+{
+  POLLER_NOT_IMPLEMENTED;
+  return FALSE;
+}
+
+#else
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_CREATE_1                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Poller_Create_1(WamWord poller_word)
+{
+  PollerInf *p;
+  int n;
+
+  Pl_Check_For_Un_Variable(poller_word);
+
+  for (n = 0; n < poller_tbl_size; n++)
+    if (poller_tbl[n] == NULL)
+      break;
+
+  if (n == poller_tbl_size)
+    {
+      poller_tbl_size = (poller_tbl_size == 0) ? 8 : poller_tbl_size * 2;
+      poller_tbl = (PollerInf **) Realloc((char *) poller_tbl,
+					  poller_tbl_size * sizeof(PollerInf *));
+      memset(poller_tbl + n, 0, (poller_tbl_size - n) * sizeof(PollerInf *));
+    }
+
+  p = (PollerInf *) Calloc(1, sizeof(PollerInf));
+#ifdef USE_EPOLL
+  p->epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (p->epfd < 0)
+    {
+      Free(p);
+      Os_Test_Error(-1);
+    }
+#else
+  p->epfd = -1;
+#endif
+
+  poller_tbl[n] = p;
+
+  return Pl_Get_Integer(n, poller_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_CLOSE_1                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Poller_Close_1(WamWord poller_word)
+{
+  PollerInf *p = Get_Poller(poller_word);
+
+  if (p->epfd >= 0)
+    close(p->epfd);
+
+  Free(p->item);
+  Free(p->pos);
+#ifndef USE_EPOLL
+  Free(p->pfd);
+#endif
+
+  poller_tbl[Pl_Rd_Integer(poller_word)] = NULL;
+  Free(p);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_ADD_3                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Poller_Add_3(WamWord poller_word, WamWord item_word, WamWord events_word)
+{
+  PollerInf *p = Get_Poller(poller_word);
+  int events = Rd_Poll_Events(events_word);
+  PollItem *it = Get_Poll_Item(p, item_word, FALSE);
+  int op = (it->events == 0) ? 0 : 1;	/* already registered: modify */
+
+  it->events = events;
+  return Poller_Ctl(p, it, op);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_MODIFY_3                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Poller_Modify_3(WamWord poller_word, WamWord item_word,
+		   WamWord events_word)
+{
+  PollerInf *p = Get_Poller(poller_word);
+  int events = Rd_Poll_Events(events_word);
+  PollItem *it = Get_Poll_Item(p, item_word, TRUE);
+
+  it->events = events;
+  return Poller_Ctl(p, it, 1);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_REMOVE_2                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Poller_Remove_2(WamWord poller_word, WamWord item_word)
+{
+  PollerInf *p = Get_Poller(poller_word);
+  PollItem *it = Get_Poll_Item(p, item_word, TRUE);
+
+  Poller_Ctl(p, it, 2);
+  Poller_Remove_Item(p, it);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_POLLER_WAIT_3                                                        *
+ *                                                                         *
+ * TimeOut is in ms (< 0: no limit, 0: only check). The ready list is     *
+ * empty if the time out is reached.                                       *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Poller_Wait_3(WamWord poller_word, WamWord ready_word,
+		 WamWord time_out_word)
+{
+  PollerInf *p = Get_Poller(poller_word);
+  PollItem *it;
+  double time_out;
+  int ms;
+  int ready[POLLER_MAX_EVENTS];
+  int nb_ready = 0;
+  int i, n, r;
+  WamWord word, list_word;
+#ifdef USE_EPOLL
+  struct epoll_event ev[POLLER_MAX_EVENTS];
+#endif
+
+  Pl_Check_For_Un_List(ready_word);
+
+  time_out = Pl_Rd_Number_Check(time_out_word);
+  ms = (time_out < 0) ? -1 : (time_out > INT_GREATEST_VALUE) ? INT_MAX :
+    (int) time_out;
+
+				/* input already in a stream buffer */
+  for (i = 0; i < p->nb_item; i++)
+    {
+      it = p->item + i;
+      if (it->stm < 0)
+	continue;
+
+      if (Poll_Item_Is_Closed(it))
+	{
+	  Poller_Ctl(p, it, 2);
+	  Poller_Remove_Item(p, it);
+	  i--;
+	  continue;
+	}
+
+      if ((it->events & POLLER_READ) && nb_ready < POLLER_MAX_EVENTS &&
+	  Pl_Stream_Input_Pending(pl_stm_tbl[it->stm]))
+	{
+	  it->ready = POLLER_READ;
+	  ready[nb_ready++] = it->fd;
+	}
+    }
+
+  if (nb_ready > 0)
+    ms = 0;
+
+#ifdef USE_EPOLL			/* maxevents must be > 0 */
+  n = (nb_ready < POLLER_MAX_EVENTS) ?
+    epoll_wait(p->epfd, ev, POLLER_MAX_EVENTS - nb_ready, ms) : 0;
+  if (n < 0 && errno != EINTR)
+    Os_Test_Error(-1);
+
+  for (i = 0; i < n; i++)
+    {
+      if (p->pos[ev[i].data.fd] < 0)	/* removed meanwhile */
+	continue;
+      it = p->item + p->pos[ev[i].data.fd];
+      r = 0;
+      if (ev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+	r |= POLLER_READ;
+      if (ev[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+	r |= POLLER_WRITE;
+#else
+  n = poll(p->pfd, p->nb_item, ms);
+  if (n < 0 && errno != EINTR)
+    Os_Test_Error(-1);
+
+  for (i = 0; n > 0 && i < p->nb_item && nb_ready < POLLER_MAX_EVENTS; i++)
+    {
+      if (p->pfd[i].revents == 0)
+	continue;
+      it = p->item + i;
+      r = 0;
+      if (p->pfd[i].revents & (POLLIN | POLLHUP | POLLERR))
+	r |= POLLER_READ;
+      if (p->pfd[i].revents & (POLLOUT | POLLHUP | POLLERR))
+	r |= POLLER_WRITE;
+#endif
+      r &= it->events;
+      if (r == 0)
+	continue;
+      if (it->ready == 0)
+	ready[nb_ready++] = it->fd;
+      it->ready |= r;
+    }
+
+				/* build the list of Item-Events */
+  list_word = NIL_WORD;
+  for (i = nb_ready - 1; i >= 0; i--)
+    {
+      it = p->item + p->pos[ready[i]];
+      word = Mk_Poll_Ready(it);
+      it->ready = 0;
+      H[0] = word;
+      H[1] = list_word;
+      list_word = Tag_LST(H);
+      H += 2;
+    }
+
+  return Pl_Unify(list_word, ready_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_POLLER                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static PollerInf *
+Get_Poller(WamWord poller_word)
+{
+  int n = Pl_Rd_Integer_Check(poller_word);
+
+  if (n < 0 || n >= poller_tbl_size || poller_tbl[n] == NULL)
+    Pl_Err_Existence(pl_existence_poller, poller_word);
+
+  return poller_tbl[n];
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_POLL_ITEM                                                           *
+ *                                                                         *
+ * An item is a file descriptor (integer) or a stream (or alias).          *
+ *-------------------------------------------------------------------------*/
+static PollItem *
+Get_Poll_Item(PollerInf *p, WamWord item_word, Bool must_exist)
+{
+  WamWord word, tag_mask;
+  int stm = -1;
+  int fd;
+  int i;
+  PollItem *it;
+
+  DEREF(item_word, word, tag_mask);
+  if (tag_mask == TAG_INT_MASK)
+    fd = Pl_Rd_C_Int_Positive_Check(word);
+  else
+    {
+      stm = Pl_Get_Stream_Or_Alias(word, STREAM_CHECK_EXIST);
+
+      fd = Pl_Io_Fileno_Of_Stream(stm);
+      if (fd < 0)
+	Pl_Err_Domain(pl_domain_selectable_item, word);
+    }
+
+  if (fd < p->pos_size && p->pos[fd] >= 0)
+    {
+      it = p->item + p->pos[fd];
+      if (!Poll_Item_Is_Closed(it))
+	return it;
+
+      Poller_Ctl(p, it, 2);	/* a closed stream not yet removed */
+      Poller_Remove_Item(p, it);
+    }
+
+  if (must_exist)
+    Pl_Err_Existence((stm < 0) ? pl_domain_selectable_item :
+		     pl_existence_stream, word);
+
+  if (fd >= p->pos_size)
+    {
+      i = p->pos_size;
+      p->pos_size = (fd < 2 * i) ? 2 * i : fd + 1;
+      p->pos = (int *) Realloc((char *) p->pos, p->pos_size * sizeof(int));
+      for (; i < p->pos_size; i++)
+	p->pos[i] = -1;
+    }
+
+  if (p->nb_item == p->item_size)
+    {
+      p->item_size = (p->item_size == 0) ? 16 : p->item_size * 2;
+      p->item = (PollItem *) Realloc((char *) p->item,
+				     p->item_size * sizeof(PollItem));
+#ifndef USE_EPOLL
+      p->pfd = (struct pollfd *) Realloc((char *) p->pfd,
+					 p->item_size * sizeof(struct pollfd));
+#endif
+    }
+
+  p->pos[fd] = p->nb_item;
+  it = p->item + p->nb_item++;
+  it->fd = fd;
+  it->stm = stm;
+  it->events = 0;
+  it->ready = 0;
+
+  return it;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * POLL_ITEM_IS_CLOSED                                                     *
+ *                                                                         *
+ * Has the stream of an item been closed (since its registration)?        *
+ *-------------------------------------------------------------------------*/
+static Bool
+Poll_Item_Is_Closed(PollItem *it)
+{
+  return it->stm >= 0 && (pl_stm_tbl[it->stm] == NULL ||
+			  Pl_Io_Fileno_Of_Stream(it->stm) != it->fd);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RD_POLL_EVENTS                                                          *
+ *                                                                         *
+ * Events is a non-empty list of read/write.                               *
+ *-------------------------------------------------------------------------*/
+static int
+Rd_Poll_Events(WamWord events_word)
+{
+  WamWord word, tag_mask;
+  WamWord save_events_word = events_word;
+  WamWord *lst_adr;
+  int atom;
+  int events = 0;
+
+  for (;;)
+    {
+      DEREF(events_word, word, tag_mask);
+
+      if (tag_mask == TAG_REF_MASK)
+	Pl_Err_Instantiation();
+
+      if (word == NIL_WORD)
+	break;
+
+      if (tag_mask != TAG_LST_MASK)
+	Pl_Err_Type(pl_type_list, save_events_word);
+
+      lst_adr = UnTag_LST(word);
+      atom = Pl_Rd_Atom_Check(Car(lst_adr));
+      if (atom == atom_read)
+	events |= POLLER_READ;
+      else if (atom == atom_write)
+	events |= POLLER_WRITE;
+      else
+	Pl_Err_Domain(pl_domain_poll_event, Car(lst_adr));
+
+      events_word = Cdr(lst_adr);
+    }
+
+  if (events == 0)
+    Pl_Err_Domain(pl_domain_poll_event, save_events_word);
+
+  return events;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * POLLER_CTL                                                              *
+ *                                                                         *
+ * op: 0 (add), 1 (modify), 2 (remove). Errors on a removal are ignored    *
+ * (the descriptor is maybe already closed).                               *
+ *-------------------------------------------------------------------------*/
+static Bool
+Poller_Ctl(PollerInf *p, PollItem *it, int op)
+{
+#ifdef USE_EPOLL
+  static int epoll_op[] = { EPOLL_CTL_ADD, EPOLL_CTL_MOD, EPOLL_CTL_DEL };
+  struct epoll_event ev;
+
+  ev.events = ((it->events & POLLER_READ) ? EPOLLIN : 0) |
+    ((it->events & POLLER_WRITE) ? EPOLLOUT : 0);
+  ev.data.u64 = 0;
+  ev.data.fd = it->fd;
+
+  if (epoll_ctl(p->epfd, epoll_op[op], it->fd, &ev) < 0 && op != 2)
+    {
+      if (op == 0)		/* not registered: undo */
+	Poller_Remove_Item(p, it);
+      Os_Test_Error(-1);
+    }
+#else
+  struct pollfd *pfd = p->pfd + (it - p->item);
+
+  pfd->fd = it->fd;
+  pfd->events = ((it->events & POLLER_READ) ? POLLIN : 0) |
+    ((it->events & POLLER_WRITE) ? POLLOUT : 0);
+  pfd->revents = 0;
+#endif
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * POLLER_REMOVE_ITEM                                                      *
+ *                                                                         *
+ * The last item takes the place of the removed one.                       *
+ *-------------------------------------------------------------------------*/
+static void
+Poller_Remove_Item(PollerInf *p, PollItem *it)
+{
+  int i = it - p->item;
+  int last = --p->nb_item;
+
+  p->pos[it->fd] = -1;
+  if (i == last)
+    return;
+
+  p->item[i] = p->item[last];
+#ifndef USE_EPOLL
+  p->pfd[i] = p->pfd[last];
+#endif
+  p->pos[p->item[i].fd] = i;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MK_POLL_READY                                                           *
+ *                                                                         *
+ * Create Item-Events on the heap.                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Mk_Poll_Ready(PollItem *it)
+{
+  WamWord *adr;
+  WamWord item_word, events_word;
+
+  if (it->stm >= 0)
+    {
+      H[0] = Functor_Arity(pl_atom_stream, 1);
+      H[1] = Tag_INT(it->stm);
+      item_word = Tag_STC(H);
+      H += 2;
+    }
+  else
+    item_word = Tag_INT(it->fd);
+
+  events_word = NIL_WORD;
+  if (it->ready & POLLER_WRITE)
+    {
+      H[0] = Tag_ATM(atom_write);
+      H[1] = events_word;
+      events_word = Tag_LST(H);
+      H += 2;
+    }
+  if (it->ready & POLLER_READ)
+    {
+      H[0] = Tag_ATM(atom_read);
+      H[1] = events_word;
+      events_word = Tag_LST(H);
+      H += 2;
+    }
+
+  adr = H;
+  H[0] = Functor_Arity(ATOM_CHAR('-'), 2);
+  H[1] = item_word;
+  H[2] = events_word;
+  H += 3;
+
+  return Tag_STC(adr);
+}
+
+#endif /* !_WIN32 */
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_PROLOG_PID_1                                                         *
  *                                                                         *
@@ -63,18 +63,34 @@
 #define INSIDE_ANY_OP              2
 
 
+#define DICO_VAR_HASH_SIZE         (2 * MAX_VAR_IN_TERM) /* power of 2 */
+
+
 
 
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* Variable dico hash entry       */
+{				/* ------------------------------ */
+  unsigned stamp;		/* valid if == dico_var_stamp     */
+  int index;			/* index in pl_parse_dico_var[]   */
+}
+DicoVarHash;
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
 
 static StmInf *pstm_i;
 
+static DicoVarHash dico_var_hash[DICO_VAR_HASH_SIZE];
+static unsigned dico_var_stamp;
+
 static Bool tok_present;
 static TokInf unget_tok;
 
@@ -117,14 +133,27 @@ static int Lookup_In_Dico_Var(char *name);
 static void Parse_Error(char *err_msg);
 
 
-/* we simply save line/col (for error report) to avoid to 
- * duplicate the entire token (with the big buffer for names).
- * After Unget_Token it is possible to restore pl_token.line/col */
+/* we only copy the used part of the name to avoid to duplicate the
+ * entire token (with the big buffer for names) at each Unget_Token.
+ * After Unget_Token it is possible to modify pl_token (e.g. line/col) */
+
+#define Copy_Token(dst, src)					\
+do {								\
+  (dst).type = (src).type;					\
+  (dst).quoted = (src).quoted;					\
+  (dst).punct = (src).punct;					\
+  (dst).int_num = (src).int_num;				\
+  (dst).float_num = (src).float_num;				\
+  (dst).line = (src).line;					\
+  (dst).col = (src).col;					\
+  memcpy((dst).name, (src).name, strlen((src).name) + 1);	\
+} while(0)
+
 
 #define Unget_Token				\
 do {						\
   tok_present = TRUE;				\
-  unget_tok = pl_token;				\
+  Copy_Token(unget_tok, pl_token);		\
 } while(0)
 
 
@@ -169,7 +198,7 @@ Read_Next_Token(Bool comma_is_punct)
   if (tok_present)
     {
       tok_present = FALSE;
-      pl_token = unget_tok;
+      Copy_Token(pl_token, unget_tok);
       if (comma_is_punct && pl_token.type == TOKEN_NAME &&  !pl_token.quoted &&
 	  pl_token.name[0] == ',' && pl_token.name[1] == '\0')
 	{
@@ -209,6 +238,11 @@ Pl_Read_Term(StmInf *pstm, int parse_end_of_term)
   pl_use_le_prompt = 1;
 
   pl_parse_nb_var = 0;
+  if (++dico_var_stamp == 0)	/* wrap around: invalidate all entries */
+    {
+      memset(dico_var_hash, 0, sizeof(dico_var_hash));
+      dico_var_stamp = 1;
+    }
   pl_last_read_line = -1;
 
   pstm_i = pstm;
@@ -216,7 +250,8 @@ Pl_Read_Term(StmInf *pstm, int parse_end_of_term)
   tok_present = FALSE;
   Save_Machine_Regs(buff_save_machine_regs);
 
-  jmp_val = sigsetjmp(jumper, 1);
+  /* no need to save the signal mask: Parse_Error() is synchronous */
+  jmp_val = sigsetjmp(jumper, 0);
 
   Restore_Machine_Regs(buff_save_machine_regs);
 
@@ -428,8 +463,9 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
 	}
 
 
-      /* maybe a prefix operator */
-      if ((oper = Pl_Lookup_Oper(atom, PREFIX)) && cur_prec >= oper->prec)
+      /* maybe a prefix operator (op_mask avoids most hash lookups) */
+      if (Check_Oper(atom, PREFIX) &&
+	  (oper = Pl_Lookup_Oper(atom, PREFIX)) && cur_prec >= oper->prec)
 	{
 	  /* try a prefix operator */
 	  cur_left = oper->prec;
@@ -469,7 +505,8 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
 
 #if 1 /* to allow | to be unquoted if it is an infix operator with prec > 1000 */
       if (pl_token.type == TOKEN_PUNCTUATION && pl_token.punct == '|' &&
-	  (oper = Pl_Lookup_Oper(atom = ATOM_CHAR('|'), INFIX)) && oper->prec > 1000 && cur_prec >= oper->prec)
+	  Check_Oper(atom = ATOM_CHAR('|'), INFIX) &&
+	  (oper = Pl_Lookup_Oper(atom, INFIX)) && oper->prec > 1000 && cur_prec >= oper->prec)
 	infix_op = TRUE;
       else
 #endif
@@ -478,6 +515,9 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
 	    break;
 
 	  atom = Pl_Create_Allocate_Atom(pl_token.name);
+	  if (!Check_Oper(atom, INFIX) && !Check_Oper(atom, POSTFIX))
+	    break;
+
 	  if ((oper = Pl_Lookup_Oper(atom, INFIX)))
 	    infix_op = TRUE;
 	  else if ((oper = Pl_Lookup_Oper(atom, POSTFIX)))
@@ -606,58 +646,72 @@ Parse_Bracketed_Term(void)
 /*-------------------------------------------------------------------------*
  * PARSE_LIST                                                              *
  *                                                                         *
+ * The list is built iteratively (each new cell is linked to the cdr of    *
+ * the previous one) so that long lists do not consume the C stack.        *
  *-------------------------------------------------------------------------*/
 static WamWord
 Parse_List(Bool can_be_empty)
 {
-  WamWord term;
-  WamWord car_word, cdr_word = 0; /* init for the compiler */
+  WamWord list_word = NOT_A_WAM_WORD;
+  WamWord car_word, cdr_word, lst_word;
+  WamWord *cdr_adr = NULL;
 
 
-  car_word = Parse_Term(MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, TRUE);
+  for (;;)
+    {
+      car_word = Parse_Term(MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, TRUE);
 
-  Read_Next_Token(TRUE);
+      Read_Next_Token(TRUE);
 
-  if (car_word == NOT_A_WAM_WORD)
-    {
-      if (!can_be_empty)
-	Parse_Error("expression expected in list");
-      else if (pl_token.type != TOKEN_PUNCTUATION || pl_token.punct != ']')
-	Parse_Error("expression or ] expected in list");
+      if (car_word == NOT_A_WAM_WORD)
+	{
+	  if (!can_be_empty)
+	    Parse_Error("expression expected in list");
+	  else if (pl_token.type != TOKEN_PUNCTUATION || pl_token.punct != ']')
+	    Parse_Error("expression or ] expected in list");
 
-      return NOT_A_WAM_WORD;
-    }
+	  return NOT_A_WAM_WORD;
+	}
 
 
-  if (pl_token.type != TOKEN_PUNCTUATION || !strchr(",|]", pl_token.punct))
-    Parse_Error(", | ] or operator expected in list");
+      if (pl_token.type != TOKEN_PUNCTUATION || !strchr(",|]", pl_token.punct))
+	Parse_Error(", | ] or operator expected in list");
 
-  switch (pl_token.punct)
-    {
-    case ',':			/* [X,Y...] */
-      cdr_word = Parse_List(FALSE);
-      break;
+      lst_word = Pl_Put_List();
+      Pl_Unify_Value(car_word);
+      Pl_Unify_Value(NIL_WORD);	/* the cdr is updated below */
 
-    case '|':			/* [X|Y] */
-      cdr_word = Parse_Term(MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, COMMA_ANY);
-      if (cdr_word == NOT_A_WAM_WORD)
-	Parse_Error("expression expected in list");
+      if (cdr_adr == NULL)
+	list_word = lst_word;
+      else
+	*cdr_adr = lst_word;
 
-      Read_Next_Token(TRUE);
-      if (pl_token.type != TOKEN_PUNCTUATION || pl_token.punct != ']')
-	Parse_Error("] or operator expected in list");
-      break;
+      cdr_adr = &Cdr(UnTag_LST(lst_word));
 
-    case ']':			/* [X] */
-      cdr_word = NIL_WORD;	/* faster than Pl_Put_Nil() */
-      break;
-    }
+      switch (pl_token.punct)
+	{
+	case ',':			/* [X,Y...] */
+	  can_be_empty = FALSE;
+	  continue;
 
-  term = Pl_Put_List();
-  Pl_Unify_Value(car_word);
-  Pl_Unify_Value(cdr_word);
+	case '|':			/* [X|Y] */
+	  cdr_word = Parse_Term(MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, COMMA_ANY);
+	  if (cdr_word == NOT_A_WAM_WORD)
+	    Parse_Error("expression expected in list");
 
-  return term;
+	  Read_Next_Token(TRUE);
+	  if (pl_token.type != TOKEN_PUNCTUATION || pl_token.punct != ']')
+	    Parse_Error("] or operator expected in list");
+
+	  *cdr_adr = cdr_word;
+	  break;
+
+	case ']':			/* [X] */
+	  break;
+	}
+
+      return list_word;
+    }
 }
 
 
@@ -696,18 +750,36 @@ Create_Structure(int func, int arity, WamWord *arg)
 /*-------------------------------------------------------------------------*
  * LOOKUP_IN_DICO_VAR                                                      *
  *                                                                         *
+ * Named variables are found via an open addressing hash table whose       *
+ * entries are only valid for the current read (dico_var_stamp) so that it *
+ * has not to be cleared at each read.                                     *
  *-------------------------------------------------------------------------*/
 static int
 Lookup_In_Dico_Var(char *name)
 {
   int i;
   Bool named;
+  DicoVarHash *h = NULL;
+  unsigned k;
 
   if (name[0] != '_' || name[1] != '\0')
     {
       named = TRUE;
-      for (i = 0; i < pl_parse_nb_var && strcmp(name, pl_parse_dico_var[i].name) != 0; i++)
-	;
+      k = Pl_Hash_Buffer(name, strlen(name));
+      for (;;)
+	{
+	  h = dico_var_hash + (k & (DICO_VAR_HASH_SIZE - 1));
+	  if (h->stamp != dico_var_stamp)
+	    {
+	      i = pl_parse_nb_var;
+	      break;
+	    }
+
+	  i = h->index;
+	  if (strcmp(name, pl_parse_dico_var[i].name) == 0)
+	    break;
+	  k++;
+	}
     }
   else
     {
@@ -720,6 +792,12 @@ Lookup_In_Dico_Var(char *name)
       if (pl_parse_nb_var >= MAX_VAR_IN_TERM)
 	Parse_Error("too many variables in a term");
 
+      if (named)
+	{
+	  h->stamp = dico_var_stamp;
+	  h->index = i;
+	}
+
       strcpy(pl_parse_dico_var[pl_parse_nb_var].name, name);
       pl_parse_dico_var[pl_parse_nb_var].word = NOT_A_WAM_WORD;
       pl_parse_dico_var[pl_parse_nb_var].named = named;
@@ -252,6 +252,10 @@ predicate_property(Head, _) :-
 
 '$prop_meta_pred'(fd_minimize, 2, fd_minimize(0, ?)).
 '$prop_meta_pred'(fd_maximize, 2, fd_maximize(0, ?)).
+'$prop_meta_pred'(fd_minimize, 3, fd_minimize(0, ?, +)).
+'$prop_meta_pred'(fd_maximize, 3, fd_maximize(0, ?, +)).
+'$prop_meta_pred'(fd_parallel_minimize, 4, fd_parallel_minimize(0, ?, ?, +)).
+'$prop_meta_pred'(fd_parallel_maximize, 4, fd_parallel_maximize(0, ?, ?, +)).
 
 
 '$get_pred_indicator'(PI, Func, Arity) :-
@@ -58,6 +58,12 @@
  * Function Prototypes             *
  *---------------------------------*/
 
+Bool Pl_Read_Term_From_Stream(StmInf *pstm, WamWord term_word,
+			      WamWord vars_word, WamWord var_names_word,
+			      WamWord sing_names_word);
+
+Bool Pl_Read_Token_From_Stream(StmInf *pstm, WamWord token_word);
+
 #define CURRENT_CHAR_CONVERSION_ALT X1_2463757272656E745F636861725F636F6E76657273696F6E5F616C74
 
 Prolog_Prototype(CURRENT_CHAR_CONVERSION_ALT, 0);
@@ -98,13 +104,33 @@ Pl_Read_Term_5(WamWord sora_word, WamWord term_word,
 	       WamWord vars_word, WamWord var_names_word,
 	       WamWord sing_names_word)
 {
-  WamWord word;
   int stm;
+
+  CHECK_STREAM_AND_GET_STM(sora_word, stm);
+
+  return Pl_Read_Term_From_Stream(pl_stm_tbl[stm], term_word, vars_word,
+				  var_names_word, sing_names_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_READ_TERM_FROM_STREAM                                                *
+ *                                                                         *
+ * Same as Pl_Read_Term_5() but reads from pstm which needs not be in the  *
+ * stream table (e.g. a buffer stream, see const_io_c.c).                  *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Read_Term_From_Stream(StmInf *pstm, WamWord term_word,
+			 WamWord vars_word, WamWord var_names_word,
+			 WamWord sing_names_word)
+{
+  WamWord word;
   int i;
   int parse_end_of_term = (SYS_VAR_OPTION_MASK >> 3) & 1;
 
-  CHECK_STREAM_AND_GET_STM(sora_word, stm);
-  word = Pl_Read_Term(pl_stm_tbl[stm], parse_end_of_term);
+  word = Pl_Read_Term(pstm, parse_end_of_term);
   CHECK_RESULT_AND_UNIFY(word, term_word);
 
   /* list of variables (i.e. [Var,...]) */
@@ -334,11 +360,27 @@ Pl_Read_Number_1(WamWord number_word)
 Bool
 Pl_Read_Token_2(WamWord sora_word, WamWord token_word)
 {
-  WamWord word;
   int stm;
 
   CHECK_STREAM_AND_GET_STM(sora_word, stm);
-  word = Pl_Read_Token(pl_stm_tbl[stm]);
+
+  return Pl_Read_Token_From_Stream(pl_stm_tbl[stm], token_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_READ_TOKEN_FROM_STREAM                                               *
+ *                                                                         *
+ * Same as Pl_Read_Token_2() but reads from pstm (see above).              *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Read_Token_From_Stream(StmInf *pstm, WamWord token_word)
+{
+  WamWord word;
+
+  word = Pl_Read_Token(pstm);
   CHECK_RESULT_AND_UNIFY(word, token_word);
 
   return TRUE;
@@ -82,6 +82,14 @@ static void Scan_Quoted(StmInf *pstm);
 
 static int Scan_Quoted_Char(StmInf *pstm, Bool convert, int c0, Bool no_escape);
 
+static Bool Scan_Block_Skip_Layout(StmInf *pstm);
+
+static void Scan_Block_Skip_To(StmInf *pstm, int c_stop);
+
+static char *Scan_Block_Copy(StmInf *pstm, char *s, int mask);
+
+static char *Scan_Block_Copy_Quoted(StmInf *pstm, char *s, int c0);
+
 
 
 #define   Unget_Last_Char       Pl_Stream_Ungetc(c_orig, pstm)
@@ -157,6 +165,9 @@ Pl_Scan_Token(StmInf *pstm, Bool comma_is_punct)
 
 start_scan:
 
+  if (Scan_Block_Skip_Layout(pstm))
+    layout_before = TRUE;
+
   for (;;)
     {
       Read_Next_Char(pstm, TRUE);
@@ -188,6 +199,7 @@ start_scan:
       do
 	{
 	  *s++ = c;
+	  s = Scan_Block_Copy(pstm, s, UL | CL | SL | DI);
 	  Read_Next_Char(pstm, TRUE);
 	}
       while (c_type & (UL | CL | SL | DI));
@@ -224,6 +236,8 @@ start_scan:
 	    do
 	      {
 		c0 = c;
+		if (c0 != '*')	/* skipped chars are not '*' either */
+		  Scan_Block_Skip_To(pstm, '*');
 		Read_Next_Char(pstm, TRUE);
 	      }
 	    while (c != EOF && (c0 != '*' || c != '/'));
@@ -248,6 +262,7 @@ start_scan:
       while (c_type == GR)
 	{
 	  *s++ = c;
+	  s = Scan_Block_Copy(pstm, s, GR);
 	  Read_Next_Char(pstm, TRUE);
 	}
       *s = '\0';
@@ -256,7 +271,10 @@ start_scan:
 
     case CM:			/* comment character */
       do
-	Read_Next_Char(pstm, TRUE);
+	{
+	  Scan_Block_Skip_To(pstm, '\n');
+	  Read_Next_Char(pstm, TRUE);
+	}
       while (c != '\n' && c != EOF);
 #if 0  // what says standard ? EOF allowed at end of %... comment ?
       if (c == EOF)
@@ -351,6 +369,7 @@ Scan_Number(StmInf *pstm, Bool integer_only)
   do
     {
       *p++ = c;
+      p = Scan_Block_Copy(pstm, p, DI);
       Read_Next_Char(pstm, TRUE);
     }
   while (c_type == DI);
@@ -534,6 +553,9 @@ Scan_Quoted(StmInf *pstm)
 
   for (;;)
     {
+      if (!error_found)
+	s = Scan_Block_Copy_Quoted(pstm, s, c0);
+
       c = Scan_Quoted_Char(pstm, convert, c0, no_escape);
       if (c == -1)		/* closing quote */
 	{
@@ -753,6 +775,122 @@ Scan_Quoted_Char(StmInf *pstm, Bool convert, int c0, Bool no_escape)
 
 
 
+/*-------------------------------------------------------------------------*
+ * SCAN_BLOCK_SKIP_LAYOUT                                                  *
+ *                                                                         *
+ * The Scan_Block_xxx functions are the fast paths of the scanner: they    *
+ * work directly on the chars available in the block buffer of the stream *
+ * (see Pl_Stream_Block_Peek()) instead of calling Read_Next_Char() for    *
+ * each char. They stop at the end of the buffer (or do nothing when the   *
+ * per-char path is needed, e.g. char_conversion is on) and let the caller *
+ * continue with the per-char path. The char ending a run is not consumed.*
+ *-------------------------------------------------------------------------*/
+static Bool
+Scan_Block_Skip_Layout(StmInf *pstm)
+{
+  char *p, *q, *end;
+
+  if (Flag_Value(char_conversion) ||
+      (p = Pl_Stream_Block_Peek(pstm, &end)) == NULL)
+    return FALSE;
+
+  for (q = p; q < end && pl_char_type[(unsigned char) *q] == LA; q++)
+    ;
+
+  Pl_Stream_Block_Skip(pstm, q);
+  return q != p;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_BLOCK_SKIP_TO                                                      *
+ *                                                                         *
+ * Skips the chars until c_stop (excluded).                                *
+ *-------------------------------------------------------------------------*/
+static void
+Scan_Block_Skip_To(StmInf *pstm, int c_stop)
+{
+  char *p, *q, *end;
+
+  if (Flag_Value(char_conversion) ||
+      (p = Pl_Stream_Block_Peek(pstm, &end)) == NULL)
+    return;
+
+  if ((q = memchr(p, c_stop, end - p)) == NULL)
+    q = end;
+
+  Pl_Stream_Block_Skip(pstm, q);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_BLOCK_COPY                                                         *
+ *                                                                         *
+ * Copies in s the run of chars whose type is in mask and returns the new *
+ * end of s (the copy stops before the end of pl_token.name).              *
+ *-------------------------------------------------------------------------*/
+static char *
+Scan_Block_Copy(StmInf *pstm, char *s, int mask)
+{
+  char *p, *q, *end;
+  int max = pl_token.name + SCAN_BIG_BUFFER - 1 - s;
+
+  if (Flag_Value(char_conversion) ||
+      (p = Pl_Stream_Block_Peek(pstm, &end)) == NULL)
+    return s;
+
+  if (end - p > max)
+    end = p + max;
+
+  for (q = p; q < end && (pl_char_type[(unsigned char) *q] & mask); q++)
+    *s++ = *q;
+
+  Pl_Stream_Block_Skip(pstm, q);
+  return s;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_BLOCK_COPY_QUOTED                                                  *
+ *                                                                         *
+ * Copies in s the run of plain chars of a quoted item, i.e. stops at the  *
+ * quote c0, at \ (escape sequence) and at chars raising an error.         *
+ *-------------------------------------------------------------------------*/
+static char *
+Scan_Block_Copy_Quoted(StmInf *pstm, char *s, int c0)
+{
+  char *p, *q, *end;
+  int max = pl_token.name + SCAN_BIG_BUFFER - 1 - s;
+  int x;
+
+  if (Flag_Value(char_conversion) ||
+      (p = Pl_Stream_Block_Peek(pstm, &end)) == NULL)
+    return s;
+
+  if (end - p > max)
+    end = p + max;
+
+  for (q = p; q < end; q++)
+    {
+      x = (unsigned char) *q;
+      if (x == c0 || x == '\\' || x == '\n' || x == '\t')
+	break;
+      *s++ = x;
+    }
+
+  Pl_Stream_Block_Skip(pstm, q);
+  return s;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_RECOVER_AFTER_ERROR                                                  *
  *                                                                         *
@@ -874,6 +1012,7 @@ Pl_Scan_Next_Atom(StmInf *pstm)
       do
 	{
 	  *s++ = c;
+	  s = Scan_Block_Copy(pstm, s, UL | CL | SL | DI);
 	  Read_Next_Char(pstm, TRUE);
 	}
       while (c_type & (UL | CL | SL | DI));
@@ -902,6 +1041,7 @@ Pl_Scan_Next_Atom(StmInf *pstm)
       while (c_type == GR)
 	{
 	  *s++ = c;
+	  s = Scan_Block_Copy(pstm, s, GR);
 	  Read_Next_Char(pstm, TRUE);
 	}
       *s = '\0';
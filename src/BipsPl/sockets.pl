@@ -78,6 +78,13 @@ socket_listen(Socket, Length) :-
 
 
 
+socket_set_blocking(Socket, Blocking) :-
+	set_bip_name(socket_set_blocking, 2),
+	'$call_c_test'('Pl_Socket_Set_Blocking_2'(Socket, Blocking)).
+
+
+
+
 socket_accept(Socket, StreamIn, StreamOut) :-
 	set_bip_name(socket_accept, 3),
 	'$get_open_stm'(StreamIn, StmIn),
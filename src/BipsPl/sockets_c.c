@@ -43,6 +43,8 @@
 #include <sys/types.h>
 #ifndef _WIN32
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #else
 #include <io.h>
@@ -99,6 +101,8 @@ static int atom_AF_INET;
  * Function Prototypes             *
  *---------------------------------*/
 
+static int Connect(int sock, struct sockaddr *adr, socklen_t l);
+
 static Bool Create_Socket_Streams(int sock, char *stream_name,
 				  int *stm_in, int *stm_out);
 
@@ -374,7 +378,7 @@ Pl_Socket_Connect_4(WamWord socket_word, WamWord address_word,
 
       adr_un.sun_family = AF_UNIX;
       strcpy(adr_un.sun_path, path_name);
-      Os_Test_Error(connect(sock, (struct sockaddr *) &adr_un, sizeof(adr_un)));
+      Os_Test_Error(Connect(sock, (struct sockaddr *) &adr_un, sizeof(adr_un)));
       sprintf(stream_name, "socket_stream(connect('AF_UNIX'('%s')),%d)", path_name, sock);
 #ifdef _WIN32
 	  /* Check for in-progress connection */
@@ -398,7 +402,7 @@ Pl_Socket_Connect_4(WamWord socket_word, WamWord address_word,
   adr_in.sin_port = htons((unsigned short) port);
   memcpy(&adr_in.sin_addr, host_entry->h_addr_list[0], host_entry->h_length);
 
-  Os_Test_Error(connect(sock, (struct sockaddr *) &adr_in, sizeof(adr_in)));
+  Os_Test_Error(Connect(sock, (struct sockaddr *) &adr_in, sizeof(adr_in)));
   sprintf(stream_name, "socket_stream(connect('AF_INET'('%s',%d)),%d)",
 	  host_name, port, sock);
 
@@ -416,6 +420,52 @@ create_streams:
 
 
 
+/*-------------------------------------------------------------------------*
+ * CONNECT                                                                 *
+ *                                                                         *
+ * connect() on a non-blocking socket only starts the connection: wait for *
+ * its completion (the socket remains non-blocking).                       *
+ *-------------------------------------------------------------------------*/
+static int
+Connect(int sock, struct sockaddr *adr, socklen_t l)
+{
+#ifndef _WIN32
+  struct pollfd pfd;
+  int err;
+  socklen_t err_len = sizeof(err);
+#endif
+
+  if (connect(sock, adr, l) == 0)
+    return 0;
+
+#ifndef _WIN32
+  if (errno != EINPROGRESS)
+    return -1;
+
+  pfd.fd = sock;
+  pfd.events = POLLOUT;
+  while (poll(&pfd, 1, -1) < 0)
+    if (errno != EINTR)
+      return -1;
+
+  if (getsockopt(sock, SOL_SOCKET, SO_ERROR, (void *) &err, &err_len) < 0)
+    return -1;
+
+  if (err != 0)
+    {
+      errno = err;
+      return -1;
+    }
+
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_SOCKET_LISTEN_2                                                      *
  *                                                                         *
@@ -436,6 +486,43 @@ Pl_Socket_Listen_2(WamWord socket_word, WamWord length_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_SOCKET_SET_BLOCKING_2                                                *
+ *                                                                         *
+ * In non-blocking mode socket_accept/4 fails if there is no pending       *
+ * connection. A read/write on the streams of a non-blocking socket which  *
+ * would block raises a system_error, thus a poller should be used to only *
+ * read/write the ready streams (see poller_wait/3).                       *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Socket_Set_Blocking_2(WamWord socket_word, WamWord blocking_word)
+{
+  int sock;
+  int blocking;
+#ifndef _WIN32
+  int flags;
+#else
+  u_long mode;
+#endif
+
+  sock = Pl_Rd_C_Int_Check(socket_word);
+  blocking = Pl_Rd_Boolean_Check(blocking_word);
+
+#ifndef _WIN32
+  Os_Test_Error((flags = fcntl(sock, F_GETFL)));
+  flags = (blocking) ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+  Os_Test_Error(fcntl(sock, F_SETFL, flags));
+#else
+  mode = !blocking;
+  Os_Test_Error(ioctlsocket(sock, FIONBIO, &mode));
+#endif
+
+  return TRUE;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_SOCKET_ACCEPT_4                                                      *
  *                                                                         *
@@ -457,8 +544,19 @@ Pl_Socket_Accept_4(WamWord socket_word, WamWord client_word,
 
   cli_sock = accept(sock, (struct sockaddr *) &adr_in, &l);
 
+#ifndef _WIN32
+  if (cli_sock < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    return FALSE;		/* non-blocking: no pending connection */
+#endif
+
   Os_Test_Error(cli_sock);
 
+#ifndef _WIN32			/* the mode is not inherited on Linux */
+  if (fcntl(sock, F_GETFL) & O_NONBLOCK)
+    Os_Test_Error(fcntl(cli_sock, F_SETFL,
+			fcntl(cli_sock, F_GETFL) | O_NONBLOCK));
+#endif
+
   if (adr_in.sin_family == AF_INET)
     {
       cli_ip_adr = inet_ntoa(adr_in.sin_addr);
@@ -513,11 +611,11 @@ static Bool
 Create_Socket_Streams(int sock, char *stream_name, int *stm_in, int *stm_out)
 {
   int fd;
-  FILE *f_in, *f_out;
   int atom;
   int stm;
 
 #ifdef _WIN32
+  FILE *f_in, *f_out;
   int r;
 
   Os_Test_Error((fd = _open_osfhandle(sock, _O_BINARY | _O_RDWR | _O_BINARY)));
@@ -526,19 +624,25 @@ Create_Socket_Streams(int sock, char *stream_name, int *stm_in, int *stm_out)
   Os_Test_Error_Null((f_in = fdopen(r, "r")));
 #else
   Os_Test_Error((fd = dup(sock)));
-  Os_Test_Error_Null((f_in = fdopen(sock, "rt")));
-  Os_Test_Error_Null((f_out = fdopen(fd, "wt")));
 #endif
 
   atom = Pl_Create_Allocate_Atom(stream_name);
 
+#ifdef _WIN32
   stm = Pl_Add_Stream_For_Stdio_Desc(f_in, atom, STREAM_MODE_READ, TRUE, FALSE);
+#else				/* block buffered, can be non-blocking */
+  stm = Pl_Add_Stream_For_Fd_Desc(sock, atom, STREAM_MODE_READ, TRUE);
+#endif
   pl_stm_tbl[stm]->prop.eof_action = STREAM_EOF_ACTION_RESET;
   pl_stm_tbl[stm]->prop.other = 4;
 
   *stm_in = stm;
 
+#ifdef _WIN32
   stm = Pl_Add_Stream_For_Stdio_Desc(f_out, atom, STREAM_MODE_WRITE, TRUE, FALSE);
+#else
+  stm = Pl_Add_Stream_For_Fd_Desc(fd, atom, STREAM_MODE_WRITE, TRUE);
+#endif
   pl_stm_tbl[stm]->prop.other = 4;
 
   *stm_out = stm;
@@ -342,7 +342,7 @@ Pl_SR_Open_File_2(WamWord file_name_word, WamWord from_stream_word)
 #endif
 	  else
 	    {
-	      stm = Pl_Add_Stream_For_Stdio_File(pl_atom_tbl[atom_file_name].name,
+	      stm = Pl_Add_Stream_For_Fd_File(pl_atom_tbl[atom_file_name].name,
 					      STREAM_MODE_READ, TRUE);
 	      if (stm < 0)
 		{
@@ -364,7 +364,7 @@ Pl_SR_Open_File_2(WamWord file_name_word, WamWord from_stream_word)
       if (!file->reposition)
 	{
 	  file->tmp_path = Pl_M_Tempnam(NULL, NULL);
-	  file->tmp_stm = Pl_Add_Stream_For_Stdio_File(file->tmp_path,
+	  file->tmp_stm = Pl_Add_Stream_For_Fd_File(file->tmp_path,
 						    STREAM_MODE_WRITE, TRUE);
 	  if (file->tmp_stm < 0)
 	    Pl_Fatal_Error("cannot create tmp file %s in %s:%d", file->tmp_path,
@@ -377,8 +377,7 @@ Pl_SR_Open_File_2(WamWord file_name_word, WamWord from_stream_word)
 	  if (pstm_tmp->prop.buffering != pstm->prop.buffering)
 	    {
 	      pstm_tmp->prop.buffering = pstm->prop.buffering;
-	      Pl_Stdio_Set_Buffering((FILE *) pstm_tmp->file,
-				  pstm_tmp->prop.buffering);
+	      Pl_Set_Stream_Buffering(file->tmp_stm);
 	    }
 	  Pl_Add_Mirror_To_Stream(stm, file->tmp_stm);
 	}
@@ -543,7 +542,7 @@ Pl_SR_New_Pass_1(WamWord desc_word)
 	  if (file != sr->file_first || sr->close_master_at_end)
 	    Pl_Close_Stm(file->stm, TRUE);
 	  Pl_Close_Stm(file->tmp_stm, TRUE); /* close mirror file */
-	  file->stm = Pl_Add_Stream_For_Stdio_File(file->tmp_path,
+	  file->stm = Pl_Add_Stream_For_Fd_File(file->tmp_path,
 						STREAM_MODE_READ, TRUE);
 	  file->reposition = TRUE;
 	}
@@ -214,9 +214,9 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
   char *path;
   int atom_file_name;
   int stm;
-  FILE *f;
   int mask = SYS_VAR_OPTION_MASK;
   Bool reposition;
+  Bool use_mmap = (mask >> 9) & 1;
 
 
   DEREF(source_sink_word, word, tag_mask);
@@ -243,7 +243,18 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
   else
     Pl_Err_Domain(pl_domain_io_mode, mode_word);
 
-  stm = Pl_Add_Stream_For_Stdio_File(path, mode, text);
+  if (use_mmap && mode != STREAM_MODE_READ)
+    {
+      word = Pl_Put_Structure(Pl_Create_Atom("mmap"), 1);
+      Pl_Unify_Atom(pl_atom_true);
+      Pl_Err_Permission(pl_permission_operation_open,
+			pl_permission_type_source_sink, word);
+    }
+
+  if (use_mmap)
+    stm = Pl_Add_Mmap_Stream(path, text);
+  else
+    stm = Pl_Add_Stream_For_Fd_File(path, mode, text);
   if (stm < 0)
     {
       if (errno == ENOENT || errno == ENOTDIR)
@@ -254,7 +265,6 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
     }
 
   prop = pl_stm_tbl[stm]->prop;
-  f = (FILE *) pl_stm_tbl[stm]->file;
 
 				/* change properties wrt to specified ones */
 
@@ -263,7 +273,8 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
       reposition = mask & 1;
       if (reposition && !prop.reposition)
 	{
-	  fclose(f);
+	  Pl_Stream_Close(pl_stm_tbl[stm]);
+	  Pl_Delete_Stream(stm);
 	  word = Pl_Put_Structure(pl_atom_reposition, 1);
 	  Pl_Unify_Atom(pl_atom_true);
 	  Pl_Err_Permission(pl_permission_operation_open,
@@ -280,11 +291,7 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
 
 
   if ((mask & 4) != 0)		/* buffering specified */
-    if (prop.buffering != (unsigned) (mask & 3)) /* cast for MSVC warning */
-      {
-	prop.buffering = mask & 3;
-	Pl_Stdio_Set_Buffering(f, prop.buffering);
-      }
+    prop.buffering = mask & 3;	/* honored by the stream block buffer */
   mask >>= 3;
 
   pl_stm_tbl[stm]->atom_file_name = atom_file_name;
@@ -419,13 +426,13 @@ Pl_Set_Stream_Type_2(WamWord sora_word, WamWord is_text_word)
   pstm->prop.text = text;
 #if defined(_WIN32) || defined(__CYGWIN__)
   {
-    FILE *f;
+    int fd;
 
-    f = Pl_Stdio_Desc_Of_Stream(stm);
-    if (f == NULL)
+    fd = Pl_Io_Fileno_Of_Stream(stm);
+    if (fd < 0)
       return;
 
-    setmode(fileno(f), (text) ? O_TEXT : O_BINARY);
+    setmode(fd, (text) ? O_TEXT : O_BINARY);
   }
 #endif
 }
@@ -1511,7 +1518,7 @@ Pl_Close_Output_Term_Stream_2(WamWord sora_word, WamWord sink_term_word)
   switch (SYS_VAR_OPTION_MASK)
     {
     case TERM_STREAM_ATOM:
-      if (!Pl_Un_String_Check(str, sink_term_word))
+      if (!Pl_Un_Atom_Check(Pl_Term_Write_Str_Stream_Atom(stm), sink_term_word))
 	return FALSE;
       break;
 
@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -67,6 +68,7 @@ extern void clearerr(FILE *stream);
 #include <io.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 
@@ -80,6 +82,18 @@ extern void clearerr(FILE *stream);
 
 #define STR_STREAM_WRITE_BLOCK     1024
 
+#define STR_STREAM_ADOPT_SIZE      4096	/* give buff to atom if >= */
+
+#define FD_STREAM_BUFFER_SIZE      65536
+
+#define FD_STREAM_PIPE_BUFFER_SIZE 8192	/* sockets, pipes: many can be open */
+
+#ifndef _WIN32
+#define Fd_Would_Block()           (errno == EAGAIN || errno == EWOULDBLOCK)
+#else
+#define Fd_Would_Block()           FALSE
+#endif
+
 #define TTY_BUFFER_SIZE            1024
 
 #define BIG_BUFFER                 65535
@@ -98,6 +112,27 @@ extern void clearerr(FILE *stream);
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* File descriptor stream info    */
+{				/* ------------------------------ */
+  int fd;			/* the file descriptor            */
+  StmBuff buff;			/* its block buffer               */
+}
+FdSInf;
+
+
+
+
+typedef struct			/* Mapped file stream info        */
+{				/* ------------------------------ */
+  char *base;			/* mapped address (or malloc'ed)  */
+  size_t size;			/* size of the file               */
+  StmBuff buff;			/* buff = base, end = base + size */
+}
+MmapSInf;
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -112,8 +147,13 @@ static WamWord stream_1;
 static WamWord word_current_input_stream;
 static WamWord word_current_output_stream;
 
-static StrSInf static_str_stream_rd = { NULL, NULL, 0 }; /* input */
-static StrSInf static_str_stream_wr = { NULL, NULL, 0 }; /* output */
+static StrSInf static_str_stream_rd = { NULL, NULL, 0, FALSE, 0 }; /* input */
+static StrSInf static_str_stream_wr = { NULL, NULL, 0, FALSE, 0 }; /* output */
+
+static StmInf buff_stream_rd;	/* buffer streams (not in pl_stm_tbl) */
+static StmInf buff_stream_wr;
+static MmapSInf buff_stream_rd_inf;
+static StrSInf buff_stream_wr_inf;
 
 
 #ifndef NO_USE_LINEDIT
@@ -155,6 +195,49 @@ static int Str_Stream_Getc(StrSInf *str_stream);
 
 static void Str_Stream_Putc(int c, StrSInf *str_stream);
 
+static void Str_Stream_Write(StrSInf *str_stream, char *str, int size);
+
+static void Str_Stream_Reserve(StrSInf *str_stream, int n);
+
+static int Mmap_Getc(MmapSInf *mm_stream);
+
+static int Mmap_Close(MmapSInf *mm_stream);
+
+static StmInf *Init_Buffer_Stream(StmInf *pstm, PlLong file, Bool input,
+				  StmFct fct_getc, StmFct fct_putc);
+
+static int Fill_Block(StmInf *pstm);
+
+static Bool Write_Block(StmInf *pstm);
+
+static void Flush_Block(StmInf *pstm);
+
+static void Flush_Block_Streams(void);
+
+static void Update_Counters_Block(StmInf *pstm, char *str, int size);
+
+static PlLong Stream_Tell(StmInf *pstm);
+
+static int Stream_Seek(StmInf *pstm, PlLong offset, int whence);
+
+#ifndef FOR_EXTERNAL_USE
+
+static int Fd_Getc(FdSInf *fd_stream);
+
+static int Fd_Putc(int c, FdSInf *fd_stream);
+
+static int Fd_Read(FdSInf *fd_stream, char *buff, int size);
+
+static int Fd_Write(FdSInf *fd_stream, char *buff, int size);
+
+static int Fd_Close(FdSInf *fd_stream);
+
+static int Fd_Tell(FdSInf *fd_stream);
+
+static int Fd_Seek(FdSInf *fd_stream, PlLong offset, int whence);
+
+#endif
+
 
 
 
@@ -178,6 +261,8 @@ Init_Stream_Supp(void)
 
   pl_alias_tbl = Pl_Hash_Alloc_Table(START_ALIAS_TBL_SIZE, sizeof(AliasInf));
 
+  atexit(Flush_Block_Streams);	/* block buffers are not known by stdio */
+
   pl_atom_stream = Pl_Create_Atom("$stream");
   stream_1 = Functor_Arity(pl_atom_stream, 1);
 
@@ -394,6 +479,90 @@ Pl_Add_Stream_For_Stdio_File(char *path, int mode, Bool text)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_ADD_STREAM_FOR_FD_FILE                                               *
+ *                                                                         *
+ * Like Pl_Add_Stream_For_Stdio_File() but the stream is directly handled  *
+ * on a file descriptor with a block buffer (bypassing stdio).             *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Add_Stream_For_Fd_File(char *path, int mode, Bool text)
+{
+  int fd;
+  int flags;
+
+  switch(mode)
+    {
+    case STREAM_MODE_READ:
+      flags = O_RDONLY;
+      break;
+
+    case STREAM_MODE_WRITE:
+      flags = O_WRONLY | O_CREAT | O_TRUNC;
+      break;
+
+    default:			/* STREAM_MODE_APPEND */
+      flags = O_WRONLY | O_CREAT | O_APPEND;
+      break;
+    }
+
+#ifdef O_BINARY
+  flags |= (text) ? O_TEXT : O_BINARY;
+#endif
+
+  if ((fd = open(path, flags, 0666)) < 0)
+    return -1;
+
+  return Pl_Add_Stream_For_Fd_Desc(fd, Pl_Create_Allocate_Atom(path),
+				   mode, text);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ADD_STREAM_FOR_FD_DESC                                               *
+ *                                                                         *
+ * Create a stream on an open file descriptor (closed with the stream).    *
+ * The descriptor can be in non-blocking mode (e.g. a socket): a read or a *
+ * write which would block then raises a system_error (see Flush_Block).   *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Add_Stream_For_Fd_Desc(int fd, int atom_path, int mode, Bool text)
+{
+  char open_str[10];
+  StmProp prop = Pl_Prop_And_Stdio_Mode(mode, text, open_str);
+  FdSInf *fd_stream;
+  int stm;
+
+  prop.reposition = !isatty(fd) && lseek(fd, 0, SEEK_CUR) >= 0;
+  prop.buffering = (prop.reposition) ? STREAM_BUFFERING_BLOCK :
+    STREAM_BUFFERING_LINE;
+  if (isatty(fd))
+    prop.eof_action = STREAM_EOF_ACTION_RESET;
+
+  fd_stream = (FdSInf *) Malloc(sizeof(FdSInf));
+  fd_stream->fd = fd;
+  fd_stream->buff.size = (prop.reposition) ? FD_STREAM_BUFFER_SIZE :
+    FD_STREAM_PIPE_BUFFER_SIZE;
+  fd_stream->buff.buff = (char *) Malloc(fd_stream->buff.size);
+  fd_stream->buff.mapped = FALSE;
+
+  stm = Pl_Add_Stream(atom_path, (PlLong) fd_stream, prop,
+		      (StmFct) Fd_Getc, (StmFct) Fd_Putc,
+		      STREAM_FCT_UNDEFINED, (StmFct) Fd_Close,
+		      (StmFct) Fd_Tell, (StmFct) Fd_Seek,
+		      STREAM_FCT_UNDEFINED);
+
+  Pl_Set_Stream_Block_IO(stm, &fd_stream->buff,
+			 (StmFct) Fd_Read, (StmFct) Fd_Write);
+
+  return stm;
+}
+
+
+
+
 #endif /* !FOR_EXTERNAL_USE */
 
 /*-------------------------------------------------------------------------*
@@ -426,6 +595,10 @@ Init_Stream_Struct(int atom_file_name, PlLong file, StmProp prop,
   /* Works only because putc will be called with c as 1st arg
      and flush's arg is ignored */
 
+  pstm->buff = NULL;
+  pstm->fct_read = STREAM_FCT_UNDEFINED;
+  pstm->fct_write = STREAM_FCT_UNDEFINED;
+
   pstm->eof_reached = FALSE;
   PB_Init(pstm->pb_char);
 
@@ -469,6 +642,30 @@ Pl_Add_Stream(int atom_file_name, PlLong file, StmProp prop,
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_SET_STREAM_BLOCK_IO                                                  *
+ *                                                                         *
+ * Attach a block buffer to a stream. Characters are then read/written in *
+ * buff and fct_read(file, buff, size) / fct_write(file, buff, size) are   *
+ * only called to fill/flush it (the buffer belongs to the file accessor). *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Set_Stream_Block_IO(int stm, StmBuff *buff,
+		       StmFct fct_read, StmFct fct_write)
+{
+  StmInf *pstm = pl_stm_tbl[stm];
+
+  pstm->buff = buff;
+  pstm->fct_read = fct_read;
+  pstm->fct_write = fct_write;
+
+  buff->ptr = buff->buff;
+  buff->end = (pstm->prop.output) ? buff->buff + buff->size : buff->buff;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * REMOVE_STREAM                                                           *
  *                                                                         *
@@ -764,6 +961,13 @@ Pl_Set_Stream_Buffering(int stm)
   StmInf *pstm = pl_stm_tbl[stm];
   FILE *f;
 
+  if (pstm->buff)		/* handled by Basic_Call_Fct_Putc */
+    {
+      if (pstm->prop.output)
+	Flush_Block(pstm);
+      return;
+    }
+
   f = Pl_Stdio_Desc_Of_Stream(stm);
   if (f == NULL)
     {
@@ -1009,6 +1213,11 @@ Pl_Io_Fileno_Of_Stream(int stm)
 {
   FILE *f;
 
+#ifndef FOR_EXTERNAL_USE
+  if (pl_stm_tbl[stm]->fct_close == (StmFct) Fd_Close)
+    return ((FdSInf *) (pl_stm_tbl[stm]->file))->fd;
+#endif
+
   f = Pl_Stdio_Desc_Of_Stream(stm);
   if (f)
     return fileno(f);
@@ -1222,7 +1431,11 @@ Basic_Call_Fct_Getc(StmInf *pstm)
       fflush(stdout);
     }
 #endif
-  c = (*pstm->fct_getc) (pstm->file);
+  if (pstm->buff)
+    c = (pstm->buff->ptr < pstm->buff->end) ?
+      (unsigned char) *(pstm->buff->ptr)++ : Fill_Block(pstm);
+  else
+    c = (*pstm->fct_getc) (pstm->file);
 
   if (c != EOF)
     for (m = pstm->mirror; m ; m = m->next)
@@ -1242,8 +1455,21 @@ static void
 Basic_Call_Fct_Putc(int c, StmInf *pstm)
 {
   StmLst *m;
+  StmBuff *b = pstm->buff;
+
+  if (b)
+    {
+      if (b->ptr >= b->end)
+	Flush_Block(pstm);
+
+      *(b->ptr)++ = c;
 
-  (*pstm->fct_putc) (c, pstm->file);
+      if (pstm->prop.buffering != STREAM_BUFFERING_BLOCK &&
+	  (c == '\n' || pstm->prop.buffering == STREAM_BUFFERING_NONE))
+	Flush_Block(pstm);
+    }
+  else
+    (*pstm->fct_putc) (c, pstm->file);
 
   for (m = pstm->mirror; m ; m = m->next)
     Pl_Stream_Putc(c, pl_stm_tbl[m->stm]);
@@ -1340,6 +1566,11 @@ Pl_Stream_Getc(StmInf *pstm)
     {
       PB_Pop(pstm->pb_char, c);
     }
+  else if (pstm->buff && pstm->buff->ptr < pstm->buff->end &&
+	   pstm->mirror == NULL)
+    {				/* fast path: char already in the buffer */
+      c = (unsigned char) *(pstm->buff->ptr)++;
+    }
   else
     {
       Start_Protect_Regs_For_Signal;
@@ -1369,7 +1600,13 @@ Pl_Stream_Getc(StmInf *pstm)
 void
 Pl_Stream_Ungetc(int c, StmInf *pstm)
 {
-  PB_Push(pstm->pb_char, c);
+  StmBuff *b = pstm->buff;
+
+  if (b && PB_Is_Empty(pstm->pb_char) && pstm->mirror == NULL &&
+      b->ptr > b->buff && (unsigned char) b->ptr[-1] == c)
+    b->ptr--;			/* simply move back into the buffer */
+  else
+    PB_Push(pstm->pb_char, c);
   pstm->eof_reached = FALSE;
 
   if (pstm->char_count > 0)	/* test should be useless */
@@ -1407,6 +1644,9 @@ Pl_Stream_Peekc(StmInf *pstm)
 
   if (!PB_Is_Empty(pstm->pb_char))
     PB_Top(pstm->pb_char, c);
+  else if (pstm->buff && pstm->buff->ptr < pstm->buff->end &&
+	   pstm->mirror == NULL)
+    c = (unsigned char) *pstm->buff->ptr;
   else
     {
       c = Basic_Call_Fct_Getc(pstm);
@@ -1419,6 +1659,87 @@ Pl_Stream_Peekc(StmInf *pstm)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_BLOCK_PEEK                                                    *
+ *                                                                         *
+ * Gives a direct access to the chars already available in the block      *
+ * buffer of an input stream. Returns a pointer to the first char and sets *
+ * *end to the end of the available chars, or returns NULL if the per-char *
+ * path must be used (no buffer, empty buffer, push back chars, mirror,..).*
+ * The caller then calls Pl_Stream_Block_Skip() to consume what it used.   *
+ *-------------------------------------------------------------------------*/
+char *
+Pl_Stream_Block_Peek(StmInf *pstm, char **end)
+{
+  StmBuff *b = pstm->buff;
+
+  if (b == NULL || b->ptr >= b->end || !pstm->prop.input ||
+      !PB_Is_Empty(pstm->pb_char) || pstm->mirror != NULL ||
+      pstm->eof_reached)
+    return NULL;
+
+  *end = b->end;
+  return b->ptr;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_INPUT_PENDING                                                 *
+ *                                                                         *
+ * Are there chars already read from the file (i.e. in the push-back or in *
+ * the block buffer)? Only known for streams with a block buffer (FALSE    *
+ * is returned for the other streams). Layout chars in the block buffer    *
+ * are not taken into account: the layout following a term (e.g. its      *
+ * newline) is not enough for a next read/2 to progress.                   *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Stream_Input_Pending(StmInf *pstm)
+{
+  StmBuff *b = pstm->buff;
+  char *p;
+
+  if (!pstm->prop.input)
+    return FALSE;
+
+  if (!PB_Is_Empty(pstm->pb_char))
+    return TRUE;
+
+  if (b == NULL)
+    return FALSE;
+
+  for (p = b->ptr; p < b->end; p++)
+    if (pl_char_type[(unsigned char) *p] != LA)
+      return TRUE;
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_BLOCK_SKIP                                                    *
+ *                                                                         *
+ * Consumes the chars of the block buffer up to p (excluded), p being in   *
+ * the range given by a previous Pl_Stream_Block_Peek().                   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Stream_Block_Skip(StmInf *pstm, char *p)
+{
+  StmBuff *b = pstm->buff;
+
+  if (p > b->ptr)
+    {
+      Update_Counters_Block(pstm, b->ptr, p - b->ptr);
+      b->ptr = p;
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_STREAM_GETS                                                          *
  *                                                                         *
@@ -1455,6 +1776,46 @@ Pl_Stream_Gets(char *str, int size, StmInf *pstm)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_READ                                                          *
+ *                                                                         *
+ * Read up to size chars in buff and return the number of chars read (less *
+ * than size only at the end of the stream). The chars are copied in bulk  *
+ * from the block buffer when possible.                                    *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Stream_Read(char *buff, int size, StmInf *pstm)
+{
+  char *p = buff;
+  char *end = buff + size;
+  char *q, *q_end;
+  int c, n;
+
+  while (p < end)
+    {
+      q = Pl_Stream_Block_Peek(pstm, &q_end);
+      if (q != NULL)
+	{
+	  n = q_end - q;
+	  if (n > end - p)
+	    n = end - p;
+	  memcpy(p, q, n);
+	  p += n;
+	  Pl_Stream_Block_Skip(pstm, q + n);
+	  continue;
+	}
+
+      if ((c = Pl_Stream_Getc(pstm)) == EOF)
+	break;
+      *p++ = c;
+    }
+
+  return p - buff;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_STREAM_GETS_PROMPT                                                   *
  *                                                                         *
@@ -1508,17 +1869,84 @@ Pl_Stream_Putc(int c, StmInf *pstm)
 int
 Pl_Stream_Puts(char *str, StmInf *pstm)
 {
-  char *p;
-  int c;
+  return Pl_Stream_Write(str, strlen(str), pstm);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_WRITE                                                         *
+ *                                                                         *
+ * Emit size chars of str. On a block buffered stream (without mirror) the *
+ * chars are copied in bulk and the counters are updated once.             *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Stream_Write(char *str, int size, StmInf *pstm)
+{
+  StmBuff *b = pstm->buff;
+  char *p = str;
+  char *end = str + size;
+  int c, n, m;
+
+  if (b == NULL && pstm->fct_putc == (StmFct) Str_Stream_Putc &&
+      pstm->mirror == NULL)
+    {
+      Str_Stream_Write((StrSInf *) pstm->file, str, size);
+      Update_Counters_Block(pstm, str, size);
+      return size;
+    }
+
+  if (b == NULL || pstm->mirror)
+    {
+      for (; p < end; p++)
+	{
+	  c = *p;
+	  Basic_Call_Fct_Putc(c, pstm); /* like Stream_Putc */
+	  Update_Counters(pstm, c);
+	}
+
+      return size;
+    }
 
-  for (p = str; *p; p++)
+  while (p < end)
     {
-      c = *p;
-      Basic_Call_Fct_Putc(c, pstm); /* like Stream_Putc */
-      Update_Counters(pstm, c);
+      if (b->ptr >= b->end)
+	Flush_Block(pstm);
+
+      n = end - p;
+      if (b->ptr == b->buff && n >= b->size)	/* large: no copy */
+	{
+	  if ((m = (*pstm->fct_write) (pstm->file, p, n)) < 0 || m == n)
+	    break;
+				/* would block: buffer what fits and flush */
+	  p += m;
+	  n = end - p;
+	  if (n > b->size)
+	    n = b->size;
+	  memcpy(b->ptr, p, n);
+	  b->ptr += n;
+	  p += n;
+	  Flush_Block(pstm);
+	  continue;
+	}
+
+      if (n > b->end - b->ptr)
+	n = b->end - b->ptr;
+
+      memcpy(b->ptr, p, n);
+      b->ptr += n;
+      p += n;
     }
 
-  return p - str;
+  if (pstm->prop.buffering == STREAM_BUFFERING_NONE ||
+      (pstm->prop.buffering == STREAM_BUFFERING_LINE &&
+       memchr(str, '\n', size) != NULL))
+    Flush_Block(pstm);
+
+  Update_Counters_Block(pstm, str, size);
+
+  return size;
 }
 
 
@@ -1533,22 +1961,13 @@ Pl_Stream_Printf(StmInf *pstm, char *format, ...)
 {
   va_list arg_ptr;
   static char str[BIG_BUFFER];
-  char *p;
-  int c;
 
 
   va_start(arg_ptr, format);
   vsprintf(str, format, arg_ptr);
   va_end(arg_ptr);
 
-  for (p = str; *p; p++)
-    {
-      c = *p;
-      Basic_Call_Fct_Putc(c, pstm); /* like Stream_Putc */
-      Update_Counters(pstm, c);
-    }
-
-  return p - str;
+  return Pl_Stream_Write(str, strlen(str), pstm);
 }
 
 
@@ -1563,7 +1982,13 @@ Pl_Stream_Flush(StmInf *pstm)
 {
   PlLong file = pstm->file;
 
-  if (pstm->prop.output && pstm->fct_flush != STREAM_FCT_UNDEFINED)
+  if (!pstm->prop.output)
+    return;
+
+  if (pstm->buff)
+    Flush_Block(pstm);
+
+  if (pstm->fct_flush != STREAM_FCT_UNDEFINED)
     (*pstm->fct_flush) (file);
 }
 
@@ -1580,6 +2005,9 @@ Pl_Stream_Close(StmInf *pstm)
   PlLong file = pstm->file;
   int ret = 0;
 
+  if (pstm->buff && pstm->prop.output)
+    Flush_Block(pstm);
+
   if (pstm->fct_close != STREAM_FCT_UNDEFINED)
     ret = (*pstm->fct_close) (file);
 
@@ -1622,12 +2050,10 @@ void
 Pl_Stream_Get_Position(StmInf *pstm, PlLong *offset, PlLong *char_count,
 		       PlLong *line_count, PlLong *line_pos)
 {
-  PlLong file = pstm->file;
-
   *offset = 0;
-  if (pstm->prop.reposition && pstm->fct_tell != STREAM_FCT_UNDEFINED)
+  if (pstm->prop.reposition)
     {
-      if ((*offset = (*pstm->fct_tell) (file)) < 0)
+      if ((*offset = Stream_Tell(pstm)) < 0)
 	*offset = 0;
       else
 	{
@@ -1665,7 +2091,7 @@ Pl_Stream_Set_Position(StmInf *pstm, int whence, PlLong offset, PlLong char_coun
   PlLong file = pstm->file;
   int x;
 
-  x = (*pstm->fct_seek) (file, (PlLong) offset, whence);
+  x = Stream_Seek(pstm, offset, whence);
   if (x != 0)
     return x;
 
@@ -1711,11 +2137,11 @@ Pl_Stream_Set_Position_LC(StmInf *pstm, PlLong line_count, PlLong line_pos)
   int save_char_nb_elems;
 
 
-  offset = (*pstm->fct_tell) (file);
+  offset = Stream_Tell(pstm);
   if (offset < 0)
     return offset;
 
-  x = (*pstm->fct_seek) (file, (PlLong) 0, SEEK_SET);
+  x = Stream_Seek(pstm, 0, SEEK_SET);
   if (x != 0)
     return x;
 
@@ -1768,7 +2194,7 @@ err:
   pstm->line_pos = save_line_pos;
   pstm->pb_char.nb_elems = save_char_nb_elems;
 
-  x = (*pstm->fct_seek) (file, (PlLong) offset, SEEK_SET);
+  x = Stream_Seek(pstm, offset, SEEK_SET);
   if (x != 0)
     return x;
 
@@ -1807,6 +2233,8 @@ Pl_Add_Str_Stream(char *buff, int prop_other)
     {
       str_stream = (StrSInf *) Malloc(sizeof(StrSInf));
       str_stream->buff_alloc_size = 0;
+      str_stream->fixed = FALSE;
+      str_stream->lost = 0;
     }
 
   if (buff)
@@ -1901,46 +2329,715 @@ Pl_Term_Write_Str_Stream(int stm)
 
 
 /*-------------------------------------------------------------------------*
- * STR_STREAM_GETC                                                         *
+ * PL_TERM_WRITE_STR_STREAM_ATOM                                           *
  *                                                                         *
+ * Same as Pl_Term_Write_Str_Stream() but return the atom of the output.   *
+ * A large buffer is directly given to the atom table (no copy) if the atom*
+ * is new. The stream can then only be deleted.                            *
  *-------------------------------------------------------------------------*/
-static int
-Str_Stream_Getc(StrSInf *str_stream)
+int
+Pl_Term_Write_Str_Stream_Atom(int stm)
 {
-  int c;
+  StrSInf *str_stream;
+  int len;
+  Bool adopted;
+  int atom;
 
-  c = *(str_stream->ptr);
-  if (c == '\0')
-    return EOF;
+  str_stream = (StrSInf *) (pl_stm_tbl[stm]->file);
+  *(str_stream->ptr) = '\0';
+  len = str_stream->ptr - str_stream->buff;
 
-  (str_stream->ptr)++;
+  if (len < STR_STREAM_ADOPT_SIZE)
+    return Pl_Create_Allocate_Atom(str_stream->buff);
 
-  return c;
+  str_stream->buff = (char *) Realloc(str_stream->buff, len + 1); /* shrink */
+  str_stream->buff_alloc_size = len + 1;
+  str_stream->ptr = str_stream->buff + len;
+
+  atom = Pl_Create_Atom_From_Buffer(str_stream->buff, len, &adopted);
+  if (adopted)			/* a new buff will be allocated if reused */
+    {
+      str_stream->buff = NULL;
+      str_stream->buff_alloc_size = 0;
+    }
+
+  return atom;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * STR_STREAM_PUTC                                                         *
+ * PL_ADD_MMAP_STREAM                                                      *
  *                                                                         *
+ * An input stream whose block buffer is the whole file mapped in memory  *
+ * (it is never filled and positioning is only pointer arithmetic). Where *
+ * mmap is not available the file is read in a malloc'ed buffer.          *
+ * Return -1 on error (see errno).                                         *
  *-------------------------------------------------------------------------*/
-static void
-Str_Stream_Putc(int c, StrSInf *str_stream)
+int
+Pl_Add_Mmap_Stream(char *path, Bool text)
 {
-  int size = str_stream->ptr - str_stream->buff;
-  int new_size;
+  static char empty[1];
+  char open_str[10];
+  StmProp prop = Pl_Prop_And_Stdio_Mode(STREAM_MODE_READ, text, open_str);
+  MmapSInf *mm_stream;
+  struct stat st;
+  char *base;
+  int fd;
+  int stm;
+  StmInf *pstm;
 
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return -1;
 
-  if (size >= str_stream->buff_alloc_size - 1)	/* -1 for last '\0' */
+  if (fstat(fd, &st) < 0)
     {
-      new_size = str_stream->buff_alloc_size + STR_STREAM_WRITE_BLOCK;
-
-      str_stream->buff = Realloc(str_stream->buff, new_size);
-
-      str_stream->buff_alloc_size = new_size;
-      str_stream->ptr = str_stream->buff + size;
+      close(fd);
+      return -1;
     }
 
-  *(str_stream->ptr)++ = c;
-}
+  if (st.st_size == 0)
+    base = empty;
+  else
+    {
+#ifndef _WIN32
+      base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (base == MAP_FAILED)
+	{
+	  close(fd);
+	  return -1;
+	}
+#ifdef MADV_SEQUENTIAL
+      madvise(base, st.st_size, MADV_SEQUENTIAL);
+#endif
+#else
+      base = (char *) Malloc(st.st_size);
+      if (read(fd, base, st.st_size) != st.st_size)
+	{
+	  Free(base);
+	  close(fd);
+	  errno = EIO;
+	  return -1;
+	}
+#endif
+    }
+  close(fd);
+
+  mm_stream = (MmapSInf *) Malloc(sizeof(MmapSInf));
+  mm_stream->base = base;
+  mm_stream->size = st.st_size;
+  mm_stream->buff.buff = mm_stream->buff.ptr = base;
+  mm_stream->buff.end = base + st.st_size;
+  mm_stream->buff.size = 0;
+  mm_stream->buff.mapped = TRUE;
+
+  stm = Find_Free_Stream();
+  pstm = pl_stm_tbl[stm];
+
+  Init_Stream_Struct(Pl_Create_Allocate_Atom(path), (PlLong) mm_stream, prop,
+		     (StmFct) Mmap_Getc, STREAM_FCT_UNDEFINED,
+		     STREAM_FCT_UNDEFINED, (StmFct) Mmap_Close,
+		     STREAM_FCT_UNDEFINED, STREAM_FCT_UNDEFINED,
+		     STREAM_FCT_UNDEFINED, pstm);
+
+  pstm->buff = &mm_stream->buff;	/* tell/seek handled on the buffer */
+
+  return stm;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MMAP_GETC                                                               *
+ *                                                                         *
+ * Not used since chars are directly taken from the buffer.                *
+ *-------------------------------------------------------------------------*/
+static int
+Mmap_Getc(MmapSInf *mm_stream)
+{
+  StmBuff *b = &mm_stream->buff;
+
+  return (b->ptr < b->end) ? (unsigned char) *(b->ptr)++ : EOF;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MMAP_CLOSE                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Mmap_Close(MmapSInf *mm_stream)
+{
+  int ret = 0;
+
+  if (mm_stream->size > 0)
+    {
+#ifndef _WIN32
+      ret = munmap(mm_stream->base, mm_stream->size);
+#else
+      Free(mm_stream->base);
+#endif
+    }
+
+  Free(mm_stream);
+
+  return ret;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * The following functions handle buffer streams: streams on a buffer      *
+ * owned by the caller (used by the foreign interface and the built-ins    *
+ * reading from an atom/chars/codes or a number, see const_io_c.c).        *
+ * Such a stream is not recorded in pl_stm_tbl (no stream term, no alias)  *
+ * and its data are static: opening it costs nothing but only one input    *
+ * and one output buffer stream can be used at a time.                     *
+ * An input buffer stream reads the size chars of buff (no final '\0' is   *
+ * needed) and the scanner works directly on buff (like a mapped file).    *
+ * An output buffer stream stores at most size - 1 chars (+ the final '\0')*
+ * in buff, the exceeding chars are only counted (like snprintf).          *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OPEN_BUFFER_STREAM_IN                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+StmInf *
+Pl_Open_Buffer_Stream_In(char *buff, int size)
+{
+  MmapSInf *mm_stream = &buff_stream_rd_inf;
+
+  mm_stream->base = buff;
+  mm_stream->size = 0;		/* not mapped: nothing to release */
+  mm_stream->buff.buff = mm_stream->buff.ptr = buff;
+  mm_stream->buff.end = buff + size;
+  mm_stream->buff.size = 0;
+  mm_stream->buff.mapped = TRUE;
+
+  Init_Buffer_Stream(&buff_stream_rd, (PlLong) mm_stream, TRUE,
+		     (StmFct) Mmap_Getc, STREAM_FCT_UNDEFINED);
+
+  buff_stream_rd.buff = &mm_stream->buff;
+
+  return &buff_stream_rd;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OPEN_BUFFER_STREAM_OUT                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+StmInf *
+Pl_Open_Buffer_Stream_Out(char *buff, int size)
+{
+  StrSInf *str_stream = &buff_stream_wr_inf;
+
+  str_stream->buff = str_stream->ptr = buff;
+  str_stream->buff_alloc_size = size;
+  str_stream->fixed = TRUE;
+  str_stream->lost = 0;
+
+  return Init_Buffer_Stream(&buff_stream_wr, (PlLong) str_stream, FALSE,
+			    (StmFct) Str_Stream_Getc, (StmFct) Str_Stream_Putc);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CLOSE_BUFFER_STREAM_OUT                                              *
+ *                                                                         *
+ * Terminate the output by '\0' (if size > 0) and return the length of the *
+ * whole output (i.e. including the chars which could not be stored).      *
+ *-------------------------------------------------------------------------*/
+PlLong
+Pl_Close_Buffer_Stream_Out(StmInf *pstm)
+{
+  StrSInf *str_stream = (StrSInf *) pstm->file;
+
+  if (str_stream->buff_alloc_size > 0)
+    *(str_stream->ptr) = '\0';
+
+  return (str_stream->ptr - str_stream->buff) + str_stream->lost;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INIT_BUFFER_STREAM                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static StmInf *
+Init_Buffer_Stream(StmInf *pstm, PlLong file, Bool input,
+		   StmFct fct_getc, StmFct fct_putc)
+{
+  StmProp prop;
+
+  prop.mode = (input) ? STREAM_MODE_READ : STREAM_MODE_WRITE;
+  prop.input = input;
+  prop.output = !input;
+  prop.text = 1;
+  prop.reposition = FALSE;
+  prop.buffering = STREAM_BUFFERING_NONE;
+  prop.eof_action = STREAM_EOF_ACTION_EOF_CODE;
+  prop.special_close = TRUE;
+  prop.other = 0;
+
+  Init_Stream_Struct(atom_constant_term_stream, file, prop,
+		     fct_getc, fct_putc,
+		     STREAM_FCT_UNDEFINED, STREAM_FCT_UNDEFINED,
+		     STREAM_FCT_UNDEFINED, STREAM_FCT_UNDEFINED,
+		     STREAM_FCT_UNDEFINED, pstm);
+
+  return pstm;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STR_STREAM_GETC                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Str_Stream_Getc(StrSInf *str_stream)
+{
+  int c;
+
+  c = *(str_stream->ptr);
+  if (c == '\0')
+    return EOF;
+
+  (str_stream->ptr)++;
+
+  return c;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STR_STREAM_PUTC                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Str_Stream_Putc(int c, StrSInf *str_stream)
+{
+  if (str_stream->ptr - str_stream->buff >= str_stream->buff_alloc_size - 1)
+    {				/* -1 above for last '\0' */
+      if (str_stream->fixed)
+	{
+	  str_stream->lost++;
+	  return;
+	}
+      Str_Stream_Reserve(str_stream, 1);
+    }
+
+  *(str_stream->ptr)++ = c;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STR_STREAM_WRITE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Str_Stream_Write(StrSInf *str_stream, char *str, int size)
+{
+  int room = str_stream->buff_alloc_size - 1 - (str_stream->ptr - str_stream->buff);
+
+  if (size > room)
+    {
+      if (!str_stream->fixed)
+	Str_Stream_Reserve(str_stream, size);
+      else
+	{
+	  if (room < 0)
+	    room = 0;
+	  str_stream->lost += size - room;
+	  size = room;
+	}
+    }
+
+  memcpy(str_stream->ptr, str, size);
+  str_stream->ptr += size;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STR_STREAM_RESERVE                                                      *
+ *                                                                         *
+ * Ensure room for n more chars (+ the final '\0'). The buffer grows       *
+ * geometrically so that emitting a large output remains linear.          *
+ *-------------------------------------------------------------------------*/
+static void
+Str_Stream_Reserve(StrSInf *str_stream, int n)
+{
+  int size = str_stream->ptr - str_stream->buff;
+  int new_size = str_stream->buff_alloc_size;
+
+  while (size + n >= new_size)
+    new_size += (new_size < STR_STREAM_WRITE_BLOCK) ? STR_STREAM_WRITE_BLOCK :
+      new_size;
+
+  str_stream->buff = Realloc(str_stream->buff, new_size);
+
+  str_stream->buff_alloc_size = new_size;
+  str_stream->ptr = str_stream->buff + size;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * The following functions handle the block buffer of a stream (if any).  *
+ * An input buffer contains the chars in [ptr, end[ not yet consumed. An   *
+ * output buffer contains the chars in [buff, ptr[ not yet written (end is *
+ * then the end of the buffer). The file position of the accessor is thus *
+ * shifted by the buffer contents (see Stream_Tell/Stream_Seek).           *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * FILL_BLOCK                                                              *
+ *                                                                         *
+ * Refill an (empty) input buffer and return its first char (or EOF).      *
+ *-------------------------------------------------------------------------*/
+static int
+Fill_Block(StmInf *pstm)
+{
+  StmBuff *b = pstm->buff;
+  int n;
+
+  if (b->mapped)		/* the whole file is in the buffer */
+    return EOF;
+
+  n = (*pstm->fct_read) (pstm->file, b->buff, b->size);
+  if (n <= 0)
+    {
+      b->ptr = b->end = b->buff;
+      return EOF;
+    }
+
+  b->ptr = b->buff + 1;
+  b->end = b->buff + n;
+
+  return (unsigned char) *(b->buff);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * WRITE_BLOCK                                                             *
+ *                                                                         *
+ * Write the contents of an output buffer. Returns FALSE if only a part    *
+ * could be written (non-blocking descriptor not ready): the remaining     *
+ * chars are kept at the beginning of the buffer.                          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Write_Block(StmInf *pstm)
+{
+  StmBuff *b = pstm->buff;
+  int size = b->ptr - b->buff;
+  int n;
+
+  if (size > 0 &&
+      (n = (*pstm->fct_write) (pstm->file, b->buff, size)) >= 0 && n < size)
+    {
+      memmove(b->buff, b->buff + n, size - n);
+      b->ptr = b->buff + size - n;
+      return FALSE;
+    }
+
+  b->ptr = b->buff;
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FLUSH_BLOCK                                                             *
+ *                                                                         *
+ * A write which would block raises a system_error (the unwritten chars    *
+ * are kept and written by the next flush) unless the os_error flag is not *
+ * error (the chars are then lost).                                        *
+ *-------------------------------------------------------------------------*/
+static void
+Flush_Block(StmInf *pstm)
+{
+  if (!Write_Block(pstm))
+    {
+      Pl_Os_Error(-1);
+      pstm->buff->ptr = pstm->buff->buff;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FLUSH_BLOCK_STREAMS                                                     *
+ *                                                                         *
+ * Called at exit (stdio only flushes its own buffers).                    *
+ *-------------------------------------------------------------------------*/
+static void
+Flush_Block_Streams(void)
+{
+  int stm;
+  StmInf *pstm;
+
+  for (stm = 0; stm <= pl_stm_last_used; stm++)
+    if ((pstm = pl_stm_tbl[stm]) != NULL && pstm->buff && pstm->prop.output)
+      Write_Block(pstm);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UPDATE_COUNTERS_BLOCK                                                   *
+ *                                                                         *
+ * Same as Update_Counters() for a whole block of chars.                   *
+ *-------------------------------------------------------------------------*/
+static void
+Update_Counters_Block(StmInf *pstm, char *str, int size)
+{
+  char *end = str + size;
+  char *last_nl = NULL;
+  char *p;
+
+  pstm->char_count += size;
+
+  for (p = str; (p = memchr(p, '\n', end - p)) != NULL; p++)
+    {
+      pstm->line_count++;
+      last_nl = p;
+    }
+
+  if (last_nl)
+    pstm->line_pos = end - (last_nl + 1);
+  else
+    pstm->line_pos += size;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STREAM_TELL                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static PlLong
+Stream_Tell(StmInf *pstm)
+{
+  StmBuff *b = pstm->buff;
+  PlLong offset;
+
+  if (b && b->mapped)
+    return b->ptr - b->buff;
+
+  if (pstm->fct_tell == STREAM_FCT_UNDEFINED)
+    return -1;
+
+  offset = (*pstm->fct_tell) (pstm->file);
+  if (offset >= 0 && b)
+    offset += (pstm->prop.output) ? b->ptr - b->buff : b->ptr - b->end;
+
+  return offset;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STREAM_SEEK                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Stream_Seek(StmInf *pstm, PlLong offset, int whence)
+{
+  StmBuff *b = pstm->buff;
+
+  if (b && b->mapped)		/* simply move into the buffer */
+    {
+      if (whence == SEEK_CUR)
+	offset += b->ptr - b->buff;
+      else if (whence == SEEK_END)
+	offset += b->end - b->buff;
+
+      if (offset < 0 || offset > b->end - b->buff)
+	return -1;
+
+      b->ptr = b->buff + offset;
+      return 0;
+    }
+
+  if (b)
+    {
+      if (pstm->prop.output)
+	Flush_Block(pstm);
+      else
+	{
+	  if (whence == SEEK_CUR)	/* relative to what is consumed */
+	    offset += b->ptr - b->end;
+	  b->ptr = b->end = b->buff;
+	}
+    }
+
+  return (*pstm->fct_seek) (pstm->file, offset, whence);
+}
+
+
+
+
+#ifndef FOR_EXTERNAL_USE
+
+/*-------------------------------------------------------------------------*
+ * The following functions implement streams on file descriptors (used by *
+ * open/4). They are always used with a block buffer (so Fd_Getc/Fd_Putc   *
+ * are only provided for completeness).                                    *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * FD_GETC                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Getc(FdSInf *fd_stream)
+{
+  char c;
+
+  return (Fd_Read(fd_stream, &c, 1) == 1) ? (unsigned char) c : EOF;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_PUTC                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Putc(int c, FdSInf *fd_stream)
+{
+  char ch = c;
+
+  return (Fd_Write(fd_stream, &ch, 1) == 1) ? c : EOF;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_READ                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Read(FdSInf *fd_stream, char *buff, int size)
+{
+  int n;
+
+  do
+    n = read(fd_stream->fd, buff, size);
+  while (n < 0 && errno == EINTR);
+
+  if (n < 0 && Fd_Would_Block())	/* non-blocking and no input */
+    Pl_Os_Error(-1);
+
+  return n;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_WRITE                                                                *
+ *                                                                         *
+ * On a non-blocking descriptor which is not ready, returns the number of  *
+ * chars written so far (< size) with errno set (see Write_Block).         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Write(FdSInf *fd_stream, char *buff, int size)
+{
+  int n;
+  int done = 0;
+
+  while (done < size)
+    {
+      n = write(fd_stream->fd, buff + done, size - done);
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  if (Fd_Would_Block())
+	    break;
+	  return -1;
+	}
+      done += n;
+    }
+
+  return done;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_CLOSE                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Close(FdSInf *fd_stream)
+{
+  int ret = close(fd_stream->fd);
+
+  Free(fd_stream->buff.buff);
+  Free(fd_stream);
+
+  return ret;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_TELL                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Tell(FdSInf *fd_stream)
+{
+  return lseek(fd_stream->fd, 0, SEEK_CUR);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_SEEK                                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Fd_Seek(FdSInf *fd_stream, PlLong offset, int whence)
+{
+  return (lseek(fd_stream->fd, offset, whence) < 0) ? -1 : 0;
+}
+
+#endif /* !FOR_EXTERNAL_USE */
@@ -125,6 +125,19 @@ PbStk;
 
 typedef int (*StmFct) ();	/* generic type for file fctions */
 
+
+
+
+typedef struct			/* Block buffer                   */
+{				/* ------------------------------ */
+  char *buff;			/* the buffer                     */
+  char *ptr;			/* current position into the buff */
+  char *end;			/* end of data (in) or buff (out) */
+  int size;			/* size of the buffer             */
+  Bool mapped;			/* is buff the whole file (mmap) ?*/
+}
+StmBuff;
+
 typedef struct stm_lst *PStmLst;
 
 typedef struct stm_lst		/* Chained stream list            */
@@ -149,6 +162,10 @@ typedef struct stm_inf		/* Stream information             */
   StmFct fct_tell;		/* tell     function (optional)   */
   StmFct fct_seek;		/* seek     function (optional)   */
   StmFct fct_clearerr;		/* clearerr function (optional)   */
+				/* ---- Block I/O (optional) ---- */
+  StmBuff *buff;		/* block buffer (NULL if none)    */
+  StmFct fct_read;		/* fill  fct (file, buff, size)   */
+  StmFct fct_write;		/* flush fct (file, buff, size)   */
 				/* ------ Read information  ----- */
   Bool eof_reached;		/* has eof char been read ?       */
   PbStk pb_char;		/* character push back stack      */
@@ -178,6 +195,8 @@ typedef struct			/* String Stream information      */
   char *buff;			/* the I/O buffer                 */
   char *ptr;			/* current position into the buff */
   Bool buff_alloc_size;		/* mallocated size (iff output)   */
+  Bool fixed;			/* caller's buff (cannot grow) ?  */
+  PlLong lost;			/* nb of chars not stored (fixed) */
 }
 StrSInf;
 
@@ -341,6 +360,13 @@ int Pl_Add_Stream_For_Stdio_Desc(FILE *f, int atom_path, int mode, Bool text,
 
 int Pl_Add_Stream_For_Stdio_File(char *path, int mode, Bool text);
 
+int Pl_Add_Stream_For_Fd_File(char *path, int mode, Bool text);
+
+int Pl_Add_Stream_For_Fd_Desc(int fd, int atom_path, int mode, Bool text);
+
+void Pl_Set_Stream_Block_IO(int stm, StmBuff *buff,
+			    StmFct fct_read, StmFct fct_write);
+
 void Pl_Delete_Stream(int stm);
 
 int Pl_Find_Stream_By_Alias(int atom_alias);
@@ -385,8 +411,16 @@ void Pl_Stream_Ungetc(int c, StmInf *pstm);
 
 int Pl_Stream_Peekc(StmInf *pstm);
 
+char *Pl_Stream_Block_Peek(StmInf *pstm, char **end);
+
+Bool Pl_Stream_Input_Pending(StmInf *pstm);
+
+void Pl_Stream_Block_Skip(StmInf *pstm, char *p);
+
 char *Pl_Stream_Gets(char *str, int size, StmInf *pstm);
 
+int Pl_Stream_Read(char *buff, int size, StmInf *pstm);
+
 char *Pl_Stream_Gets_Prompt(char *prompt, StmInf *pstm_o,
 			 char *str, int size, StmInf *pstm_i);
 
@@ -394,6 +428,8 @@ void Pl_Stream_Putc(int c, StmInf *pstm);
 
 int Pl_Stream_Puts(char *str, StmInf *pstm);
 
+int Pl_Stream_Write(char *str, int size, StmInf *pstm);
+
 int Pl_Stream_Printf(StmInf *pstm, char *format, ...);
 
 void Pl_Stream_Flush(StmInf *pstm);
@@ -416,10 +452,20 @@ int Pl_Stream_Set_Position_LC(StmInf *pstm, PlLong line_count, PlLong line_pos);
 
 int Pl_Add_Str_Stream(char *buff, int prop_other);
 
+int Pl_Add_Mmap_Stream(char *path, Bool text);
+
 void Pl_Delete_Str_Stream(int stm);
 
 char *Pl_Term_Write_Str_Stream(int stm);
 
+int Pl_Term_Write_Str_Stream_Atom(int stm);
+
+StmInf *Pl_Open_Buffer_Stream_In(char *buff, int size);
+
+StmInf *Pl_Open_Buffer_Stream_Out(char *buff, int size);
+
+PlLong Pl_Close_Buffer_Stream_Out(StmInf *pstm);
+
 
 void Pl_Close_Stm(int stm, Bool force); /* from close_c.c */
 
@@ -37,6 +37,8 @@
 
 
 #include <string.h>
+#include <limits.h>
+#include <stdint.h>
 
 #define TERM_SUPP_FILE
 
@@ -47,15 +49,34 @@
 
 
 /*---------------------------------*
- * Constants                       *
+ * Constants                                                               *
  *---------------------------------*/
 
+#define FAST_TERM_MAGIC            0xFA
+#define FAST_TERM_VERSION          1
+
+#define FT_VAR                     0	/* tags of the fast term format */
+#define FT_ATOM                    1
+#define FT_NIL                     2
+#define FT_INT                     3
+#define FT_FLT                     4
+#define FT_LIST                    5
+#define FT_STC                     6
+
+#define FT_MAX_ITEM_SIZE           (1 + 2 * 10)	/* tag + 2 varints */
+
+#define SER_CHECK_CYCLIC_SIZE      (1 << 16)	/* from: check the term is acyclic */
+#define SER_MAX_BUFF_SIZE          (1 << 29)
+
+
+
+
 /*---------------------------------*
- * Type Definitions                *
+ * Type Definitions                                                        *
  *---------------------------------*/
 
 /*---------------------------------*
- * Global Variables                *
+ * Global Variables                                                        *
  *---------------------------------*/
 
 	  /* copy term variables */
@@ -66,19 +87,62 @@ static WamWord vars[MAX_VAR_IN_TERM * 2];	/* needs 2 words for a variable */
 static WamWord *end_vars = vars + MAX_VAR_IN_TERM * 2;
 static WamWord *top_vars;
 
+	  /* fast term (de)serialization */
+
+static WamWord ser_var[MAX_VAR_IN_TERM]; /* a seen var is bound to one cell */
+static int ser_nb_var;
+
+static int *ser_atom_index;	/* atom -> index in the atom table */
+static unsigned *ser_atom_stamp;	/* index valid iff stamp is current */
+static unsigned ser_stamp;
+static int *ser_atom;		/* the atom table of the record */
+static int ser_nb_atom;
+static int ser_atom_size;
+
+static WamWord ser_start_word;	/* the term being encoded */
+static Bool ser_acyclic;	/* the term is known to be acyclic */
+static char *ser_buff;		/* the encoded term */
+static char *ser_ptr;
+static char *ser_end;
+static char *ser_limit;		/* Ser_Grow() is called from there */
+
+static char *ser_rec;		/* the whole record */
+static int ser_rec_size;
+
+static char *deser_ptr;
+static char *deser_end;
+static int *deser_atom;
+static int deser_nb_atom;
+static int deser_atom_size;
+static char *deser_name;
+static int deser_name_size;
+static WamWord *deser_var[MAX_VAR_IN_TERM];
+static int deser_nb_var;
+static int deser_max_var;
+
 
 
 
 /*---------------------------------*
- * Function Prototypes             *
+ * Function Prototypes                                                     *
  *---------------------------------*/
 
 static void Copy_Term_Rec(WamWord *dst_adr, WamWord *src_adr, WamWord **p);
 
-static Bool Term_Hash(WamWord start_word, PlLong depth, unsigned *hash);
-
 static Bool Term_Hash_Rec(WamWord start_word, PlLong depth, HashIncrInfo *hi);
 
+static void Serialize_Rec(WamWord start_word);
+
+static void Ser_Restore_Vars(void);
+
+static int Ser_Atom(int atom);
+
+static void Ser_Grow(void);
+
+static Bool Deserialize_Header(void);
+
+static Bool Deserialize_Rec(WamWord *dst_adr);
+
 
 
 
@@ -555,6 +619,578 @@ terminal_rec:
 
 
 
+
+
+/*-------------------------------------------------------------------------*
+ * The following functions (de)serialize a term in a compact binary       *
+ * format (used by fast_read/fast_write, term_to_bytes/bytes_to_term). A   *
+ * record is                                                               *
+ *                                                                         *
+ *   MAGIC VERSION size nb_atoms (len name)... nb_vars term                *
+ *                                                                         *
+ * where size is the number of bytes after it and the integers are varints *
+ * (7 bits per byte, the high bit set means more bytes follow). The term   *
+ * is a prefix encoding:                                                   *
+ *                                                                         *
+ *   FT_VAR index    (variables are numbered in order of first occurrence) *
+ *   FT_ATOM index   (in the atom table of the record)                     *
+ *   FT_NIL                                                                *
+ *   FT_INT zigzag   (i.e. (x << 1) ^ (x >> 63) so small negatives are     *
+ *                    short)                                               *
+ *   FT_FLT 8 bytes  (IEEE 754, least significant byte first)              *
+ *   FT_LIST car cdr                                                       *
+ *   FT_STC functor_index arity arg...                                     *
+ *                                                                         *
+ * Like Pl_Copy_Term(), the traversal iterates on the last argument (no C  *
+ * recursion on list tails) and marks the variables by binding them (to a  *
+ * cell of ser_var) during the traversal. Thus an atom is only interned    *
+ * once per record at reading and the sharing of variables is preserved.   *
+ * FD variables are written as plain variables (constraints are lost).     *
+ *-------------------------------------------------------------------------*/
+
+#define Put_Varint(q, x)			\
+  do						\
+    {						\
+      PlULong _x = (x);				\
+						\
+      while (_x >= 0x80)			\
+	{					\
+	  *(q)++ = (char) (_x | 0x80);		\
+	  _x >>= 7;				\
+	}					\
+      *(q)++ = (char) _x;			\
+    }						\
+  while (0)
+
+
+#define Varint_Size(x, n)			\
+  do						\
+    {						\
+      PlULong _x = (x);				\
+						\
+      for ((n) = 1; _x >= 0x80; (n)++)		\
+	_x >>= 7;				\
+    }						\
+  while (0)
+
+
+#define Get_Varint(x)				\
+  do						\
+    {						\
+      int _shift = 0;				\
+      int _c;					\
+						\
+      (x) = 0;					\
+      do					\
+	{					\
+	  if (deser_ptr >= deser_end || _shift >= WORD_SIZE)	\
+	    return FALSE;			\
+	  _c = (unsigned char) *deser_ptr++;	\
+	  (x) |= (PlULong) (_c & 0x7F) << _shift;	\
+	  _shift += 7;				\
+	}					\
+      while (_c & 0x80);			\
+    }						\
+  while (0)
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_SERIALIZE_TERM                                                       *
+ *                                                                         *
+ * Encode a term, store in *p_rec the record (valid until the next call)   *
+ * and return its size.                                                    *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Serialize_Term(WamWord start_word, char **p_rec)
+{
+  char *q;
+  int i, n, size;
+  char *name;
+
+  if (ser_atom_index == NULL)
+    {
+      ser_atom_index = (int *) Calloc(pl_max_atom, sizeof(int));
+      ser_atom_stamp = (unsigned *) Calloc(pl_max_atom, sizeof(unsigned));
+    }
+
+  if (++ser_stamp == 0)		/* wrap around: reset all stamps */
+    {
+      memset(ser_atom_stamp, 0, pl_max_atom * sizeof(unsigned));
+      ser_stamp = 1;
+    }
+
+  ser_nb_atom = 0;
+  ser_nb_var = 0;
+  ser_start_word = start_word;
+  ser_acyclic = FALSE;
+  ser_ptr = ser_limit = ser_buff;
+  top_vars = vars;
+
+  Serialize_Rec(start_word);
+
+  Ser_Restore_Vars();
+
+				/* size of the record after the header */
+  Varint_Size(ser_nb_atom, size);
+  for (i = 0; i < ser_nb_atom; i++)
+    {
+      n = pl_atom_tbl[ser_atom[i]].prop.length;
+      Varint_Size(n, n);
+      size += n + pl_atom_tbl[ser_atom[i]].prop.length;
+    }
+  Varint_Size(ser_nb_var, n);
+  size += n + (ser_ptr - ser_buff);
+
+  if (ser_rec_size < size + 2 + 10)
+    {
+      ser_rec_size = size + 2 + 10;
+      ser_rec = (char *) Realloc(ser_rec, ser_rec_size);
+    }
+
+  q = ser_rec;
+  *q++ = (char) FAST_TERM_MAGIC;
+  *q++ = FAST_TERM_VERSION;
+  Put_Varint(q, size);
+
+  Put_Varint(q, ser_nb_atom);
+  for (i = 0; i < ser_nb_atom; i++)
+    {
+      name = pl_atom_tbl[ser_atom[i]].name;
+      n = pl_atom_tbl[ser_atom[i]].prop.length;
+      Put_Varint(q, n);
+      memcpy(q, name, n);
+      q += n;
+    }
+  Put_Varint(q, ser_nb_var);
+  memcpy(q, ser_buff, ser_ptr - ser_buff);
+  q += ser_ptr - ser_buff;
+
+  *p_rec = ser_rec;
+  return q - ser_rec;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SERIALIZE_REC                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Serialize_Rec(WamWord start_word)
+{
+  WamWord word, tag_mask;
+  WamWord *adr;
+  PlLong x;
+  union
+  {
+    double d;
+    uint64_t u;
+  } dp;
+  int i;
+
+ terminal_rec:
+
+  if (ser_ptr >= ser_limit)
+    Ser_Grow();
+
+  DEREF(start_word, word, tag_mask);
+
+  switch (Tag_From_Tag_Mask(tag_mask))
+    {
+    case REF:
+      adr = UnTag_REF(word);
+      if (adr >= ser_var && adr < ser_var + MAX_VAR_IN_TERM) /* already seen */
+	{
+	  *ser_ptr++ = FT_VAR;
+	  Put_Varint(ser_ptr, adr - ser_var);
+	  return;
+	}
+      goto new_var;
+
+#ifndef NO_USE_FD_SOLVER
+    case FDV:
+      adr = UnTag_FDV(word);
+      goto new_var;
+#endif
+
+    case ATM:
+      if (word == NIL_WORD)
+	*ser_ptr++ = FT_NIL;
+      else
+	{
+	  *ser_ptr++ = FT_ATOM;
+	  Put_Varint(ser_ptr, Ser_Atom(UnTag_ATM(word)));
+	}
+      return;
+
+    case INT:
+      x = UnTag_INT(word);
+      *ser_ptr++ = FT_INT;
+      Put_Varint(ser_ptr, ((PlULong) x << 1) ^ (PlULong) (x >> (WORD_SIZE - 1)));
+      return;
+
+    case FLT:
+      dp.d = Pl_Obtain_Float(UnTag_FLT(word));
+      *ser_ptr++ = FT_FLT;
+      for (i = 0; i < 8; i++)
+	*ser_ptr++ = (char) (dp.u >> (8 * i));
+      return;
+
+    case LST:
+      adr = UnTag_LST(word);
+      *ser_ptr++ = FT_LIST;
+      Serialize_Rec(Car(adr));
+      start_word = Cdr(adr);
+      goto terminal_rec;
+
+    case STC:
+      adr = UnTag_STC(word);
+      i = Arity(adr);
+      *ser_ptr++ = FT_STC;
+      Put_Varint(ser_ptr, Ser_Atom(Functor(adr)));
+      Put_Varint(ser_ptr, i);
+      adr = &Arg(adr, 0);
+      while (--i)
+	Serialize_Rec(*adr++);
+      start_word = *adr;
+      goto terminal_rec;
+    }
+
+  return;
+
+ new_var:
+  if (ser_nb_var >= MAX_VAR_IN_TERM)
+    {
+      Ser_Restore_Vars();
+      Pl_Err_Resource(pl_resource_too_many_variables);
+    }
+
+  *top_vars++ = word;		/* word to restore    */
+  *top_vars++ = (WamWord) adr;	/* address to restore */
+  ser_var[ser_nb_var] = Tag_REF(&ser_var[ser_nb_var]);
+  *adr = Tag_REF(&ser_var[ser_nb_var]);
+
+  *ser_ptr++ = FT_VAR;
+  Put_Varint(ser_ptr, ser_nb_var);
+  ser_nb_var++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SER_RESTORE_VARS                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Ser_Restore_Vars(void)
+{
+  WamWord *p;
+
+  while (top_vars != vars)
+    {
+      p = (WamWord *) (*--top_vars);	/* address to restore */
+      *p = *--top_vars;		        /* word    to restore */
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SER_ATOM                                                                *
+ *                                                                         *
+ * Return the index of an atom in the atom table of the record (add it if  *
+ * needed).                                                                *
+ *-------------------------------------------------------------------------*/
+static int
+Ser_Atom(int atom)
+{
+  if (ser_atom_stamp[atom] == ser_stamp)
+    return ser_atom_index[atom];
+
+  if (ser_nb_atom >= ser_atom_size)
+    {
+      ser_atom_size = (ser_atom_size == 0) ? 64 : ser_atom_size * 2;
+      ser_atom = (int *) Realloc((char *) ser_atom, ser_atom_size * sizeof(int));
+    }
+
+  ser_atom_stamp[atom] = ser_stamp;
+  ser_atom[ser_nb_atom] = atom;
+
+  return ser_atom_index[atom] = ser_nb_atom++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SER_GROW                                                                *
+ *                                                                         *
+ * Called when ser_ptr reaches ser_limit: grow the buffer if needed. The   *
+ * encoding of a cyclic term never ends: after SER_CHECK_CYCLIC_SIZE bytes *
+ * the term is checked (only once) to be acyclic.                          *
+ *-------------------------------------------------------------------------*/
+static void
+Ser_Grow(void)
+{
+  int used = ser_ptr - ser_buff;
+  int size;
+
+  if (used >= SER_CHECK_CYCLIC_SIZE && !ser_acyclic)
+    {
+      if (!Pl_Acyclic_Term_1(ser_start_word))
+	{
+	  Ser_Restore_Vars();
+	  Pl_Err_Representation(pl_representation_cyclic_term);
+	}
+      ser_acyclic = TRUE;
+    }
+
+  if (ser_end - ser_ptr < FT_MAX_ITEM_SIZE)
+    {
+      size = (ser_buff == NULL) ? 4096 : (ser_end - ser_buff) * 2;
+      if (size > SER_MAX_BUFF_SIZE)
+	{
+	  Ser_Restore_Vars();
+	  Pl_Err_Resource(pl_resource_too_big_term);
+	}
+
+      ser_buff = (char *) Realloc(ser_buff, size);
+      ser_ptr = ser_buff + used;
+      ser_end = ser_buff + size;
+    }
+
+  ser_limit = ser_end - FT_MAX_ITEM_SIZE;
+  if (!ser_acyclic && ser_limit > ser_buff + SER_CHECK_CYCLIC_SIZE)
+    ser_limit = ser_buff + SER_CHECK_CYCLIC_SIZE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FAST_TERM_SIZE                                                       *
+ *                                                                         *
+ * Given the n first bytes of a record return its whole size, 0 if more    *
+ * bytes are needed to know it or -1 if it is not a valid record.          *
+ *-------------------------------------------------------------------------*/
+PlLong
+Pl_Fast_Term_Size(char *rec, int n)
+{
+  PlULong size = 0;
+  int i, c;
+
+  if (n >= 1 && (unsigned char) rec[0] != FAST_TERM_MAGIC)
+    return -1;
+
+  if (n >= 2 && rec[1] != FAST_TERM_VERSION)
+    return -1;
+
+  for (i = 2; i < n; i++)
+    {
+      if (i >= 2 + 5)		/* 35 bits: too large */
+	return -1;
+      c = (unsigned char) rec[i];
+      size |= (PlULong) (c & 0x7F) << (7 * (i - 2));
+      if ((c & 0x80) == 0)
+	return (size > INT_MAX - 16) ? -1 : (PlLong) size + i + 1;
+    }
+
+  return 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_DESERIALIZE_TERM                                                     *
+ *                                                                         *
+ * Decode a record (of size bytes) and return the term (created on the     *
+ * heap) or NOT_A_WAM_WORD if the record is not valid.                     *
+ *-------------------------------------------------------------------------*/
+WamWord
+Pl_Deserialize_Term(char *rec, int size)
+{
+  WamWord *root;
+
+  if (size <= 0 || Pl_Fast_Term_Size(rec, size) != size)
+    return NOT_A_WAM_WORD;
+
+  deser_ptr = rec + 2;
+  deser_end = rec + size;
+  while (*deser_ptr++ & 0x80)	/* skip size (already checked) */
+    ;
+
+  if (!Deserialize_Header())
+    return NOT_A_WAM_WORD;
+
+  root = H++;
+  if (!Deserialize_Rec(root) || deser_ptr != deser_end)
+    {
+      H = root;
+      return NOT_A_WAM_WORD;
+    }
+
+  return *root;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DESERIALIZE_HEADER                                                      *
+ *                                                                         *
+ * Read the atom table (interning the atoms) and the number of variables.  *
+ *-------------------------------------------------------------------------*/
+static Bool
+Deserialize_Header(void)
+{
+  PlULong n, len;
+  int i;
+
+  Get_Varint(n);
+  if (n > (PlULong) (deser_end - deser_ptr))	/* at least 1 byte per atom */
+    return FALSE;
+
+  if (deser_atom_size < (int) n)
+    {
+      deser_atom_size = n;
+      deser_atom = (int *) Realloc((char *) deser_atom, n * sizeof(int));
+    }
+  deser_nb_atom = n;
+
+  for (i = 0; i < deser_nb_atom; i++)
+    {
+      Get_Varint(len);
+      if (len > (PlULong) (deser_end - deser_ptr))
+	return FALSE;
+
+      if (deser_name_size <= (int) len)
+	{
+	  deser_name_size = len + 256;
+	  deser_name = (char *) Realloc(deser_name, deser_name_size);
+	}
+      memcpy(deser_name, deser_ptr, len);
+      deser_name[len] = '\0';
+      deser_ptr += len;
+      if (strlen(deser_name) != len)	/* no NUL allowed in an atom */
+	return FALSE;
+      deser_atom[i] = Pl_Create_Allocate_Atom(deser_name);
+    }
+
+  Get_Varint(n);
+  if (n > MAX_VAR_IN_TERM)
+    return FALSE;
+  deser_max_var = n;
+  deser_nb_var = 0;
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DESERIALIZE_REC                                                         *
+ *                                                                         *
+ * Decode a term and store it in *dst_adr (the term is built on the heap). *
+ *-------------------------------------------------------------------------*/
+static Bool
+Deserialize_Rec(WamWord *dst_adr)
+{
+  PlULong x, arity;
+  PlLong i;
+  union
+  {
+    double d;
+    uint64_t u;
+  } dp;
+  WamWord *adr;
+
+ terminal_rec:
+
+  if (deser_ptr >= deser_end)
+    return FALSE;
+
+  switch (*deser_ptr++)
+    {
+    case FT_VAR:
+      Get_Varint(x);
+      if (x < (PlULong) deser_nb_var)
+	*dst_adr = Tag_REF(deser_var[x]);
+      else if (x == (PlULong) deser_nb_var && x < (PlULong) deser_max_var)
+	{
+	  deser_var[deser_nb_var++] = dst_adr;
+	  *dst_adr = Tag_REF(dst_adr);
+	}
+      else
+	return FALSE;
+      return TRUE;
+
+    case FT_ATOM:
+      Get_Varint(x);
+      if (x >= (PlULong) deser_nb_atom)
+	return FALSE;
+      *dst_adr = Tag_ATM(deser_atom[x]);
+      return TRUE;
+
+    case FT_NIL:
+      *dst_adr = NIL_WORD;
+      return TRUE;
+
+    case FT_INT:
+      Get_Varint(x);
+      i = (PlLong) (x >> 1) ^ -(PlLong) (x & 1);
+      if (i < INT_LOWEST_VALUE || i > INT_GREATEST_VALUE)
+	return FALSE;
+      *dst_adr = Tag_INT(i);
+      return TRUE;
+
+    case FT_FLT:
+      if (deser_end - deser_ptr < 8)
+	return FALSE;
+      dp.u = 0;
+      for (i = 0; i < 8; i++)
+	dp.u |= (uint64_t) (unsigned char) *deser_ptr++ << (8 * i);
+      *dst_adr = Tag_FLT(H);
+      Pl_Global_Push_Float(dp.d);
+      return TRUE;
+
+    case FT_LIST:
+      adr = H;
+      H += 2;
+      *dst_adr = Tag_LST(adr);
+      if (!Deserialize_Rec(&Car(adr)))
+	return FALSE;
+      dst_adr = &Cdr(adr);
+      goto terminal_rec;
+
+    case FT_STC:
+      Get_Varint(x);
+      Get_Varint(arity);
+      if (x >= (PlULong) deser_nb_atom || arity < 1 || arity > MAX_ARITY)
+	return FALSE;
+      adr = H;
+      *dst_adr = Tag_STC(adr);
+      *H++ = Functor_Arity(deser_atom[x], arity);
+      H += arity;
+      adr = &Arg(adr, 0);
+      while (--arity)
+	if (!Deserialize_Rec(adr++))
+	  return FALSE;
+      dst_adr = adr;
+      goto terminal_rec;
+    }
+
+  return FALSE;
+}
+
+
+
 #if 0
 /*-------------------------------------------------------------------------*
  * PL_ACYCLIC_TERM_1                                                       *
@@ -766,11 +1402,13 @@ Pl_Acyclic_Term_1(WamWord start_word)
 
 
 /*-------------------------------------------------------------------------*
- * TERM_HASH                                                               *
+ * PL_TERM_HASH                                                            *
  *                                                                         *
+ * Compute the hash of a term (only the first depth levels are considered, *
+ * depth < 0 means the whole term). Fails if the term is not ground.       *
  *-------------------------------------------------------------------------*/
-static
-Bool Term_Hash(WamWord start_word, PlLong depth, unsigned *hash)
+Bool
+Pl_Term_Hash(WamWord start_word, PlLong depth, unsigned *hash)
 {
   HashIncrInfo hi;
 
@@ -892,7 +1530,7 @@ Pl_Term_Hash_4(WamWord start_word, WamWord depth_word, WamWord range_word,
 
   /* Term_Hash fails if the term is not ground, in that case leave hash_word unbound */
 
-  if (!Term_Hash(start_word, depth, &hash))
+  if (!Pl_Term_Hash(start_word, depth, &hash))
     return TRUE;
 
   return Pl_Un_Integer(hash % range, hash_word);
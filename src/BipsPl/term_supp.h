@@ -90,7 +90,15 @@ void Pl_Copy_Term(WamWord *dst_adr, WamWord *src_adr);
 
 void Pl_Copy_Contiguous_Term(WamWord *dst_adr, WamWord *src_adr);
 
+int Pl_Serialize_Term(WamWord start_word, char **p_rec);
+
+PlLong Pl_Fast_Term_Size(char *rec, int n);
+
+WamWord Pl_Deserialize_Term(char *rec, int size);
+
 int Pl_Get_Pred_Indicator(WamWord pred_indic_word, Bool must_be_ground,
 			  int *arity);
 
 Bool Pl_Acyclic_Term_1(WamWord start_word);
+
+Bool Pl_Term_Hash(WamWord start_word, PlLong depth, unsigned *hash);
@@ -37,6 +37,9 @@
 
 
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
 #include <ctype.h>
 
 #define OBJ_INIT Write_Supp_Initializer
@@ -130,10 +133,46 @@
 
 
 
+#define WRITE_BUFF_SIZE            4096
+
+
+
+
+#define DP_SIGNIFICAND_MASK        UINT64_C(0x000FFFFFFFFFFFFF)
+#define DP_HIDDEN_BIT              UINT64_C(0x0010000000000000)
+#define DP_EXPONENT_BIAS           (0x3FF + 52)
+#define DP_MAX_DIGITS              17
+
+#define GRISU_MIN_TARGET_EXP       (-60)
+#define GRISU_D_1_LOG2_10          0.30102999566398114	/* 1 / lg(10) */
+#define GRISU_CACHED_POW_OFFSET    348	/* -1 * the first decimal_exp */
+#define GRISU_CACHED_POW_STEP      8	/* decimal_exp distance */
+
+
+
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* "Do It Yourself" float         */
+{				/* ------------------------------ */
+  uint64_t f;			/* significand                    */
+  int e;			/* binary exponent: f * 2^e       */
+}
+DiyFp;
+
+
+
+
+typedef struct			/* Cached power of 10             */
+{				/* ------------------------------ */
+  uint64_t f;			/* normalized significand         */
+  short e;			/* its binary exponent            */
+  short k;			/* i.e. f * 2^e ~= 10^k           */
+}
+CachedPow;
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -155,9 +194,102 @@ static Bool portrayed;
 static WamWord *name_number_above_H;
 
 static Bool last_is_space;	/* to avoid duplicate spaces (e.g. with space_args) */
+
+static char write_buff[WRITE_BUFF_SIZE]; /* output is assembled here */
+static char *write_ptr = write_buff;	/* then emitted by Out_Flush */
 static int last_prefix_op = W_NO_PREFIX_OP;
 static Bool *p_bracket_op_minus;
 
+static const CachedPow grisu_cached_pow[] = { /* 10^-348, 10^-340,... 10^340 */
+  {UINT64_C(0xfa8fd5a0081c0288), -1220, -348},
+  {UINT64_C(0xbaaee17fa23ebf76), -1193, -340},
+  {UINT64_C(0x8b16fb203055ac76), -1166, -332},
+  {UINT64_C(0xcf42894a5dce35ea), -1140, -324},
+  {UINT64_C(0x9a6bb0aa55653b2d), -1113, -316},
+  {UINT64_C(0xe61acf033d1a45df), -1087, -308},
+  {UINT64_C(0xab70fe17c79ac6ca), -1060, -300},
+  {UINT64_C(0xff77b1fcbebcdc4f), -1034, -292},
+  {UINT64_C(0xbe5691ef416bd60c), -1007, -284},
+  {UINT64_C(0x8dd01fad907ffc3c),  -980, -276},
+  {UINT64_C(0xd3515c2831559a83),  -954, -268},
+  {UINT64_C(0x9d71ac8fada6c9b5),  -927, -260},
+  {UINT64_C(0xea9c227723ee8bcb),  -901, -252},
+  {UINT64_C(0xaecc49914078536d),  -874, -244},
+  {UINT64_C(0x823c12795db6ce57),  -847, -236},
+  {UINT64_C(0xc21094364dfb5637),  -821, -228},
+  {UINT64_C(0x9096ea6f3848984f),  -794, -220},
+  {UINT64_C(0xd77485cb25823ac7),  -768, -212},
+  {UINT64_C(0xa086cfcd97bf97f4),  -741, -204},
+  {UINT64_C(0xef340a98172aace5),  -715, -196},
+  {UINT64_C(0xb23867fb2a35b28e),  -688, -188},
+  {UINT64_C(0x84c8d4dfd2c63f3b),  -661, -180},
+  {UINT64_C(0xc5dd44271ad3cdba),  -635, -172},
+  {UINT64_C(0x936b9fcebb25c996),  -608, -164},
+  {UINT64_C(0xdbac6c247d62a584),  -582, -156},
+  {UINT64_C(0xa3ab66580d5fdaf6),  -555, -148},
+  {UINT64_C(0xf3e2f893dec3f126),  -529, -140},
+  {UINT64_C(0xb5b5ada8aaff80b8),  -502, -132},
+  {UINT64_C(0x87625f056c7c4a8b),  -475, -124},
+  {UINT64_C(0xc9bcff6034c13053),  -449, -116},
+  {UINT64_C(0x964e858c91ba2655),  -422, -108},
+  {UINT64_C(0xdff9772470297ebd),  -396, -100},
+  {UINT64_C(0xa6dfbd9fb8e5b88f),  -369,  -92},
+  {UINT64_C(0xf8a95fcf88747d94),  -343,  -84},
+  {UINT64_C(0xb94470938fa89bcf),  -316,  -76},
+  {UINT64_C(0x8a08f0f8bf0f156b),  -289,  -68},
+  {UINT64_C(0xcdb02555653131b6),  -263,  -60},
+  {UINT64_C(0x993fe2c6d07b7fac),  -236,  -52},
+  {UINT64_C(0xe45c10c42a2b3b06),  -210,  -44},
+  {UINT64_C(0xaa242499697392d3),  -183,  -36},
+  {UINT64_C(0xfd87b5f28300ca0e),  -157,  -28},
+  {UINT64_C(0xbce5086492111aeb),  -130,  -20},
+  {UINT64_C(0x8cbccc096f5088cc),  -103,  -12},
+  {UINT64_C(0xd1b71758e219652c),   -77,   -4},
+  {UINT64_C(0x9c40000000000000),   -50,    4},
+  {UINT64_C(0xe8d4a51000000000),   -24,   12},
+  {UINT64_C(0xad78ebc5ac620000),     3,   20},
+  {UINT64_C(0x813f3978f8940984),    30,   28},
+  {UINT64_C(0xc097ce7bc90715b3),    56,   36},
+  {UINT64_C(0x8f7e32ce7bea5c70),    83,   44},
+  {UINT64_C(0xd5d238a4abe98068),   109,   52},
+  {UINT64_C(0x9f4f2726179a2245),   136,   60},
+  {UINT64_C(0xed63a231d4c4fb27),   162,   68},
+  {UINT64_C(0xb0de65388cc8ada8),   189,   76},
+  {UINT64_C(0x83c7088e1aab65db),   216,   84},
+  {UINT64_C(0xc45d1df942711d9a),   242,   92},
+  {UINT64_C(0x924d692ca61be758),   269,  100},
+  {UINT64_C(0xda01ee641a708dea),   295,  108},
+  {UINT64_C(0xa26da3999aef774a),   322,  116},
+  {UINT64_C(0xf209787bb47d6b85),   348,  124},
+  {UINT64_C(0xb454e4a179dd1877),   375,  132},
+  {UINT64_C(0x865b86925b9bc5c2),   402,  140},
+  {UINT64_C(0xc83553c5c8965d3d),   428,  148},
+  {UINT64_C(0x952ab45cfa97a0b3),   455,  156},
+  {UINT64_C(0xde469fbd99a05fe3),   481,  164},
+  {UINT64_C(0xa59bc234db398c25),   508,  172},
+  {UINT64_C(0xf6c69a72a3989f5c),   534,  180},
+  {UINT64_C(0xb7dcbf5354e9bece),   561,  188},
+  {UINT64_C(0x88fcf317f22241e2),   588,  196},
+  {UINT64_C(0xcc20ce9bd35c78a5),   614,  204},
+  {UINT64_C(0x98165af37b2153df),   641,  212},
+  {UINT64_C(0xe2a0b5dc971f303a),   667,  220},
+  {UINT64_C(0xa8d9d1535ce3b396),   694,  228},
+  {UINT64_C(0xfb9b7cd9a4a7443c),   720,  236},
+  {UINT64_C(0xbb764c4ca7a44410),   747,  244},
+  {UINT64_C(0x8bab8eefb6409c1a),   774,  252},
+  {UINT64_C(0xd01fef10a657842c),   800,  260},
+  {UINT64_C(0x9b10a4e5e9913129),   827,  268},
+  {UINT64_C(0xe7109bfba19c0c9d),   853,  276},
+  {UINT64_C(0xac2820d9623bf429),   880,  284},
+  {UINT64_C(0x80444b5e7aa7cf85),   907,  292},
+  {UINT64_C(0xbf21e44003acdd2d),   933,  300},
+  {UINT64_C(0x8e679c2f5e44ff8f),   960,  308},
+  {UINT64_C(0xd433179d9c8cb841),   986,  316},
+  {UINT64_C(0x9e19db92b4e31ba9),  1013,  324},
+  {UINT64_C(0xeb96bf6ebadf77d9),  1039,  332},
+  {UINT64_C(0xaf87023b9bf0ee6b),  1066,  340}
+};
+
 
 
 
@@ -173,6 +305,18 @@ static void Out_Char(int c);
 
 static void Out_String(char *str);
 
+static void Out_Chars(char *str, int n);
+
+static void Out_Write(char *str, int n);
+
+static void Out_Flush(void);
+
+static char *Long_To_Str(PlLong x, char *end);
+
+static Bool Grisu3(double d, char *digits, int *len, int *dec_exp);
+
+static void Float_Shortest_Slow(double d, char *digits, int *len, int *dec_exp);
+
 static void Show_Term(int depth, int prec, int context, WamWord term_word);
 
 static void Show_Global_Var(WamWord *adr);
@@ -224,6 +368,7 @@ Pl_Write_Term(StmInf *pstm, int depth, int prec, int mask, WamWord *above_H,
 	      WamWord term_word)
 {
   pstm_o = pstm;
+  write_ptr = write_buff;	/* discard output of an aborted write */
 
   quoted = mask & WRITE_QUOTED;
   ignore_op = mask & WRITE_IGNORE_OP;
@@ -239,6 +384,8 @@ Pl_Write_Term(StmInf *pstm, int depth, int prec, int mask, WamWord *above_H,
   pl_last_writing = W_NOTHING;
 
   Show_Term(depth, prec, (prec >= 1200) ? GENERAL_TERM : INSIDE_ANY_OP, term_word);
+
+  Out_Flush();
 }
 
 
@@ -260,6 +407,70 @@ Pl_Write(WamWord term_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * The output is assembled in write_buff and emitted in bulk on pstm_o by  *
+ * Out_Flush() (at the end of the write and before calling portray).       *
+ * Need_Space() is only called if the previous token requires a check.     *
+ *-------------------------------------------------------------------------*/
+
+#define Out_Put(c)						\
+  do								\
+    {								\
+      if (write_ptr >= write_buff + WRITE_BUFF_SIZE)		\
+	Out_Flush();						\
+      *write_ptr++ = (c);					\
+    }								\
+  while (0)
+
+
+#define NEED_SPACE(c)						\
+  if (pl_last_writing != W_NOTHING || last_prefix_op != W_NO_PREFIX_OP) \
+    Need_Space(c)
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * OUT_FLUSH                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Out_Flush(void)
+{
+  if (write_ptr > write_buff)
+    Pl_Stream_Write(write_buff, write_ptr - write_buff, pstm_o);
+
+  write_ptr = write_buff;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * OUT_WRITE                                                               *
+ *                                                                         *
+ * Emit n chars of str (without any space check).                          *
+ *-------------------------------------------------------------------------*/
+static void
+Out_Write(char *str, int n)
+{
+  if (write_ptr + n > write_buff + WRITE_BUFF_SIZE)
+    {
+      Out_Flush();
+      if (n > WRITE_BUFF_SIZE)
+	{
+	  Pl_Stream_Write(str, n, pstm_o);
+	  return;
+	}
+    }
+
+  memcpy(write_ptr, str, n);
+  write_ptr += n;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * OUT_SPACE                                                               *
  *                                                                         *
@@ -269,7 +480,7 @@ Out_Space(void)
 {
   if (!last_is_space)		/* avoid 2 consecutive space separators */
     {
-      Pl_Stream_Putc(' ', pstm_o);
+      Out_Put(' ');
       last_is_space = TRUE;
     }
   pl_last_writing = W_NOTHING;
@@ -285,8 +496,8 @@ Out_Space(void)
 static void
 Out_Char(int c)
 {
-  Need_Space(c);
-  Pl_Stream_Putc(c, pstm_o);
+  NEED_SPACE(c);
+  Out_Put(c);
 #if 0		     /* actually, we do not use Out_Char to display spaces */
   last_is_space = (c == ' ');  /* use isspace ? */
 #else
@@ -304,8 +515,22 @@ Out_Char(int c)
 static void
 Out_String(char *str)
 {
-  Need_Space(*str);
-  Pl_Stream_Puts(str, pstm_o);
+  Out_Chars(str, strlen(str));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * OUT_CHARS                                                               *
+ *                                                                         *
+ * str[n] must be '\0' (only used to check if a space is needed if n = 0). *
+ *-------------------------------------------------------------------------*/
+static void
+Out_Chars(char *str, int n)
+{
+  NEED_SPACE(*str);
+  Out_Write(str, n);
 
  /* Do not take into account space in strings , e.g.
   * write_term('ab ' + c,[space_args(true)]).
@@ -392,11 +617,13 @@ void
 Pl_Write_A_Full_Stop(StmInf *pstm)
 {
   pstm_o = pstm;
+  write_ptr = write_buff;
   if (pl_last_writing == W_NUMBER_0 || pl_last_writing == W_NUMBER)
     pl_last_writing = W_NOTHING;
 
   Out_Char('.');
   Out_Char('\n');
+  Out_Flush();
 }
 
 
@@ -410,7 +637,9 @@ void
 Pl_Write_A_Char(StmInf *pstm, int c)
 {
   pstm_o = pstm;
+  write_ptr = write_buff;
   Out_Char(c);
+  Out_Flush();
 }
 
 
@@ -419,48 +648,98 @@ Pl_Write_A_Char(StmInf *pstm, int c)
 /*-------------------------------------------------------------------------*
  * PL_FLOAT_TO_STRING                                                      *
  *                                                                         *
+ * Use the shortest digit string which reads back as d, laid out like      *
+ * "%#.17g" (i.e. exponent notation iff exp < -4 or exp >= 17) but with    *
+ * at least one digit after the dot.                                       *
  *-------------------------------------------------------------------------*/
 char *
 Pl_Float_To_String(double d)
 {
-  char *p, *q, *e;
   static char buff[32];
+  char digits[32];
+  union
+  {
+    double d;
+    uint64_t u;
+  } dp;
+  int len, dec_exp, exp;
+  int i;
+  char *p = buff;
+
+  dp.d = d;
+  if (((dp.u >> 52) & 0x7FF) == 0x7FF) /* NaN or +/-inf */
+    {
+      sprintf(buff, "%g", d);
+      return buff;
+    }
 
-  sprintf(buff, "%#.17g", d);	/* a . with 16 significant digits */
-
-  p = buff;			/* skip leading blanks */
-  while (*p == ' ')
-    p++;
+  if (dp.u >> 63)
+    {
+      *p++ = '-';
+      d = -d;
+    }
 
-  if (p != buff)		/* remove leading blanks */
+  if (d == 0.0)
     {
-      q = buff;
-      while ((*q++ = *p++))
-	;
+      strcpy(p, "0.0");
+      return buff;
     }
 
-  p = strchr(buff, '.');
-  if (p == NULL)		/* if p==NULL then NaN or +/-inf (ignore) */
-    return buff;
+  if (!Grisu3(d, digits, &len, &dec_exp))
+    Float_Shortest_Slow(d, digits, &len, &dec_exp);
 
-  if (p[1] == '\0')		/* a dot but no decimal numbers */
+  while (len > 1 && digits[len - 1] == '0')
     {
-      strcat(buff, "0");
-      return buff;
+      len--;
+      dec_exp++;
     }
 
-  e = strchr(buff, 'e');	/* search exposant part */
-  if (e == NULL)
-    e = buff + strlen(buff);
-  p = e - 1;
-  while (*p == '0')
-    p--;
+  exp = len + dec_exp - 1;	/* exponent of the first digit */
 
-  q = (*p == '.') ? p + 2 : p + 1;	/* but keep at least one 0 */
+  if (exp < -4 || exp >= DP_MAX_DIGITS)
+    {
+      *p++ = digits[0];
+      *p++ = '.';
+      if (len == 1)
+	*p++ = '0';
+      else
+	{
+	  memcpy(p, digits + 1, len - 1);
+	  p += len - 1;
+	}
+      *p++ = 'e';
+      *p++ = (exp < 0) ? '-' : '+';
+      if (exp < 0)
+	exp = -exp;
+      if (exp >= 100)
+	*p++ = '0' + exp / 100;
+      *p++ = '0' + exp / 10 % 10;
+      *p++ = '0' + exp % 10;
+    }
+  else if (exp < 0)
+    {
+      *p++ = '0';
+      *p++ = '.';
+      for (i = -1; i > exp; i--)
+	*p++ = '0';
+      memcpy(p, digits, len);
+      p += len;
+    }
+  else
+    {
+      for (i = 0; i <= exp; i++)
+	*p++ = (i < len) ? digits[i] : '0';
+      *p++ = '.';
+      if (len <= exp + 1)
+	*p++ = '0';
+      else
+	{
+	  memcpy(p, digits + exp + 1, len - exp - 1);
+	  p += len - exp - 1;
+	}
+    }
 
-  if (q != e)
-    while ((*q++ = *e++))	/* move exposant part */
-      ;
+  *p = '\0';
 
   return buff;
 }
@@ -468,6 +747,253 @@ Pl_Float_To_String(double d)
 
 
 
+/*-------------------------------------------------------------------------*
+ * The following functions compute the shortest digits of a double > 0     *
+ * using the Grisu3 algorithm (F. Loitsch, "Printing Floating-Point Numbers*
+ * Quickly and Accurately with Integers", PLDI 2010). Grisu3 only uses     *
+ * 64-bit integers and detects the (rare, < 0.5%) cases it cannot decide:  *
+ * these are handled by Float_Shortest_Slow() with sprintf/strtod.         *
+ * The result is d = digits[0..len-1] * 10^dec_exp (digits is not ended by *
+ * '\0').                                                                  *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * DIY_FP_MUL                                                              *
+ *                                                                         *
+ * Return the (rounded) 64 most significant bits of x * y.                 *
+ *-------------------------------------------------------------------------*/
+static DiyFp
+Diy_Fp_Mul(DiyFp x, DiyFp y)
+{
+  uint64_t m32 = 0xFFFFFFFF;
+  uint64_t a = x.f >> 32, b = x.f & m32;
+  uint64_t c = y.f >> 32, d = y.f & m32;
+  uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+  DiyFp r;
+
+  tmp += (uint64_t) 1 << 31;	/* round */
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e = x.e + y.e + 64;
+
+  return r;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DIY_FP_NORMALIZE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static DiyFp
+Diy_Fp_Normalize(DiyFp x)
+{
+  while ((x.f & ((uint64_t) 1 << 63)) == 0)
+    {
+      x.f <<= 1;
+      x.e--;
+    }
+
+  return x;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ROUND_WEED                                                              *
+ *                                                                         *
+ * Move the last digit towards w (the exact value) while it remains in the *
+ * unsafe interval. Return FALSE if the result cannot be proved correct.   *
+ *-------------------------------------------------------------------------*/
+static Bool
+Round_Weed(char *digits, int len, uint64_t dist_too_high_w,
+	   uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa,
+	   uint64_t unit)
+{
+  uint64_t small_dist = dist_too_high_w - unit;
+  uint64_t big_dist = dist_too_high_w + unit;
+
+  while (rest < small_dist && unsafe_interval - rest >= ten_kappa &&
+	 (rest + ten_kappa < small_dist ||
+	  small_dist - rest >= rest + ten_kappa - small_dist))
+    {
+      digits[len - 1]--;
+      rest += ten_kappa;
+    }
+
+  if (rest < big_dist && unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_dist ||
+       big_dist - rest > rest + ten_kappa - big_dist))
+    return FALSE;
+
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DIGIT_GEN                                                               *
+ *                                                                         *
+ * Generate the shortest digits of w (scaled) inside ]low, high[.          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Digit_Gen(DiyFp low, DiyFp w, DiyFp high, char *digits, int *len, int *kappa)
+{
+  static const uint32_t pow10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000
+  };
+  uint64_t unit = 1;
+  uint64_t too_low = low.f - unit;
+  uint64_t too_high = high.f + unit;
+  uint64_t unsafe_interval = too_high - too_low;
+  int shift = -w.e;
+  uint64_t one = (uint64_t) 1 << shift;
+  uint32_t integrals = (uint32_t) (too_high >> shift);
+  uint64_t fractionals = too_high & (one - 1);
+  uint32_t divisor;
+  uint64_t rest;
+  int k;
+
+  k = 10;			/* biggest power of 10 <= integrals */
+  while (k > 0 && integrals < pow10[k - 1])
+    k--;
+  divisor = (k > 0) ? pow10[k - 1] : 0;
+
+  *kappa = k;
+  *len = 0;
+
+  while (*kappa > 0)
+    {
+      digits[(*len)++] = '0' + integrals / divisor;
+      integrals %= divisor;
+      (*kappa)--;
+      rest = ((uint64_t) integrals << shift) + fractionals;
+      if (rest < unsafe_interval)
+	return Round_Weed(digits, *len, too_high - w.f, unsafe_interval,
+			  rest, (uint64_t) divisor << shift, unit);
+      divisor /= 10;
+    }
+
+  for (;;)
+    {
+      fractionals *= 10;
+      unit *= 10;
+      unsafe_interval *= 10;
+      digits[(*len)++] = '0' + (int) (fractionals >> shift);
+      fractionals &= one - 1;
+      (*kappa)--;
+      if (fractionals < unsafe_interval)
+	return Round_Weed(digits, *len, (too_high - w.f) * unit,
+			  unsafe_interval, fractionals, one, unit);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GRISU3                                                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Grisu3(double d, char *digits, int *len, int *dec_exp)
+{
+  union
+  {
+    double d;
+    uint64_t u;
+  } dp;
+  DiyFp v, w, m_plus, m_minus, c;
+  int bexp, k, i, kappa;
+
+  dp.d = d;
+  v.f = dp.u & DP_SIGNIFICAND_MASK;
+  bexp = (int) ((dp.u >> 52) & 0x7FF);
+  if (bexp)
+    {
+      v.f += DP_HIDDEN_BIT;
+      v.e = bexp - DP_EXPONENT_BIAS;
+    }
+  else				/* denormal */
+    v.e = 1 - DP_EXPONENT_BIAS;
+
+  w = Diy_Fp_Normalize(v);
+
+				/* boundaries m- and m+ (same exponent) */
+  m_plus.f = (v.f << 1) + 1;
+  m_plus.e = v.e - 1;
+  m_plus = Diy_Fp_Normalize(m_plus);
+
+  if (v.f == DP_HIDDEN_BIT && bexp > 1)	/* lower boundary is closer */
+    {
+      m_minus.f = (v.f << 2) - 1;
+      m_minus.e = v.e - 2;
+    }
+  else
+    {
+      m_minus.f = (v.f << 1) - 1;
+      m_minus.e = v.e - 1;
+    }
+  m_minus.f <<= m_minus.e - m_plus.e;
+  m_minus.e = m_plus.e;
+
+				/* c = 10^-k such that w * c exponent is in [-60, -32] */
+  k = (int) ceil((GRISU_MIN_TARGET_EXP - (w.e + 64) + 64 - 1) *
+		 GRISU_D_1_LOG2_10);
+  i = (GRISU_CACHED_POW_OFFSET + k - 1) / GRISU_CACHED_POW_STEP + 1;
+  c.f = grisu_cached_pow[i].f;
+  c.e = grisu_cached_pow[i].e;
+
+  if (!Digit_Gen(Diy_Fp_Mul(m_minus, c), Diy_Fp_Mul(w, c),
+		 Diy_Fp_Mul(m_plus, c), digits, len, &kappa))
+    return FALSE;
+
+  *dec_exp = kappa - grisu_cached_pow[i].k;
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FLOAT_SHORTEST_SLOW                                                     *
+ *                                                                         *
+ * Try successive precisions until the output reads back as d.             *
+ *-------------------------------------------------------------------------*/
+static void
+Float_Shortest_Slow(double d, char *digits, int *len, int *dec_exp)
+{
+  char buff[32];
+  char *p;
+  int prec;
+
+  for (prec = 1; prec < DP_MAX_DIGITS; prec++)
+    {
+      sprintf(buff, "%.*e", prec - 1, d);
+      if (strtod(buff, NULL) == d)
+	break;
+    }
+
+  if (prec == DP_MAX_DIGITS)	/* 17 digits always suffice */
+    sprintf(buff, "%.*e", prec - 1, d);
+
+  *len = 0;
+  for (p = buff; *p != 'e'; p++)
+    if (isdigit(*p))
+      digits[(*len)++] = *p;
+
+  *dec_exp = atoi(p + 1) - (*len - 1);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * SHOW_TERM                                                               *
  *                                                                         *
@@ -477,6 +1003,7 @@ Show_Term(int depth, int prec, int context, WamWord term_word)
 {
   WamWord word, tag_mask;
   WamWord *adr;
+  PlLong n;
 
   if (depth == 0)
     {
@@ -485,7 +1012,7 @@ Show_Term(int depth, int prec, int context, WamWord term_word)
     }
 
   DEREF(term_word, word, tag_mask);
-  if (tag_mask != TAG_REF_MASK && Try_Portray(word))
+  if (portrayed && tag_mask != TAG_REF_MASK && Try_Portray(word))
     return;
 
   switch (Tag_From_Tag_Mask(tag_mask))
@@ -521,12 +1048,23 @@ Show_Term(int depth, int prec, int context, WamWord term_word)
     case LST:
       adr = UnTag_LST(word);
       if (ignore_op)
-	{
-	  Out_String("'.'(");
-	  Show_Term(depth - 1, MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, Car(adr));
-	  Out_Char(',');
-	  Show_Term(depth - 1, MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, Cdr(adr));
-	  Out_Char(')');
+	{			/* iterate on the tail (no C recursion) */
+	  n = 0;
+	  for (;;)
+	    {
+	      Out_String("'.'(");
+	      Show_Term(depth - 1, MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, Car(adr));
+	      Out_Char(',');
+	      n++;
+	      depth--;
+	      DEREF(Cdr(adr), word, tag_mask);
+	      if (tag_mask != TAG_LST_MASK || depth == 0 || portrayed)
+		break;
+	      adr = UnTag_LST(word);
+	    }
+	  Show_Term(depth, MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM, word);
+	  while (n--)
+	    Out_Char(')');
 	}
       else
 	{
@@ -554,9 +1092,10 @@ static void
 Show_Global_Var(WamWord *adr)
 {
   char str[32];
+  char *p = Long_To_Str((int) Global_Offset(adr), str + sizeof(str));
 
-  sprintf(str, "_%d", (int) Global_Offset(adr));
-  Out_String(str);
+  *--p = '_';
+  Out_Chars(p, str + sizeof(str) - 1 - p);
 
   pl_last_writing = W_IDENTIFIER;
 }
@@ -596,7 +1135,7 @@ Show_Fd_Variable(WamWord *fdv_adr)
 static void
 Show_Atom(int context, int atom)
 {
-  char *p, *q;
+  char *p, *q, *r;
   char str[32];
   Bool bracket = FALSE;
   int c, c_type;
@@ -614,7 +1153,7 @@ Show_Atom(int context, int atom)
 
   if (!quoted || !prop.needs_quote)
     {
-      Out_String(pl_atom_tbl[atom].name);
+      Out_Chars(pl_atom_tbl[atom].name, prop.length);
 
       switch (prop.type)
 	{
@@ -653,28 +1192,36 @@ Show_Atom(int context, int atom)
       Out_Char('\'');
 
       if (prop.needs_scan)
-	{
-	  for (p = pl_atom_tbl[atom].name; *p; p++)
-	    if ((q = (char *) strchr(pl_escape_char, *p)))
-	      {
-		Out_Char('\\');
-		Out_Char(pl_escape_symbol[q - pl_escape_char]);
-	      }
-	    else if (*p == '\'' || *p == '\\')	/* display twice */
-	      {
-		Out_Char(*p);
-		Out_Char(*p);
-	      }
-	    else if (!isprint(*p))
-	      {
-		sprintf(str, "\\x%x\\", (unsigned) (unsigned char) *p);
-		Out_String(str);
-	      }
-	    else
-	      Out_Char(*p);
+	{			/* emit runs of plain chars in bulk */
+	  for (p = r = pl_atom_tbl[atom].name; *p; p++)
+	    {
+	      if ((q = (char *) strchr(pl_escape_char, *p)) == NULL &&
+		  *p != '\'' && *p != '\\' && isprint(*p))
+		continue;
+
+	      Out_Write(r, p - r);
+	      r = p + 1;
+
+	      if (q)
+		{
+		  Out_Put('\\');
+		  Out_Put(pl_escape_symbol[q - pl_escape_char]);
+		}
+	      else if (*p == '\'' || *p == '\\')	/* display twice */
+		{
+		  Out_Put(*p);
+		  Out_Put(*p);
+		}
+	      else
+		{
+		  sprintf(str, "\\x%x\\", (unsigned) (unsigned char) *p);
+		  Out_Write(str, strlen(str));
+		}
+	    }
+	  Out_Write(r, p - r);
 	}
       else
-	Out_String(pl_atom_tbl[atom].name);
+	Out_Write(pl_atom_tbl[atom].name, prop.length);
 
       Out_Char('\'');
 
@@ -696,8 +1243,34 @@ static void
 Show_Integer(PlLong x)
 {
   char str[32];
-  sprintf(str, "%" PL_FMT_d, x);
-  Show_Number_Str(str);
+
+  Show_Number_Str(Long_To_Str(x, str + sizeof(str)));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LONG_TO_STR                                                             *
+ *                                                                         *
+ * Store the decimal representation of x (+ '\0') just before end and     *
+ * return its beginning (avoids sprintf).                                  *
+ *-------------------------------------------------------------------------*/
+static char *
+Long_To_Str(PlLong x, char *end)
+{
+  char *p = end;
+  PlULong u = (x < 0) ? -(PlULong) x : (PlULong) x;
+
+  *--p = '\0';
+  do
+    *--p = '0' + u % 10;
+  while ((u /= 10) != 0);
+
+  if (x < 0)
+    *--p = '-';
+
+  return p;
 }
 
 
@@ -789,7 +1362,7 @@ Show_List_Arg(int depth, WamWord *lst_adr)
       if (word != NIL_WORD)
 	{
 	  SHOW_LIST_PIPE;
-	  if (Try_Portray(word))
+	  if (portrayed && Try_Portray(word))
 	    return;
 
 	  Show_Atom(GENERAL_TERM, UnTag_ATM(word));
@@ -799,7 +1372,7 @@ Show_List_Arg(int depth, WamWord *lst_adr)
 #ifndef NO_USE_FD_SOLVER
     case FDV:
       SHOW_LIST_PIPE;
-      if (Try_Portray(word))
+      if (portrayed && Try_Portray(word))
 	return;
 
       Show_Fd_Variable(UnTag_FDV(word));
@@ -808,7 +1381,7 @@ Show_List_Arg(int depth, WamWord *lst_adr)
 
     case INT:
       SHOW_LIST_PIPE;
-      if (Try_Portray(word))
+      if (portrayed && Try_Portray(word))
 	return;
 
       Show_Integer(UnTag_INT(word));
@@ -816,7 +1389,7 @@ Show_List_Arg(int depth, WamWord *lst_adr)
 
     case FLT:
       SHOW_LIST_PIPE;
-      if (Try_Portray(word))
+      if (portrayed && Try_Portray(word))
 	return;
 
       Show_Float(Pl_Obtain_Float(UnTag_FLT(word)));
@@ -832,7 +1405,7 @@ Show_List_Arg(int depth, WamWord *lst_adr)
 
     case STC:
       SHOW_LIST_PIPE;
-      if (Try_Portray(word))
+      if (portrayed && Try_Portray(word))
 	return;
 
       Show_Structure(depth, MAX_ARG_OF_FUNCTOR_PREC, GENERAL_TERM,
@@ -942,10 +1515,7 @@ Show_Structure(int depth, int prec, int context, WamWord *stc_adr)
 	  Out_Char('A' + i);
 
 	  if (j)
-	    {
-	      sprintf(str, "%d", j);
-	      Out_String(str);
-	    }
+	    Out_String(Long_To_Str(j, str + sizeof(str)));
 
 	  pl_last_writing = W_IDENTIFIER;
 	  return;
@@ -1201,6 +1771,8 @@ Try_Portray(WamWord word)
       try_portray_code = (CodePtr) (pred->codep);
     }
 
+  Out_Flush();			/* portray/1 writes directly on the stream */
+
   print_pstm_o = pstm_o;
   print_quoted = quoted;
   print_ignore_op = ignore_op;
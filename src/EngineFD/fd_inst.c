@@ -75,6 +75,14 @@ static WamWord *TP;
 
 static WamWord dummy_fd_var[FD_VARIABLE_FRAME_SIZE];
 
+static WamWord **cf_queue[NB_PRIORITIES]; /* circular buffers (deferred cstr) */
+static unsigned cf_queue_size[NB_PRIORITIES];
+static unsigned cf_queue_in[NB_PRIORITIES];
+static unsigned cf_queue_out[NB_PRIORITIES];
+static int cf_queue_mask;	/* bit p set <=> cf_queue[p] is not empty */
+
+static WamWord *last_cf_tell_fdv; /* tell variable of the last created CF */
+
 static PlULong DATE;   /* NB: PlLong/PlULong have the same size as a WamWord (intptr_t) */
 
 /*
@@ -163,6 +171,34 @@ static PlULong DATE;   /* NB: PlLong/PlULong have the same size as a WamWord (in
  * NB: if a constraint reexecution fails (in the above loop), X has the 
  * MASK_TO_KEEP_IN_QUEUE set. This is not a problem since at the next
  * constraint post the queue is cleared assigning 0 to each Queue_Propag_Mask.
+ *
+ * Constraints are not all reexecuted as soon as they are found in a chain.
+ * Each constraint has a priority (see Pl_Fd_Add_Dependency) depending on the
+ * chains it is woken on (which reflects its cost): val, bounds (min, max,
+ * min_max), dom and global (depends on a list of variables). Cheap ones (val
+ * and bounds) are reexecuted at once in the above loop. Others are deferred:
+ * they are added to a constraint queue (one FIFO per priority) and are only
+ * reexecuted when the variable queue is empty (i.e. when cheap constraints
+ * have reached their fix-point). Then the first constraint of the lowest
+ * non-empty priority is reexecuted, the variable queue is handled again,...
+ *
+ * A deferred constraint is in the constraint queue iff CF_Stamp(C) is the
+ * current DATE (shifted): it is added only once even if it is woken by
+ * several variables or chains. Using DATE (and not a flag) ensures that a
+ * constraint left in the queue by an exception raised during propagation is
+ * not considered as queued at the next post.
+ *
+ * An idempotent constraint (CF_IDEMPOTENT) reaches its own fix-point when it
+ * is executed. A deferred idempotent constraint is thus not woken by its own
+ * changes: after its reexecution, all variables of the variable queue are
+ * marked with MASK_OWN_CHANGES (the mark is removed by All_Propagations if
+ * another constraint modifies the variable). X in r is idempotent unless r
+ * depends on X. A constraint defined by a C function (no tell variable) is
+ * idempotent only if declared so (keyword idempotent in the FD language).
+ *
+ * Each constraint frame also counts the failures it has caused (Cstr_Weight,
+ * initialized to 1). This counter is not trailed: it survives backtracking
+ * and is used by the dom/wdeg labeling heuristic (Pl_Fd_Weighted_Degree).
  */
 
 #define DATE_NEVER   0
@@ -186,6 +222,8 @@ void (*pl_fd_reset_solver) () = Pl_Fd_Reset_Solver0;	/* overwrite var of if_no_f
 
 static void All_Propagations(WamWord *fdv_adr, int propag);
 
+static void Grow_Cstr_Queue(int prio);
+
 static void Clear_Queue(void);
 
 
@@ -195,23 +233,6 @@ static void Clear_Queue(void);
  * Auxiliary engine macros         *
  *---------------------------------*/
 
-#define FD_Word_Needs_Trailing(adr)  ((adr) <  CSB(B))
-
-
-
-
-#define FD_Bind_OV(adr, word)       		\
-  do						\
-    {						\
-      if (FD_Word_Needs_Trailing(adr))		\
-	Trail_OV(adr);				\
-      *(adr) = (word);				\
-    }						\
-  while (0)
-
-
-
-
 #define Trail_Fd_Int_Variable_If_Necessary(fdv_adr)		\
   do								\
     {								\
@@ -349,7 +370,7 @@ static void Clear_Queue(void);
       if (Nb_Elem(fdv_adr) != nb_elem)					   \
 	Set_Dom_Mask(propag);						   \
 									   \
-      if (propag || (Is_Interval(r) && Is_Sparse(range)))		   \
+      if (propag || (Is_Interval(r) && !Is_Interval(range)))		   \
 	{								   \
 	  Trail_Range_If_Necessary(fdv_adr);				   \
 	  Nb_Elem(fdv_adr) = nb_elem;					   \
@@ -429,9 +450,15 @@ Pl_Fd_Init_Solver0(void)
 void
 Pl_Fd_Reset_Solver0(void)
 {
+  int prio;
+
   STAMP = 0;
   DATE = 1;
   TP = dummy_fd_var;		/* the queue is empty */
+  for (prio = 0; prio < NB_PRIORITIES; prio++)
+    cf_queue_out[prio] = cf_queue_in[prio];
+  cf_queue_mask = 0;
+  pl_fd_bound_adr = NULL;
 }
 
 
@@ -554,9 +581,9 @@ Pl_Fd_List_Int_To_Range(Range *range, WamWord list_word)
       
       val = Pl_Fd_Prolog_To_Value(Car(lst_adr));
 
-      if ((unsigned) val > (unsigned) pl_vec_max_integer)
+      if (val < 0)
 	range->extra_cstr = TRUE;
-      else
+      else if (val <= pl_vec_max_integer)
 	{
 	  Vector_Set_Value(range->vec, val);
 	  n++;
@@ -569,6 +596,21 @@ Pl_Fd_List_Int_To_Range(Range *range, WamWord list_word)
     Set_To_Empty(range);
   else
     Pl_Range_From_Vector(range);
+
+  list_word = save_list_word;	/* values > vec max are added to the range */
+  for (;;)			/* (using an interval list if needed) */
+    {
+      DEREF(list_word, word, tag_mask);
+      if (word == NIL_WORD)
+	break;
+
+      lst_adr = UnTag_LST(word);
+      val = Pl_Fd_Prolog_To_Value(Car(lst_adr));
+      if (val > pl_vec_max_integer)
+	Pl_Range_Set_Value(range, val);
+
+      list_word = Cdr(lst_adr);
+    }
 }
 
 
@@ -774,6 +816,10 @@ Pl_Fd_Create_C_Frame(PlLong (*cstr_fct) (), WamWord *AF, WamWord *fdv_adr,
   AF_Pointer(CF) = AF;
   Optim_Pointer(CF) = (optim2 && fdv_adr) ? &FD_INT_Date(fdv_adr) : &optim2_date_always;
   Cstr_Address(CF) = cstr_fct;
+  Queue_Info(CF) = (fdv_adr) ? CF_IDEMPOTENT : 0; /* see Pl_Fd_Add_Dependency */
+  Cstr_Weight(CF) = 1;
+
+  last_cf_tell_fdv = fdv_adr;
 
   /* if ground Nb_Cstr not allocated (Fd_Int_Frame) */
   if (fdv_adr && !Fd_Variable_Is_Ground(fdv_adr))
@@ -794,11 +840,21 @@ Pl_Fd_Create_C_Frame(PlLong (*cstr_fct) (), WamWord *AF, WamWord *fdv_adr,
 void
 Pl_Fd_Add_Dependency(WamWord *fdv_adr, int chain_nb, WamWord *CF)
 {
+  static int chain_priority[] = { PRIORITY_BOUNDS, PRIORITY_BOUNDS,
+				  PRIORITY_BOUNDS, PRIORITY_DOM, PRIORITY_VAL };
   WamWord **chain_adr;
+  int prio;
 
   if (Fd_Variable_Is_Ground(fdv_adr))
     return;
 
+  prio = chain_priority[chain_nb];
+  if (prio > CF_Priority(CF))
+    Queue_Info(CF) = (Queue_Info(CF) & ~CF_PRIORITY_MASK) | prio;
+
+  if (fdv_adr == last_cf_tell_fdv) /* X in r where r depends on X */
+    Queue_Info(CF) &= ~CF_IDEMPOTENT;
+
   Trail_Chains_If_Necessary(fdv_adr);
 
   Chains_Mask(fdv_adr) |= (1 << chain_nb);
@@ -827,6 +883,8 @@ Pl_Fd_Add_List_Dependency(WamWord *array, int chain_nb, WamWord *CF)
 
   while (n--)
     Pl_Fd_Add_Dependency((WamWord *) (*array++), chain_nb, CF);
+
+  Queue_Info(CF) = (Queue_Info(CF) & ~CF_PRIORITY_MASK) | PRIORITY_GLOBAL;
 }
 
 
@@ -948,11 +1006,20 @@ Pl_Fd_Before_Add_Cstr(void)
 
 #endif
 
-  if (DATE == DATE_NEVER) /* reserve DATE_NEVER (i.e. 0) */
+  if (DATE == DATE_NEVER || (DATE << CF_STAMP_SHIFT) == 0) /* reserve DATE_NEVER (i.e. 0) */
     DATE++;		  /* NB: it is not a problem if DATE == DATE_ALWAYS (i.e. 1) */
 
   TP = dummy_fd_var;		/* the queue is empty */
 
+  if (cf_queue_mask)		/* only after an exception */
+    {
+      int prio;
+
+      for (prio = 0; prio < NB_PRIORITIES; prio++)
+	cf_queue_out[prio] = cf_queue_in[prio];
+      cf_queue_mask = 0;
+    }
+
 #ifdef DEBUG_CHECK_DATES_AND_QUEUE
   Check_Queue_Consistency();
 #endif
@@ -1001,6 +1068,15 @@ Clear_Queue(void)
 {
   WamWord *BP;
   WamWord *fdv_adr;
+  WamWord *CF;
+  int prio;
+
+  for (prio = 0; cf_queue_mask; prio++, cf_queue_mask >>= 1)
+    while (cf_queue_out[prio] != cf_queue_in[prio])
+      {
+	CF = cf_queue[prio][cf_queue_out[prio]++ & (cf_queue_size[prio] - 1)];
+	Queue_Info(CF) &= CF_FLAGS_MASK;
+      }
 
   if (TP == dummy_fd_var)	/* empty ? */
     return;
@@ -1082,33 +1158,11 @@ start:
   max = r->max;
 
 
-  if (Is_Interval(r) && n != min && n != max)
+  if (Is_Interval(r) && n != min && n != max && max <= pl_vec_max_integer)
     {
-      if (min > pl_vec_max_integer)
-	{
-	  Pl_Fd_Display_Extra_Cstr(fdv_adr);
-	  return FALSE;
-	}
-
-      if (min == pl_vec_max_integer)
-	{
-	  Pl_Fd_Display_Extra_Cstr(fdv_adr);
-	  Update_Range_From_Int(fdv_adr, min, propag);
-	  All_Propagations(fdv_adr, propag);
-	  return TRUE;
-	}
-
       Trail_Range_If_Necessary(fdv_adr);
       Pl_Range_Becomes_Sparse(r);
       Nb_Elem(fdv_adr) = r->max - r->min + 1;
-      if (r->extra_cstr)	/* the max has been changed */
-	{
-	  propag = MASK_EMPTY;
-	  Set_Max_Mask(propag);
-	  Set_Min_Max_Mask(propag);
-	  Set_Dom_Mask(propag);
-	  All_Propagations(fdv_adr, propag);
-	}
       goto start;
     }
 
@@ -1122,30 +1176,36 @@ start:
       goto do_propag;
     }
 
-  /* here if sparse OR n==min OR n==max */
+  /* here if sparse OR list OR n==min OR n==max OR a wide interval */
   Trail_Range_If_Necessary(fdv_adr);
 
   propag = MASK_EMPTY;
   Set_Dom_Mask(propag);
-  if (Is_Sparse(r))
-    Vector_Reset_Value(r->vec, n);
 
   Nb_Elem(fdv_adr)--;
 
+  if (Is_Interval_List(r) && !FD_Word_Needs_Trailing((WamWord *) Range_List(r)))
+    Pl_Range_List_Reset_Value(r, n); /* list newer than the last choice point */
+  else if (!Is_Sparse(r))	/* interval or list */
+    Pl_Range_Reset_Value(r, n);
+  else
+    {
+      Vector_Reset_Value(r->vec, n);
+      if (n == min)
+	r->min = Pl_Vector_Next_After(r->vec, n);
+      else if (n == max)
+	r->max = Pl_Vector_Next_Before(r->vec, n);
+    }
+
   if (n == min)
     {
       Set_Min_Mask(propag);
       Set_Min_Max_Mask(propag);
-      r->min = (Is_Interval(r)) ? n + 1 : Pl_Vector_Next_After(r->vec, n);
-      goto do_propag;
     }
-
-  if (n == max)
+  else if (n == max)
     {
       Set_Max_Mask(propag);
       Set_Min_Max_Mask(propag);
-      r->max = (Is_Interval(r)) ? n - 1 : Pl_Vector_Next_Before(r->vec, n);
-      goto do_propag;
     }
 
 do_propag:
@@ -1229,7 +1289,9 @@ Pl_Fd_Tell_Range_Range(WamWord *fdv_adr, Range *range)
   int propag;
   WamWord *save_CS = CS;
 
-  if (range->vec)
+  if (Is_Interval_List(range))		/* keep the list (source of Inter) safe */
+    CS = math_max(CS, (WamWord *) Range_List_End(range));
+  else if (range->vec)
     CS = (WamWord *) range->vec;
   CS += pl_vec_size;
 
@@ -1285,7 +1347,7 @@ Pl_Fd_Tell_Interval(WamWord *fdv_adr, int min, int max)
       return (n >= min && n <= max); /* also detects if initial range is empty */
     }
 
-  if (Is_Sparse(Range(fdv_adr)))
+  if (!Is_Interval(Range(fdv_adr)))
     {
       Range_Init_Interval(&range, min, max);
       return Pl_Fd_Tell_Range_Range(fdv_adr, &range);
@@ -1329,14 +1391,43 @@ All_Propagations(WamWord *fdv_adr, int propag)
 	  Queue_Next_Fdv_Adr(TP) = fdv_adr;
 	  TP = fdv_adr;
 	}
-      else			/* already in the queue */
-	Queue_Propag_Mask(fdv_adr) |= propag;
+      else			/* already in the queue (no longer only own changes) */
+	Queue_Propag_Mask(fdv_adr) = (Queue_Propag_Mask(fdv_adr) & ~MASK_OWN_CHANGES) | propag;
     }
 }
 
 
 
 
+/*-------------------------------------------------------------------------*
+ * GROW_CSTR_QUEUE                                                         *
+ *                                                                         *
+ * Called when the circular buffer of priority prio is full (or not yet    *
+ * allocated). Its size is doubled (it is always a power of 2).            *
+ *-------------------------------------------------------------------------*/
+static void
+Grow_Cstr_Queue(int prio)
+{
+  unsigned size = cf_queue_size[prio];
+  unsigned new_size = (size) ? 2 * size : 256;
+  WamWord **queue = (WamWord **) Malloc(new_size * sizeof(WamWord *));
+  unsigned i;
+
+  for (i = 0; i < size; i++)
+    queue[i] = cf_queue[prio][(cf_queue_out[prio] + i) & (size - 1)];
+
+  if (size)
+    Free(cf_queue[prio]);
+
+  cf_queue[prio] = queue;
+  cf_queue_size[prio] = new_size;
+  cf_queue_out[prio] = 0;
+  cf_queue_in[prio] = size;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_AFTER_ADD_CSTR                                                    *
  *                                                                         *
@@ -1346,14 +1437,25 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
 {
   WamWord *fdv_adr;
   WamWord propag;
+  WamWord own_changes;
   WamWord *record_adr;
   WamWord **chain_adr;
   WamWord *CF;
   WamWord *BP;
+  WamWord *running_cf = NULL;	/* last deferred cstr reexecuted */
   PlULong date = DATE;		/* local copy for efficiency */
+  PlULong stamp = date << CF_STAMP_SHIFT;
   PlULong *pdate;
   WamWord *AF;
   PlLong (*fct) ();
+  int prio;
+
+  /* keep the objective of a branch-and-bound inside the best bound found
+   * so far (see fd_optim_c.c): the pruning is done by the same propagation
+   */
+  if (result_of_tell && pl_fd_bound_adr != NULL &&
+      (Min(pl_fd_bound_adr) < pl_fd_bound_min || Max(pl_fd_bound_adr) > pl_fd_bound_max))
+    result_of_tell = Pl_Fd_Tell_Interval(pl_fd_bound_adr, pl_fd_bound_min, pl_fd_bound_max);
 
   if (!result_of_tell)
     {
@@ -1362,81 +1464,154 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
       return FALSE;
     }
 
-  if (TP == dummy_fd_var)
-    return TRUE;
-
-  BP = Queue_Next_Fdv_Adr(dummy_fd_var);
-
-
   for (;;)
     {
-      fdv_adr = (WamWord *) BP;
-      propag = Queue_Propag_Mask(fdv_adr);
+      if (TP == dummy_fd_var)
+	goto deferred;
 
-      /* NB: the var must stay in the queue until fix-point (no more reactivations) */
-      /* add a mask to keep it in the queue (in case it is reactivated) */
-      Queue_Propag_Mask(fdv_adr) = MASK_TO_KEEP_IN_QUEUE;
+      BP = Queue_Next_Fdv_Adr(dummy_fd_var);
 
-      chain_adr = &Chain_Min(fdv_adr);
+      for (;;)
+	{
+	  fdv_adr = (WamWord *) BP;
+	  propag = Queue_Propag_Mask(fdv_adr);
+	  own_changes = propag & MASK_OWN_CHANGES;
+	  propag &= MASK_TO_KEEP_IN_QUEUE - 1;
+
+	  /* NB: the var must stay in the queue until fix-point (no more reactivations) */
+	  /* add a mask to keep it in the queue (in case it is reactivated) */
+	  Queue_Propag_Mask(fdv_adr) = MASK_TO_KEEP_IN_QUEUE;
 
+	  chain_adr = &Chain_Min(fdv_adr);
 
-      for (; propag; propag >>= 1, chain_adr++)
-	if (propag & 1)
-	  {
-	    record_adr = (*chain_adr);
-	    do
+
+	  for (; propag; propag >>= 1, chain_adr++)
+	    if (propag & 1)
 	      {
-		CF = CF_Pointer(record_adr);
+		record_adr = (*chain_adr);
+		do
+		  {
+		    CF = CF_Pointer(record_adr);
 
 #if 1
-		/* optim #2 (and for 'stop constraint' management) */
-		pdate = Optim_Pointer(CF);
-		if (*pdate != DATE_ALWAYS && *pdate != date)
-		  continue;
+		    /* optim #2 (and for 'stop constraint' management) */
+		    pdate = Optim_Pointer(CF);
+		    if (*pdate != DATE_ALWAYS && *pdate != date)
+		      continue;
 #endif
 
-		fct = Cstr_Address(CF);
-		AF = AF_Pointer(CF);
-
-		fct = (PlLong (*)()) (*fct) (AF);
-
-		if (fct == (PlLong (*)()) FALSE)
-		  {
-		  failure:
-		    Queue_Next_Fdv_Adr(dummy_fd_var) = BP; /* update begin of remaining queue */
-		    goto clear_queue;
-		  }
+		    if (CF_Is_Deferred(CF))
+		      {
+			if (CF_Stamp(CF) == stamp ||		/* already in the queue */
+			    (CF == running_cf && own_changes))	/* idempotent */
+			  continue;
+
+			Queue_Info(CF) = (Queue_Info(CF) & CF_FLAGS_MASK) | stamp;
+			prio = CF_Priority(CF);
+			if (cf_queue_in[prio] - cf_queue_out[prio] == cf_queue_size[prio])
+			  Grow_Cstr_Queue(prio);
+
+			cf_queue[prio][cf_queue_in[prio]++ & (cf_queue_size[prio] - 1)] = CF;
+			cf_queue_mask |= (1 << prio);
+			continue;
+		      }
+
+		    fct = Cstr_Address(CF);
+		    AF = AF_Pointer(CF);
+
+		    fct = (PlLong (*)()) (*fct) (AF);
+
+		    if (fct == (PlLong (*)()) FALSE)
+		      {
+		      failure:
+			Cstr_Weight(CF)++;
+			Queue_Next_Fdv_Adr(dummy_fd_var) = BP; /* update begin of remaining queue */
+			goto clear_queue;
+		      }
 #if 1				/* FD switch */
-		if (fct != (PlLong (*)()) TRUE)	/* FD switch case triggered */
-		  {
-		    if ((*fct) (AF) == FALSE)
-		      goto failure;
+		    if (fct != (PlLong (*)()) TRUE)	/* FD switch case triggered */
+		      {
+			if ((*fct) (AF) == FALSE)
+			  goto failure;
 
-		    Pl_Fd_Stop_Constraint(CF);
-		  }
+			Pl_Fd_Stop_Constraint(CF);
+		      }
 #endif
+		  }
+		while ((record_adr = Next_Chain(record_adr)) != NULL);
 	      }
-	    while ((record_adr = Next_Chain(record_adr)) != NULL);
-	  }
 
 
-      /* undo the mask */
-      Queue_Propag_Mask(fdv_adr) &= (MASK_TO_KEEP_IN_QUEUE - 1);
+	  /* undo the mask */
+	  Queue_Propag_Mask(fdv_adr) &= (MASK_TO_KEEP_IN_QUEUE - 1);
+
+	  /* reactivated ? */
+	  if (Queue_Propag_Mask(fdv_adr) == 0) /* no longer in queue ? */
+	    {
+	      /*  Del_Var_From_Queue(fdv_adr); since Queue_Propag_Mask(fdv_adr) == 0 */
+
+	      if (BP == TP)
+		break;
+
+	      BP = Queue_Next_Fdv_Adr(BP);
+	    }
+	}
+
+      TP = dummy_fd_var;		/* queue is now empty */
+
+    deferred:
+      if (cf_queue_mask == 0)
+	break;
+
+      for (prio = 0; (cf_queue_mask & (1 << prio)) == 0; prio++)
+	;
+
+      CF = cf_queue[prio][cf_queue_out[prio]++ & (cf_queue_size[prio] - 1)];
+      if (cf_queue_out[prio] == cf_queue_in[prio])
+	cf_queue_mask &= ~(1 << prio);
+
+      Queue_Info(CF) &= CF_FLAGS_MASK;
+
+      /* the constraint can have been stopped since it has been queued */
+      pdate = Optim_Pointer(CF);
+      if (*pdate != DATE_ALWAYS && *pdate != date)
+	continue;
+
+      fct = Cstr_Address(CF);
+      AF = AF_Pointer(CF);
+
+      fct = (PlLong (*)()) (*fct) (AF);
 
-      /* reactivated ? */
-      if (Queue_Propag_Mask(fdv_adr) == 0) /* no longer in queue ? */
+      if (fct == (PlLong (*)()) FALSE)
 	{
-	  /*  Del_Var_From_Queue(fdv_adr); since Queue_Propag_Mask(fdv_adr) == 0 */
+	deferred_failure:
+	  Cstr_Weight(CF)++;
+	  goto clear_queue;
+	}
+#if 1				/* FD switch */
+      if (fct != (PlLong (*)()) TRUE)	/* FD switch case triggered */
+	{
+	  if ((*fct) (AF) == FALSE)
+	    goto deferred_failure;
 
-	  if (BP == TP)
-	    break;
+	  Pl_Fd_Stop_Constraint(CF);
+	}
+#endif
 
-	  BP = Queue_Next_Fdv_Adr(BP);
+      if (CF_Is_Idempotent(CF) && TP != dummy_fd_var)
+	{			/* mark the changes it has just done */
+	  running_cf = CF;
+	  BP = Queue_Next_Fdv_Adr(dummy_fd_var);
+	  for (;;)
+	    {
+	      Queue_Propag_Mask(BP) |= MASK_OWN_CHANGES;
+	      if (BP == TP)
+		break;
+	      BP = Queue_Next_Fdv_Adr(BP);
+	    }
 	}
     }
 
-  TP = dummy_fd_var;		/* queue is now empty */
-
   return TRUE;
 }
 
@@ -1457,6 +1632,55 @@ Pl_Fd_Stop_Constraint(WamWord *CF)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_FD_IDEMPOTENT_CONSTRAINT                                             *
+ *                                                                         *
+ * Declares that a constraint reaches its own fix-point when reexecuted.   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Idempotent_Constraint(WamWord *CF)
+{
+  Queue_Info(CF) |= CF_IDEMPOTENT;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_WEIGHTED_DEGREE                                                   *
+ *                                                                         *
+ * Returns the sum of the weights (see Cstr_Weight) of the constraints     *
+ * depending on an FD variable (one per chain record) which are not        *
+ * stopped and whose tell variable is not yet instantiated (used by the    *
+ * dom/wdeg labeling heuristic).                                           *
+ *-------------------------------------------------------------------------*/
+PlLong
+Pl_Fd_Weighted_Degree(WamWord *fdv_adr)
+{
+  WamWord *record_adr;
+  WamWord **chain_adr;
+  WamWord *CF;
+  PlLong wdeg = 0;
+  int i;
+
+  if (Fd_Variable_Is_Ground(fdv_adr))
+    return 0;
+
+  chain_adr = &Chain_Min(fdv_adr);
+  for (i = CHAIN_NB_MIN; i <= CHAIN_NB_VAL; i++, chain_adr++)
+    for (record_adr = *chain_adr; record_adr; record_adr = Next_Chain(record_adr))
+      {
+	CF = CF_Pointer(record_adr);
+	if (*Optim_Pointer(CF) == DATE_ALWAYS)
+	  wdeg += Cstr_Weight(CF);
+      }
+
+  return wdeg;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_IN_INTERVAL                                                       *
  *                                                                         *
@@ -1569,7 +1793,7 @@ Pl_Fd_Use_Vector(WamWord *fdv_adr)
 {
   Range range;
 
-  if (Is_Sparse(Range(fdv_adr)))
+  if (!Is_Interval(Range(fdv_adr)))
     return TRUE;
 
   Pl_Fd_Before_Add_Cstr();
@@ -1638,7 +1862,7 @@ Pl_Fd_Check_For_Bool_Var(WamWord x_word)
 				/* Check Bool == X in 0..1 */
   Pl_Fd_Before_Add_Cstr();
 
-  if (Is_Sparse(Range(fdv_adr)))
+  if (!Is_Interval(Range(fdv_adr)))
     {
       Range_Init_Interval(&range, 0, 1);
 
@@ -1664,6 +1888,8 @@ Pl_Fd_Variable_Size0(WamWord *fdv_adr)
 
   if (Is_Sparse(Range(fdv_adr)))
       size += pl_vec_size;
+  else if (Is_Interval_List(Range(fdv_adr)))
+      size += List_Size(List_Nb_Itv(Range_List(Range(fdv_adr))));
 
   return size;
 }
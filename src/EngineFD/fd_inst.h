@@ -77,6 +77,7 @@
 	  /* Shorthands for Queue management */
 
 #define MASK_TO_KEEP_IN_QUEUE      (1 << 8) /* only 5 chains */
+#define MASK_OWN_CHANGES           (1 << 9) /* see Pl_Fd_After_Add_Cstr */
 
 #define Is_Var_In_Queue(fdv_adr)   (Queue_Propag_Mask(fdv_adr) != 0) /* mask = 0 <=> not in the queue */
 #define Del_Var_From_Queue(fdv_adr)(Queue_Propag_Mask(fdv_adr) = 0)
@@ -139,13 +140,37 @@
 
 	  /* Constraint Frame */
 
-#define CONSTRAINT_FRAME_SIZE      3
+#define CONSTRAINT_FRAME_SIZE      5
 
 #define OFFSET_OF_OPTIM_POINTER    1	/* this offset must correspond to >>> */
 
 #define AF_Pointer(cf)             (*(WamWord **)    &(cf[0]))
 #define Optim_Pointer(cf)          (*(PlULong **)    &(cf[1]))	/* >>> this cell */
 #define Cstr_Address(cf)           (*(PlLong (**)()) &(cf[2]))
+#define Queue_Info(cf)             (*(PlULong *)     &(cf[3]))
+#define Cstr_Weight(cf)            (*(PlULong *)     &(cf[4]))	/* failures + 1 (not trailed) */
+
+
+
+
+	  /* Constraint Queue (propagation priorities) */
+
+#define NB_PRIORITIES              4
+
+#define PRIORITY_VAL               0	/* executed at once (as soon as woken) */
+#define PRIORITY_BOUNDS            1
+#define PRIORITY_DOM               2	/* deferred in the constraint queue */
+#define PRIORITY_GLOBAL            3
+
+#define CF_PRIORITY_MASK           3
+#define CF_IDEMPOTENT              4
+#define CF_STAMP_SHIFT             3	/* Queue_Info = stamp | idempotent | priority */
+#define CF_FLAGS_MASK              ((1 << CF_STAMP_SHIFT) - 1)
+
+#define CF_Stamp(cf)               (Queue_Info(cf) & ~(PlULong) CF_FLAGS_MASK)
+#define CF_Priority(cf)            (Queue_Info(cf) & CF_PRIORITY_MASK)
+#define CF_Is_Idempotent(cf)       (Queue_Info(cf) & CF_IDEMPOTENT)
+#define CF_Is_Deferred(cf)         (CF_Priority(cf) >= PRIORITY_DOM)
 
 
 
@@ -162,6 +187,25 @@
 
 
 
+	  /* a word of the constraint stack older than the last choice point */
+
+#define FD_Word_Needs_Trailing(adr)  ((adr) <  CSB(B))
+
+
+
+
+#define FD_Bind_OV(adr, word)       		\
+  do						\
+    {						\
+      if (FD_Word_Needs_Trailing(adr))		\
+	Trail_OV(adr);				\
+      *(adr) = (word);				\
+    }						\
+  while (0)
+
+
+
+
 #define math_min(x, y)             ((x) <= (y) ? (x) : (y))
 #define math_max(x, y)             ((x) >= (y) ? (x) : (y))
 
@@ -181,11 +225,19 @@
 WamWord pl_vec_size;
 WamWord pl_vec_max_integer;
 
+WamWord *pl_fd_bound_adr;	/* objective of a branch-and-bound or NULL */
+int pl_fd_bound_min;
+int pl_fd_bound_max;
+
 #else
 
 extern WamWord pl_vec_size;
 extern WamWord pl_vec_max_integer;
 
+extern WamWord *pl_fd_bound_adr;
+extern int pl_fd_bound_min;
+extern int pl_fd_bound_max;
+
 #endif
 
 
@@ -232,6 +284,10 @@ Bool Pl_Fd_After_Add_Cstr(Bool result_of_tell);
 
 void Pl_Fd_Stop_Constraint(WamWord *CF);
 
+void Pl_Fd_Idempotent_Constraint(WamWord *CF);
+
+PlLong Pl_Fd_Weighted_Degree(WamWord *fdv_adr);
+
 
 
 Bool Pl_Fd_Tell_Value(WamWord *fdv_adr, int n);
@@ -37,6 +37,7 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "bool.h"
@@ -118,6 +119,218 @@
 
 
 
+/*---------------------------------*
+ * Vector kernels                  *
+ *---------------------------------*/
+
+/* The word loops of the vector operations are written as kernels that the C
+ * compiler can vectorize (SSE2 is always available on x86-64). On x86-64
+ * with gcc/clang each kernel is also compiled for AVX2 (and popcnt) and this
+ * version is selected at run-time, when the size of vectors is defined (see
+ * Pl_Define_Vector_Size), if the CPU supports it and the vectors are large
+ * enough to benefit from it.
+ */
+
+#if defined(__GNUC__) && (__GNUC__ >= 6 || defined(__clang__)) && \
+    defined(__x86_64__) && !defined(_WIN32)
+#define VECTOR_AVX2_DISPATCH
+#endif
+
+#define VECTOR_AVX2_MIN_SIZE       8	/* in words */
+
+
+#ifdef __GNUC__
+#define KERNEL                     static inline __attribute__((always_inline))
+#else
+#define KERNEL                     static
+#endif
+
+
+#ifdef VECTOR_AVX2_DISPATCH
+
+#define AVX2_FCT                   static __attribute__((target("avx2,popcnt")))
+
+static Bool vector_avx2;
+
+#endif
+
+
+
+
+KERNEL void
+Vector_Copy_Kernel(Vector vec, Vector vec1)
+{
+  int i;
+
+  for (i = 0; i < pl_vec_size; i++)
+    vec[i] = vec1[i];
+}
+
+
+KERNEL void
+Vector_Union_Kernel(Vector vec, Vector vec1)
+{
+  int i;
+
+  for (i = 0; i < pl_vec_size; i++)
+    vec[i] |= vec1[i];
+}
+
+
+KERNEL void
+Vector_Inter_Kernel(Vector vec, Vector vec1)
+{
+  int i;
+
+  for (i = 0; i < pl_vec_size; i++)
+    vec[i] &= vec1[i];
+}
+
+
+KERNEL void
+Vector_Compl_Kernel(Vector vec)
+{
+  int i;
+
+  for (i = 0; i < pl_vec_size; i++)
+    vec[i] = ~vec[i];
+}
+
+
+KERNEL int
+Vector_Nb_Elem_Kernel(Vector vec)
+{
+  int nb_elem = 0;
+  int i;
+
+  for (i = 0; i < pl_vec_size; i++)
+    nb_elem += Pl_Count_Set_Bits(vec[i]);
+
+  return nb_elem;
+}
+
+
+KERNEL Bool
+Vector_Test_Null_Inter_Kernel(Vector vec, Vector vec1)
+{
+  int i = 0;
+
+  for (; i + 4 <= pl_vec_size; i += 4) /* test 4 words at once */
+    if ((vec[i] & vec1[i]) | (vec[i + 1] & vec1[i + 1]) |
+	(vec[i + 2] & vec1[i + 2]) | (vec[i + 3] & vec1[i + 3]))
+      return FALSE;
+
+  for (; i < pl_vec_size; i++)
+    if (vec[i] & vec1[i])
+      return FALSE;
+
+  return TRUE;
+}
+
+
+
+
+#ifdef VECTOR_AVX2_DISPATCH
+
+AVX2_FCT void
+Vector_Copy_Avx2(Vector vec, Vector vec1)
+{
+  Vector_Copy_Kernel(vec, vec1);
+}
+
+
+AVX2_FCT void
+Vector_Union_Avx2(Vector vec, Vector vec1)
+{
+  Vector_Union_Kernel(vec, vec1);
+}
+
+
+AVX2_FCT void
+Vector_Inter_Avx2(Vector vec, Vector vec1)
+{
+  Vector_Inter_Kernel(vec, vec1);
+}
+
+
+AVX2_FCT void
+Vector_Compl_Avx2(Vector vec)
+{
+  Vector_Compl_Kernel(vec);
+}
+
+
+AVX2_FCT int
+Vector_Nb_Elem_Avx2(Vector vec)
+{
+  return Vector_Nb_Elem_Kernel(vec);
+}
+
+
+AVX2_FCT Bool
+Vector_Test_Null_Inter_Avx2(Vector vec, Vector vec1)
+{
+  return Vector_Test_Null_Inter_Kernel(vec, vec1);
+}
+
+#endif
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VECTOR_OR_SHIFTED_LEFT                                                  *
+ *                                                                         *
+ * vec = vec U {x + n | x in vec1} (n >= 0, values > max are lost).        *
+ *-------------------------------------------------------------------------*/
+static void
+Vector_Or_Shifted_Left(Vector vec, Vector vec1, int n)
+{
+  int word_no = Word_No(n);
+  int bit_no = Bit_No(n);
+  int i, j;
+
+  if (bit_no == 0)
+    for (i = word_no, j = 0; i < pl_vec_size; i++, j++)
+      vec[i] |= vec1[j];
+  else
+    {
+      vec[word_no] |= vec1[0] << bit_no;
+      for (i = word_no + 1, j = 1; i < pl_vec_size; i++, j++)
+	vec[i] |= (vec1[j] << bit_no) | (vec1[j - 1] >> (WORD_SIZE - bit_no));
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VECTOR_OR_SHIFTED_RIGHT                                                 *
+ *                                                                         *
+ * vec = vec U {x - n | x in vec1} (n >= 0, values < 0 are lost).          *
+ *-------------------------------------------------------------------------*/
+static void
+Vector_Or_Shifted_Right(Vector vec, Vector vec1, int n)
+{
+  int word_no = Word_No(n);
+  int bit_no = Bit_No(n);
+  int last = pl_vec_size - 1 - word_no;
+  int i, j;
+
+  if (bit_no == 0)
+    for (i = 0, j = word_no; i <= last; i++, j++)
+      vec[i] |= vec1[j];
+  else
+    {
+      for (i = 0, j = word_no; i < last; i++, j++)
+	vec[i] |= (vec1[j] >> bit_no) | (vec1[j + 1] << (WORD_SIZE - bit_no));
+      vec[last] |= vec1[pl_vec_size - 1] >> bit_no;
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_DEFINE_VECTOR_SIZE                                                   *
  *                                                                         *
@@ -127,6 +340,11 @@ Pl_Define_Vector_Size(int max_val)
 {
   pl_vec_size = max_val / WORD_SIZE + 1;
   pl_vec_max_integer = pl_vec_size * WORD_SIZE - 1;
+
+#ifdef VECTOR_AVX2_DISPATCH
+  vector_avx2 = pl_vec_size >= VECTOR_AVX2_MIN_SIZE &&
+    __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
 }
 
 
@@ -175,17 +393,12 @@ Pl_Vector_From_Interval(Vector vec, int min, int max)
 int
 Pl_Vector_Nb_Elem(Vector vec)
 {
-  register Vector end = vec + pl_vec_size;
-  register int nb_elem = 0;
-
-  do
-    {
-      nb_elem += Pl_Count_Set_Bits(*vec);
-      vec++;
-    }
-  while (vec < end);
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    return Vector_Nb_Elem_Avx2(vec);
+#endif
 
-  return nb_elem;
+  return Vector_Nb_Elem_Kernel(vec);
 }
 
 
@@ -198,16 +411,27 @@ Pl_Vector_Nb_Elem(Vector vec)
 int
 Pl_Vector_Ith_Elem(Vector vec, int i)
 {
-  int vec_elem;
+  int word_no;
+  VecWord word;
+  int nb;
 
-  if (i > 0)			/* 1 <= i  <= nb_elem */
+  if (i <= 0)			/* 1 <= i  <= nb_elem */
+    return -1;
+
+  for (word_no = 0; word_no < pl_vec_size; word_no++)
     {
-      VECTOR_BEGIN_ENUM(vec, vec_elem);
+      word = vec[word_no];
+      nb = Pl_Count_Set_Bits(word);
+      if (i > nb)		/* skip the whole word */
+	{
+	  i -= nb;
+	  continue;
+	}
 
-      if (--i == 0)
-	return vec_elem;
+      while (--i)		/* reset the i-1 least bits */
+	word &= word - 1;
 
-      VECTOR_END_ENUM;
+      return Word_No_And_Bit_No(word_no, Pl_Least_Significant_Bit(word));
     }
 
   return -1;
@@ -361,15 +585,12 @@ Pl_Vector_Full(Vector vec)
 Bool
 Pl_Vector_Test_Null_Inter(Vector vec, Vector vec1)
 {
-  Vector end = vec + pl_vec_size;
-
-  do
-    if (*vec++ & *vec1++)
-      return FALSE;
-
-  while (vec < end);
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    return Vector_Test_Null_Inter_Avx2(vec, vec1);
+#endif
 
-  return TRUE;
+  return Vector_Test_Null_Inter_Kernel(vec, vec1);
 }
 
 
@@ -380,11 +601,15 @@ Pl_Vector_Test_Null_Inter(Vector vec, Vector vec1)
 void
 Pl_Vector_Copy(Vector vec, Vector vec1)
 {
-  Vector end = vec + pl_vec_size;
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    {
+      Vector_Copy_Avx2(vec, vec1);
+      return;
+    }
+#endif
 
-  do
-    *vec++ = *vec1++;
-  while (vec < end);
+  Vector_Copy_Kernel(vec, vec1);
 }
 
 
@@ -397,11 +622,15 @@ Pl_Vector_Copy(Vector vec, Vector vec1)
 void
 Pl_Vector_Union(Vector vec, Vector vec1)
 {
-  Vector end = vec + pl_vec_size;
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    {
+      Vector_Union_Avx2(vec, vec1);
+      return;
+    }
+#endif
 
-  do
-    *vec++ |= *vec1++;
-  while (vec < end);
+  Vector_Union_Kernel(vec, vec1);
 }
 
 
@@ -414,11 +643,15 @@ Pl_Vector_Union(Vector vec, Vector vec1)
 void
 Pl_Vector_Inter(Vector vec, Vector vec1)
 {
-  Vector end = vec + pl_vec_size;
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    {
+      Vector_Inter_Avx2(vec, vec1);
+      return;
+    }
+#endif
 
-  do
-    *vec++ &= *vec1++;
-  while (vec < end);
+  Vector_Inter_Kernel(vec, vec1);
 }
 
 
@@ -431,11 +664,15 @@ Pl_Vector_Inter(Vector vec, Vector vec1)
 void
 Pl_Vector_Compl(Vector vec)
 {
-  Vector end = vec + pl_vec_size;
+#ifdef VECTOR_AVX2_DISPATCH
+  if (vector_avx2)
+    {
+      Vector_Compl_Avx2(vec);
+      return;
+    }
+#endif
 
-  do
-    *vec = ~(*vec), vec++;
-  while (vec < end);
+  Vector_Compl_Kernel(vec);
 }
 
 
@@ -449,27 +686,16 @@ void
 Pl_Vector_Add_Vector(Vector vec, Vector vec1)
 {
   Vector aux_vec;
-  int vec_elem, vec_elem1;
-  int x;
+  int vec_elem1;
 
   Vector_Allocate(aux_vec);
   Pl_Vector_Copy(aux_vec, vec);
   Pl_Vector_Empty(vec);
 
-  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
-
+  /* vec = U (aux_vec + x) for each x in vec1 (shifted word by word) */
   VECTOR_BEGIN_ENUM(vec1, vec_elem1);
 
-  x = vec_elem + vec_elem1;
-
-  if (x > pl_vec_max_integer)
-    goto loop1;
-
-  Vector_Set_Value(vec, x);
-
-  VECTOR_END_ENUM;
-
-loop1:;
+  Vector_Or_Shifted_Left(vec, aux_vec, vec_elem1);
 
   VECTOR_END_ENUM;
 }
@@ -485,26 +711,16 @@ void
 Pl_Vector_Sub_Vector(Vector vec, Vector vec1)
 {
   Vector aux_vec;
-  int vec_elem, vec_elem1;
-  int x;
+  int vec_elem1;
 
   Vector_Allocate(aux_vec);
   Pl_Vector_Copy(aux_vec, vec);
   Pl_Vector_Empty(vec);
 
-  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
-
+  /* vec = U (aux_vec - x) for each x in vec1 (shifted word by word) */
   VECTOR_BEGIN_ENUM(vec1, vec_elem1);
 
-  x = vec_elem - vec_elem1;
-
-  if (x < 0)
-    goto loop1;
-
-  Vector_Set_Value(vec, x);
-  VECTOR_END_ENUM;
-
-loop1:;
+  Vector_Or_Shifted_Right(vec, aux_vec, vec_elem1);
 
   VECTOR_END_ENUM;
 }
@@ -715,71 +931,707 @@ Pl_Vector_Mul_Value(Vector vec, int n)
   if ((unsigned) x > (unsigned) pl_vec_max_integer)
     return;
 
-  Vector_Set_Value(vec, x);
+  Vector_Set_Value(vec, x);
+
+  VECTOR_END_ENUM;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_VECTOR_DIV_VALUE                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Vector_Div_Value(Vector vec, int n)
+{
+  Vector aux_vec;
+  int vec_elem;
+  int x;
+
+  Vector_Allocate(aux_vec);
+  Pl_Vector_Copy(aux_vec, vec);
+  Pl_Vector_Empty(vec);
+
+  if (n == 0)
+    return;
+
+  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
+
+  if (vec_elem % n == 0)
+    {
+      x = vec_elem / n;
+      Vector_Set_Value(vec, x);
+    }
+
+  VECTOR_END_ENUM;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_VECTOR_MOD_VALUE                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Vector_Mod_Value(Vector vec, int n)
+{
+  Vector aux_vec;
+  int vec_elem;
+  int x;
+
+  Vector_Allocate(aux_vec);
+  Pl_Vector_Copy(aux_vec, vec);
+  Pl_Vector_Empty(vec);
+
+  if (n == 0)
+    return;
+
+  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
+
+  x = vec_elem % n;
+  if ((unsigned) x <= (unsigned) pl_vec_max_integer)
+    Vector_Set_Value(vec, x);
+
+  VECTOR_END_ENUM;
+}
+
+
+
+
+/*---------------------------------*
+ * Interval lists                  *
+ *---------------------------------*/
+
+/* A new interval list is built at the top of RANGE_TOP_STACK: intervals are
+ * pushed by increasing min (List_Push merges overlapping or adjacent ones)
+ * then the list is committed. Intervals which are not produced in order are
+ * first stored in a buffer (also at the top of the stack) which is sorted by
+ * List_From_Buffer. Like vectors, lists only contain values in
+ * 0..INTERVAL_MAX_INTEGER. List_Of_Range gives a (possibly temporary) list
+ * for any range, so that operations involving a list can be done on lists.
+ */
+
+#define LIST_ADD                   0
+#define LIST_SUB                   1
+#define LIST_MUL                   2
+#define LIST_DIV                   3
+#define LIST_MOD                   4
+
+#define LIST_MAX_PAIRS             4096	/* beyond: use the hull of list1 */
+
+
+#define Mul_Bound(x, y)            ((x) != 0 && (y) > (INTERVAL_MAX_INTEGER + 1) / (x) ? \
+                                    INTERVAL_MAX_INTEGER + 1 : (x) * (y))
+
+
+
+
+static IntervalList
+List_Start(void)
+{
+  IntervalList list = (IntervalList) RANGE_TOP_STACK;
+
+  List_Nb_Itv(list) = 0;
+
+  return list;
+}
+
+
+static void
+List_Push(IntervalList list, int min, int max)
+{
+  int nb = List_Nb_Itv(list);
+
+  if (min < 0)
+    min = 0;
+
+  if (max > INTERVAL_MAX_INTEGER)
+    max = INTERVAL_MAX_INTEGER;
+
+  if (min > max)
+    return;
+
+  if (nb > 0 && min <= List_Max(list, nb - 1) + 1)
+    {
+      if (max > List_Max(list, nb - 1))
+	List_Max(list, nb - 1) = max;
+      return;
+    }
+
+  List_Min(list, nb) = min;
+  List_Max(list, nb) = max;
+  List_Nb_Itv(list) = nb + 1;
+}
+
+
+static IntervalList
+List_Commit(IntervalList list)
+{
+  RANGE_TOP_STACK += List_Size(List_Nb_Itv(list));
+
+  return list;
+}
+
+
+static int
+Cmp_Interval(const void *p1, const void *p2)
+{
+  int min1 = *(const int *) p1;
+  int min2 = *(const int *) p2;
+
+  return (min1 > min2) - (min1 < min2);
+}
+
+
+static IntervalList
+List_From_Buffer(int *buff, int nb)
+{
+  IntervalList list = buff - 1;	/* buff starts after the nb of intervals */
+  int i;
+
+  qsort(buff, nb, 2 * sizeof(int), Cmp_Interval);
+
+  List_Nb_Itv(list) = 0;	/* merge in place (never overtakes reading) */
+  for (i = 0; i < nb; i++)
+    List_Push(list, buff[2 * i], buff[2 * i + 1]);
+
+  return List_Commit(list);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VECTOR_SET_INTERVAL                                                     *
+ *                                                                         *
+ * Sets all values in min..max (0 <= min <= max <= pl_vec_max_integer).    *
+ *-------------------------------------------------------------------------*/
+static void
+Vector_Set_Interval(Vector vec, int min, int max)
+{
+  Vector w_min = vec + Word_No(min);
+  Vector w_max = vec + Word_No(max);
+  VecWord mask_min = ALL_1 << Bit_No(min);
+  VecWord mask_max = ALL_1 >> (WORD_SIZE - 1 - Bit_No(max));
+
+  if (w_min == w_max)
+    {
+      *w_min |= mask_min & mask_max;
+      return;
+    }
+
+  *w_min++ |= mask_min;
+  while (w_min < w_max)
+    *w_min++ = ALL_1;
+  *w_max |= mask_max;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VECTOR_RUN_END                                                          *
+ *                                                                         *
+ * Returns the end of the run of values starting at n (n is in vec).       *
+ *-------------------------------------------------------------------------*/
+static int
+Vector_Run_End(Vector vec, int n)
+{
+  Vector start = vec + Word_No(n);
+  Vector end = vec + pl_vec_size;
+  VecWord word = ~*start & (ALL_1 << Bit_No(n));
+
+  while (word == 0)
+    {
+      if (++start >= end)
+	return pl_vec_max_integer;
+
+      word = ~*start;
+    }
+
+  return Word_No_And_Bit_No(start - vec, Pl_Least_Significant_Bit(word)) - 1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VECTOR_FROM_LIST                                                        *
+ *                                                                         *
+ * Only the values <= pl_vec_max_integer are kept.                         *
+ *-------------------------------------------------------------------------*/
+static void
+Vector_From_List(Vector vec, IntervalList list)
+{
+  int nb = List_Nb_Itv(list);
+  int i;
+
+  Pl_Vector_Empty(vec);
+
+  for (i = 0; i < nb && List_Min(list, i) <= pl_vec_max_integer; i++)
+    Vector_Set_Interval(vec, List_Min(list, i),
+			math_min(List_Max(list, i), pl_vec_max_integer));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_OF_RANGE                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static IntervalList
+List_Of_Range(Range *range)
+{
+  IntervalList list;
+  int n, end;
+
+  if (Is_Interval_List(range))
+    return Range_List(range);
+
+  list = List_Start();
+
+  if (Is_Empty(range))
+    ;
+  else if (Is_Interval(range))
+    List_Push(list, range->min, range->max);
+  else
+    for (n = Pl_Vector_Next_After(range->vec, -1); n >= 0;
+	 n = Pl_Vector_Next_After(range->vec, end))
+      {
+	end = Vector_Run_End(range->vec, n);
+	List_Push(list, n, end);
+      }
+
+  return List_Commit(list);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RANGE_FROM_LIST                                                         *
+ *                                                                         *
+ * Sets range (except extra_cstr) choosing the most suited representation: *
+ * an interval, a vector if all values fit in it, else the list itself.    *
+ *-------------------------------------------------------------------------*/
+static void
+Range_From_List(Range *range, IntervalList list)
+{
+  int nb = List_Nb_Itv(list);
+
+  if (nb == 0)
+    {
+      range->vec = NULL;
+      Set_To_Empty(range);
+      return;
+    }
+
+  range->min = List_Min(list, 0);
+  range->max = List_Max(list, nb - 1);
+
+  if (nb == 1)
+    range->vec = NULL;
+  else if (range->max > pl_vec_max_integer)
+    Range_Set_List(range, list);
+  else
+    {
+      Vector_Allocate_If_Necessary(range->vec);
+      Vector_From_List(range->vec, list);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_LOCATE                                                             *
+ *                                                                         *
+ * Returns the index of the first interval whose max >= n (or nb).         *
+ *-------------------------------------------------------------------------*/
+static int
+List_Locate(IntervalList list, int n)
+{
+  int lo = 0;
+  int hi = List_Nb_Itv(list);
+  int mid;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (List_Max(list, mid) < n)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return lo;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_NB_ELEM                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+List_Nb_Elem(IntervalList list)
+{
+  int nb = List_Nb_Itv(list);
+  int n = 0;
+  int i;
+
+  for (i = 0; i < nb; i++)
+    n += List_Max(list, i) - List_Min(list, i) + 1;
+
+  return n;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_ITH_ELEM                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+List_Ith_Elem(IntervalList list, int i)
+{
+  int nb = List_Nb_Itv(list);
+  int k, size;
+
+  if (i <= 0)			/* 1 <= i  <= nb_elem */
+    return -1;
+
+  for (k = 0; k < nb; k++)
+    {
+      size = List_Max(list, k) - List_Min(list, k) + 1;
+      if (i <= size)
+	return List_Min(list, k) + i - 1;
+
+      i -= size;
+    }
+
+  return -1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_NEXT_AFTER                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+List_Next_After(IntervalList list, int n)
+{
+  int i;
+
+  if (n < 0)
+    n = -1;
+
+  i = List_Locate(list, n + 1);
+  if (i >= List_Nb_Itv(list))
+    return -1;
+
+  return math_max(List_Min(list, i), n + 1);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_NEXT_BEFORE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+List_Next_Before(IntervalList list, int n)
+{
+  int i;
+
+  if (n <= 0)
+    return -1;
+
+  i = List_Locate(list, n - 1);
+  if (i < List_Nb_Itv(list) && List_Min(list, i) <= n - 1)
+    return n - 1;
+
+  return (i > 0) ? List_Max(list, i - 1) : -1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_UNION                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static IntervalList
+List_Union(IntervalList list, IntervalList list1)
+{
+  IntervalList u = List_Start();
+  int nb = List_Nb_Itv(list);
+  int nb1 = List_Nb_Itv(list1);
+  int i = 0, i1 = 0;
+
+  while (i < nb || i1 < nb1)
+    if (i1 >= nb1 || (i < nb && List_Min(list, i) <= List_Min(list1, i1)))
+      {
+	List_Push(u, List_Min(list, i), List_Max(list, i));
+	i++;
+      }
+    else
+      {
+	List_Push(u, List_Min(list1, i1), List_Max(list1, i1));
+	i1++;
+      }
+
+  return List_Commit(u);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_INTER                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static IntervalList
+List_Inter(IntervalList list, IntervalList list1)
+{
+  IntervalList r = List_Start();
+  int nb = List_Nb_Itv(list);
+  int nb1 = List_Nb_Itv(list1);
+  int i = 0, i1 = 0;
+
+  while (i < nb && i1 < nb1)
+    {
+      List_Push(r, math_max(List_Min(list, i), List_Min(list1, i1)),
+		math_min(List_Max(list, i), List_Max(list1, i1)));
+
+      if (List_Max(list, i) < List_Max(list1, i1))
+	i++;
+      else
+	i1++;
+    }
+
+  return List_Commit(r);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_COMPL                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static IntervalList
+List_Compl(IntervalList list)
+{
+  IntervalList r = List_Start();
+  int nb = List_Nb_Itv(list);
+  int n = 0;
+  int i;
+
+  for (i = 0; i < nb; i++)
+    {
+      List_Push(r, n, List_Min(list, i) - 1);
+      n = List_Max(list, i) + 1;
+    }
+
+  List_Push(r, n, INTERVAL_MAX_INTEGER);
+
+  return List_Commit(r);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LIST_RESET_VALUE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static IntervalList
+List_Reset_Value(IntervalList list, int n)
+{
+  IntervalList r = List_Start();
+  int nb = List_Nb_Itv(list);
+  int i;
+
+  for (i = 0; i < nb; i++)
+    if (n < List_Min(list, i) || n > List_Max(list, i))
+      List_Push(r, List_Min(list, i), List_Max(list, i));
+    else
+      {
+	List_Push(r, List_Min(list, i), n - 1);
+	List_Push(r, n + 1, List_Max(list, i));
+      }
 
-  VECTOR_END_ENUM;
+  return List_Commit(r);
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_VECTOR_DIV_VALUE                                                     *
+ * LIST_ARITH                                                              *
  *                                                                         *
+ * Computes list op list1 (op is LIST_ADD, ...) as the union over each    *
+ * pair of intervals. This is exact for + and - (and for a single value)   *
+ * but a superset for *, / (exact division) and mod on wide intervals,     *
+ * which is sound for propagation. Values < 0 are ignored (like vectors).  *
  *-------------------------------------------------------------------------*/
-void
-Pl_Vector_Div_Value(Vector vec, int n)
+static IntervalList
+List_Arith(IntervalList list, IntervalList list1, int op)
 {
-  Vector aux_vec;
-  int vec_elem;
-  int x;
+  int nb = List_Nb_Itv(list);
+  int nb1 = List_Nb_Itv(list1);
+  int hull[3];
+  int *buff = (int *) RANGE_TOP_STACK + 1; /* +1 for the nb of intervals */
+  int n = 0;
+  int i, i1;
+  int a, b, a1, b1, r, r1;
+
+#define Buffer_Push(min, max)			\
+  do						\
+    {						\
+      int itv_min = math_max(min, 0);		\
+      int itv_max = math_min(max, INTERVAL_MAX_INTEGER);	\
+						\
+      if (itv_min <= itv_max)			\
+	{					\
+	  buff[2 * n] = itv_min;		\
+	  buff[2 * n + 1] = itv_max;		\
+	  n++;					\
+	}					\
+    }						\
+  while (0)
+
+  if (nb1 > 1 && nb * nb1 > LIST_MAX_PAIRS)
+    {
+      hull[0] = 1;
+      hull[1] = List_Min(list1, 0);
+      hull[2] = List_Max(list1, nb1 - 1);
+      list1 = hull;
+      nb1 = 1;
+    }
 
-  Vector_Allocate(aux_vec);
-  Pl_Vector_Copy(aux_vec, vec);
-  Pl_Vector_Empty(vec);
+  for (i = 0; i < nb; i++)
+    for (i1 = 0; i1 < nb1; i1++)
+      {
+	a = List_Min(list, i);
+	b = List_Max(list, i);
+	a1 = List_Min(list1, i1);
+	b1 = List_Max(list1, i1);
+
+	switch (op)
+	  {
+	  case LIST_ADD:
+	    Buffer_Push(a + a1, b + b1);
+	    break;
+
+	  case LIST_SUB:
+	    Buffer_Push(a - b1, b - a1);
+	    break;
+
+	  case LIST_MUL:
+	    Buffer_Push(Mul_Bound(a, a1), Mul_Bound(b, b1));
+	    break;
+
+	  case LIST_DIV:	/* 0 is never a divisor */
+	    if (b1 <= 0)
+	      break;
+	    if (a1 <= 0)
+	      a1 = 1;
+	    Buffer_Push((a + b1 - 1) / b1, b / a1);
+	    break;
+
+	  case LIST_MOD:	/* 0 is never a divisor */
+	    if (b1 <= 0)
+	      break;
+	    if (a1 <= 0)
+	      a1 = 1;
+	    if (b < a1)		/* x mod y = x */
+	      Buffer_Push(a, b);
+	    else if (a1 < b1 || b - a + 1 >= a1)
+	      Buffer_Push(0, math_min(b, b1 - 1));
+	    else		/* single divisor: exact */
+	      {
+		r = a % a1;
+		r1 = b % a1;
+		if (r <= r1)
+		  Buffer_Push(r, r1);
+		else
+		  {
+		    Buffer_Push(0, r1);
+		    Buffer_Push(r, a1 - 1);
+		  }
+	      }
+	    break;
+	  }
+      }
 
-  if (n == 0)
-    return;
+#undef Buffer_Push
 
-  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
+  return List_From_Buffer(buff, n);
+}
 
-  if (vec_elem % n == 0)
-    {
-      x = vec_elem / n;
-      Vector_Set_Value(vec, x);
-    }
 
-  VECTOR_END_ENUM;
+
+
+/*-------------------------------------------------------------------------*
+ * RANGE_ARITH_LIST                                                        *
+ *                                                                         *
+ * range = range op range1 computed on lists (both are not empty).         *
+ *-------------------------------------------------------------------------*/
+static void
+Range_Arith_List(Range *range, Range *range1, int op)
+{
+  IntervalList list = List_Of_Range(range);
+  IntervalList list1 = List_Of_Range(range1);
+
+  range->extra_cstr |= range1->extra_cstr;
+  Range_From_List(range, List_Arith(list, list1, op));
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_VECTOR_MOD_VALUE                                                     *
+ * RANGE_ARITH_VALUE_LIST                                                  *
  *                                                                         *
+ * range = range op n computed on lists (range is not empty).              *
  *-------------------------------------------------------------------------*/
-void
-Pl_Vector_Mod_Value(Vector vec, int n)
+static void
+Range_Arith_Value_List(Range *range, int n, int op)
 {
-  Vector aux_vec;
-  int vec_elem;
-  int x;
+  int single[3];
 
-  Vector_Allocate(aux_vec);
-  Pl_Vector_Copy(aux_vec, vec);
-  Pl_Vector_Empty(vec);
+  single[0] = 1;
+  single[1] = single[2] = n;
 
-  if (n == 0)
-    return;
+  Range_From_List(range, List_Arith(List_Of_Range(range), single, op));
+}
 
-  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
 
-  x = vec_elem % n;
-  if ((unsigned) x <= (unsigned) pl_vec_max_integer)
-    Vector_Set_Value(vec, x);
 
-  VECTOR_END_ENUM;
+
+/*-------------------------------------------------------------------------*
+ * NEEDS_LIST                                                              *
+ *                                                                         *
+ * Are lists needed to compute a binary operation whose result is bounded  *
+ * by bound (i.e. one operand is a list or a value would not fit a vector)?*
+ *-------------------------------------------------------------------------*/
+static Bool
+Needs_List(Range *range, Range *range1, PlLong bound)
+{
+  return Is_Interval_List(range) || Is_Interval_List(range1) ||
+    range->max > pl_vec_max_integer || range1->max > pl_vec_max_integer ||
+    bound > pl_vec_max_integer;
 }
 
 
@@ -801,6 +1653,9 @@ Pl_Range_Test_Value(Range *range, int n)
   if (Is_Interval(range) || n == min || n == max)
     return TRUE;
 
+  if (Is_Interval_List(range))
+    return List_Next_After(Range_List(range), n - 1) == n;
+
   return Vector_Test_Value(range->vec, n);
 }
 
@@ -814,7 +1669,8 @@ Pl_Range_Test_Value(Range *range, int n)
 Bool
 Pl_Range_Test_Null_Inter(Range *range, Range *range1)
 {
-  int swt, i;
+  IntervalList list;
+  int swt, i, nb, n;
 
   if (range->min > range1->max || range1->min > range->max)
     return TRUE;
@@ -823,6 +1679,26 @@ Pl_Range_Test_Null_Inter(Range *range, Range *range1)
       range->max == range1->min || range->max == range1->max)
     return FALSE;
 
+  if (Is_Interval_List(range1))
+    return Pl_Range_Test_Null_Inter(range1, range);
+
+  if (Is_Interval_List(range))		/* List with any */
+    {
+      list = Range_List(range);
+      nb = List_Nb_Itv(list);
+      for (i = 0; i < nb; i++)
+	{
+	  n = Pl_Range_Next_After(range1, List_Min(list, i) - 1);
+	  if (n < 0)
+	    break;
+
+	  if (n <= List_Max(list, i))
+	    return FALSE;
+	}
+
+      return TRUE;
+    }
+
   swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
 
   if (swt == 3)			/* Sparse with Sparse */
@@ -844,11 +1720,9 @@ Pl_Range_Test_Null_Inter(Range *range, Range *range1)
   if (range->min <= range1->min)
     return FALSE;
 
-  for (i = range->min; i <= range->max; i++)
-    if (Vector_Test_Value(range1->vec, i))
-      return FALSE;
+  i = Pl_Vector_Next_After(range1->vec, range->min - 1);
 
-  return TRUE;
+  return i < 0 || i > range->max;
 }
 
 
@@ -867,6 +1741,15 @@ Pl_Range_Copy(Range *range, Range *range1)
 
   if (Is_Interval(range1))
     range->vec = NULL;
+  else if (Is_Interval_List(range1))	/* may overlap (see Pl_Fd_Tell_Range_Range) */
+    {
+      IntervalList list = (IntervalList) RANGE_TOP_STACK;
+      int size = List_Size(List_Nb_Itv(Range_List(range1)));
+
+      memmove(list, Range_List(range1), size * sizeof(VecWord));
+      RANGE_TOP_STACK += size;
+      Range_Set_List(range, list);
+    }
   else
     {
       Vector_Allocate_If_Necessary(range->vec);
@@ -887,6 +1770,8 @@ Pl_Range_Nb_Elem(Range *range)
   if (Is_Interval(range))	/* here range is not empty */
     return range->max - range->min + 1;
 
+  if (Is_Interval_List(range))
+    return List_Nb_Elem(Range_List(range));
 
   return Pl_Vector_Nb_Elem(range->vec);
 }
@@ -913,6 +1798,8 @@ Pl_Range_Ith_Elem(Range *range, int i)
       return n < range->min || n > range->max ? -1 : n;
     }
 
+  if (Is_Interval_List(range))
+    return List_Ith_Elem(Range_List(range), i);
 
   return Pl_Vector_Ith_Elem(range->vec, i);
 }
@@ -942,6 +1829,8 @@ Pl_Range_Next_After(Range *range, int n)
       return n;
     }
 
+  if (Is_Interval_List(range))
+    return List_Next_After(Range_List(range), n);
 
   return Pl_Vector_Next_After(range->vec, n);
 }
@@ -971,6 +1860,8 @@ Pl_Range_Next_Before(Range *range, int n)
       return n;
     }
 
+  if (Is_Interval_List(range))
+    return List_Next_Before(Range_List(range), n);
 
   return Pl_Vector_Next_Before(range->vec, n);
 }
@@ -978,6 +1869,88 @@ Pl_Range_Next_Before(Range *range, int n)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_RANGE_LIST_CAPACITY                                                  *
+ *                                                                         *
+ * Returns the number of intervals a list of nb intervals has room for.    *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Range_List_Capacity(int nb)
+{
+  int cap = 2;
+
+  while (cap < nb)
+    cap *= 2;
+
+  return cap;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_RANGE_LIST_RESET_VALUE                                               *
+ *                                                                         *
+ * Same as Pl_Range_Reset_Value for an interval list which can be modified *
+ * in place (i.e. the list is only referenced by range and is not needed   *
+ * to restore an older state). The list is only copied when an interval    *
+ * must be split and it is full (see List_Size) and not at the top of the  *
+ * stack. Since the copy doubles the room, removing k values costs O(k)    *
+ * space instead of O(k^2).                                                *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Range_List_Reset_Value(Range *range, int n)
+{
+  IntervalList list = Range_List(range);
+  IntervalList copy;
+  int nb = List_Nb_Itv(list);
+  int i = List_Locate(list, n);
+  int min, max;
+
+  if (i >= nb || n < List_Min(list, i))
+    return;
+
+  min = List_Min(list, i);
+  max = List_Max(list, i);
+
+  if (min == max)		/* remove the interval */
+    {
+      memmove(&List_Min(list, i), &List_Min(list, i + 1),
+	      2 * (nb - i - 1) * sizeof(int));
+      List_Nb_Itv(list) = nb - 1;
+    }
+  else if (n == min)
+    List_Min(list, i) = n + 1;
+  else if (n == max)
+    List_Max(list, i) = n - 1;
+  else				/* split the interval */
+    {
+      if (List_Size(nb + 1) != List_Size(nb))	/* list full */
+	{
+	  if ((Vector) list + List_Size(nb) == (Vector) RANGE_TOP_STACK)
+	    RANGE_TOP_STACK += List_Size(nb + 1) - List_Size(nb);
+	  else
+	    {
+	      copy = (IntervalList) RANGE_TOP_STACK;
+	      memcpy(copy, list, (2 * nb + 1) * sizeof(int));
+	      RANGE_TOP_STACK += List_Size(nb + 1);
+	      list = copy;
+	    }
+	}
+
+      memmove(&List_Min(list, i + 1), &List_Min(list, i),
+	      2 * (nb - i) * sizeof(int));
+      List_Max(list, i) = n - 1;
+      List_Min(list, i + 1) = n + 1;
+      List_Nb_Itv(list) = nb + 1;
+    }
+
+  Range_From_List(range, list);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_RANGE_BECOMES_SPARSE                                                 *
  *                                                                         *
@@ -1044,12 +2017,27 @@ Pl_Range_From_Vector(Range *range)
 void
 Pl_Range_Set_Value(Range *range, int n)
 {
+  Range r;
+
   if (Is_Empty(range))
     {
       Range_Init_Interval(range, n, n);
       return;
     }
 
+  if (n > pl_vec_max_integer || Is_Interval_List(range) ||
+      (Is_Interval(range) && range->max > pl_vec_max_integer))
+    {
+      if (n < 0)
+	range->extra_cstr = TRUE;
+      else
+	{
+	  Range_Init_Interval(&r, n, n);
+	  Pl_Range_Union(range, &r);
+	}
+      return;
+    }
+
   if (Is_Interval(range))
     {
       if (n >= range->min && n <= range->max)
@@ -1123,6 +2111,12 @@ Pl_Range_Reset_Value(Range *range, int n)
 	  return;
 	}
 
+      if (range->max > pl_vec_max_integer)
+	{
+	  Range_From_List(range, List_Reset_Value(List_Of_Range(range), n));
+	  return;
+	}
+
       Pl_Range_Becomes_Sparse(range);
       if ((unsigned) n <= (unsigned) pl_vec_max_integer)
 	Vector_Reset_Value(range->vec, n);
@@ -1130,6 +2124,11 @@ Pl_Range_Reset_Value(Range *range, int n)
       return;
     }
 
+  if (Is_Interval_List(range))
+    {
+      Range_From_List(range, List_Reset_Value(Range_List(range), n));
+      return;
+    }
 
   if ((unsigned) n > (unsigned) pl_vec_max_integer)
     return;
@@ -1150,21 +2149,33 @@ Pl_Range_Reset_Value(Range *range, int n)
 void
 Pl_Range_Union(Range *range, Range *range1)
 {
-  int swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+  int swt;
   Range r;
   Bool extra_cstr;
-  
-  if (swt == 0)			/* Interval with Interval */
+
+  if (Is_Interval(range) && Is_Interval(range1) &&
+      Is_Not_Empty(range) && Is_Not_Empty(range1) &&
+      range1->min <= range->max + 1 && range->min <= range1->max + 1)
     {
-      if (Is_Not_Empty(range) && Is_Not_Empty(range1) &&
-	  range1->min <= range->max + 1 && range->min <= range1->max + 1)
-	{
-/*       range->extra_cstr=FALSE; */
-	  range->min = math_min(range->min, range1->min);
-	  range->max = math_max(range->max, range1->max);
-	  return;
-	}
+/*   range->extra_cstr=FALSE; */
+      range->min = math_min(range->min, range1->min);
+      range->max = math_max(range->max, range1->max);
+      return;
+    }
+
+  if (Needs_List(range, range1, 0))
+    {
+      extra_cstr = range->extra_cstr | range1->extra_cstr;
+      Range_From_List(range, List_Union(List_Of_Range(range),
+					List_Of_Range(range1)));
+      range->extra_cstr = extra_cstr;
+      return;
+    }
 
+  swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+
+  if (swt == 0)			/* Interval with Interval */
+    {
       Pl_Range_Becomes_Sparse(range);
       r.vec = NULL;
       Pl_Range_Copy(&r, range1);	/* we cannot modify range1 */
@@ -1212,8 +2223,49 @@ Pl_Range_Union(Range *range, Range *range1)
 void
 Pl_Range_Inter(Range *range, Range *range1)
 {
-  int swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+  int swt;
   Range r;
+  IntervalList list;
+  Vector vec;
+
+  if (Is_Interval_List(range) || Is_Interval_List(range1))
+    {				/* a list is seen as a truncated vector */
+      if (Is_Sparse(range1))
+	range->extra_cstr = range1->extra_cstr;
+      else if (!Is_Sparse(range))
+	range->extra_cstr &= range1->extra_cstr;
+
+      if (Is_Empty(range))
+	return;
+
+      if (Is_Empty(range1))
+	{
+	  Set_To_Empty(range);
+	  return;
+	}
+
+      if (Is_Sparse(range))	/* Vector with List: result is a vector */
+	{
+	  Vector_Allocate(vec);
+	  Vector_From_List(vec, Range_List(range1));
+	  Pl_Vector_Inter(range->vec, vec);
+	  Pl_Range_From_Vector(range);
+	}
+      else if (Is_Sparse(range1))	/* List with Vector: idem */
+	{
+	  list = Range_List(range);
+	  Vector_Allocate(range->vec);
+	  Vector_From_List(range->vec, list);
+	  Pl_Vector_Inter(range->vec, range1->vec);
+	  Pl_Range_From_Vector(range);
+	}
+      else
+	Range_From_List(range, List_Inter(List_Of_Range(range),
+					  List_Of_Range(range1)));
+      return;
+    }
+
+  swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
 
   if (swt == 0)			/* Interval with Interval */
     {
@@ -1290,8 +2342,19 @@ Pl_Range_Compl(Range *range)
 	  return;
 	}
 
+      if (range->max > pl_vec_max_integer)
+	{
+	  Range_From_List(range, List_Compl(List_Of_Range(range)));
+	  return;
+	}
+
       Pl_Range_Becomes_Sparse(range);
     }
+  else if (Is_Interval_List(range))
+    {
+      Range_From_List(range, List_Compl(List_Of_Range(range)));
+      return;
+    }
   /* Sparse */
   range->extra_cstr = TRUE;
 
@@ -1318,7 +2381,7 @@ Pl_Range_Compl(Range *range)
 void
 Pl_Range_Add_Range(Range *range, Range *range1)
 {
-  int swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+  int swt;
   Range r;
 
   if (Is_Empty(range))
@@ -1330,14 +2393,23 @@ Pl_Range_Add_Range(Range *range, Range *range1)
       return;
     }
 
-  if (swt == 0)			/* Interval with Interval */
+  if (Is_Interval(range) && Is_Interval(range1))	/* Interval with Interval */
     {
 /*   range->extra_cstr=FALSE; */
       range->min += range1->min;
       range->max += range1->max;
       return;
     }
-  else if (swt == 1)		/* Interval with Sparse */
+
+  if (Needs_List(range, range1, (PlLong) range->max + range1->max))
+    {
+      Range_Arith_List(range, range1, LIST_ADD);
+      return;
+    }
+
+  swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+
+  if (swt == 1)		/* Interval with Sparse */
     Pl_Range_Becomes_Sparse(range);
   else if (swt == 2)		/* Sparse with Interval */
     {
@@ -1369,7 +2441,7 @@ Pl_Range_Add_Range(Range *range, Range *range1)
 void
 Pl_Range_Sub_Range(Range *range, Range *range1)
 {
-  int swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+  int swt;
   Range r;
 
   if (Is_Empty(range))
@@ -1381,14 +2453,23 @@ Pl_Range_Sub_Range(Range *range, Range *range1)
       return;
     }
 
-  if (swt == 0)			/* Interval with Interval */
+  if (Is_Interval(range) && Is_Interval(range1))	/* Interval with Interval */
     {
 /*   range->extra_cstr=FALSE; */
       range->min -= range1->max;
       range->max -= range1->min;
       return;
     }
-  else if (swt == 1)		/* Interval with Sparse */
+
+  if (Needs_List(range, range1, (PlLong) range->max - range1->min))
+    {
+      Range_Arith_List(range, range1, LIST_SUB);
+      return;
+    }
+
+  swt = (Is_Sparse(range) << 1) + Is_Sparse(range1);
+
+  if (swt == 1)		/* Interval with Sparse */
     Pl_Range_Becomes_Sparse(range);
   else if (swt == 2)		/* Sparse with Interval */
     {
@@ -1430,6 +2511,12 @@ Pl_Range_Mul_Range(Range *range, Range *range1)
       return;
     }
 
+  if (Needs_List(range, range1, (PlLong) range->max * range1->max))
+    {
+      Range_Arith_List(range, range1, LIST_MUL);
+      return;
+    }
+
   if (Is_Interval(range))
     Pl_Range_Becomes_Sparse(range);
 
@@ -1468,6 +2555,12 @@ Pl_Range_Div_Range(Range *range, Range *range1)
       return;
     }
 
+  if (Needs_List(range, range1, range->max))
+    {
+      Range_Arith_List(range, range1, LIST_DIV);
+      return;
+    }
+
   if (Is_Interval(range))
     Pl_Range_Becomes_Sparse(range);
 
@@ -1506,6 +2599,12 @@ Pl_Range_Mod_Range(Range *range, Range *range1)
       return;
     }
 
+  if (Needs_List(range, range1, range->max))
+    {
+      Range_Arith_List(range, range1, LIST_MOD);
+      return;
+    }
+
   if (Is_Interval(range))
     Pl_Range_Becomes_Sparse(range);
 
@@ -1544,6 +2643,12 @@ Pl_Range_Add_Value(Range *range, int n)
 
       return;
     }
+
+  if (Is_Interval_List(range) || range->max + n > pl_vec_max_integer)
+    {
+      Range_Arith_Value_List(range, n, LIST_ADD);
+      return;
+    }
   /* Sparse */
   Pl_Vector_Add_Value(range->vec, n);
 
@@ -1567,6 +2672,21 @@ Pl_Range_Mul_Value(Range *range, int n)
   if (n == 1 || Is_Empty(range))
     return;
 
+  if (Is_Interval_List(range) && n <= 0)	/* only 0 can remain */
+    {
+      if (n == 0 || range->min == 0)
+	Range_Init_Interval(range, 0, 0);
+      else
+	Set_To_Empty(range);
+      return;
+    }
+
+  if (Is_Interval_List(range) || (n > 0 && (PlLong) range->max * n > pl_vec_max_integer))
+    {
+      Range_Arith_Value_List(range, n, LIST_MUL);
+      return;
+    }
+
   if (Is_Interval(range))	/* Interval */
     Pl_Range_Becomes_Sparse(range);
   /* Sparse */
@@ -1593,6 +2713,21 @@ Pl_Range_Div_Value(Range *range, int n)
   if (n == 1 || Is_Empty(range))
     return;
 
+  if (Is_Interval_List(range) && n <= 0)	/* only 0 can remain */
+    {
+      if (n < 0 && range->min == 0)
+	Range_Init_Interval(range, 0, 0);
+      else
+	Set_To_Empty(range);
+      return;
+    }
+
+  if (Is_Interval_List(range) || (n > 0 && range->max > pl_vec_max_integer))
+    {
+      Range_Arith_Value_List(range, n, LIST_DIV);
+      return;
+    }
+
   if (Is_Interval(range))	/* Interval */
     Pl_Range_Becomes_Sparse(range);
   /* Sparse */
@@ -1680,6 +2815,12 @@ Pl_Range_Mod_Value(Range *range, int n)
       range->max = math_min(range->max, n - 1);
       return;
     }
+
+  if (Is_Interval_List(range))
+    {
+      Range_Arith_Value_List(range, n, LIST_MOD);
+      return;
+    }
   /* Sparse */
   Pl_Vector_Mod_Value(range->vec, n);
 
@@ -1725,6 +2866,38 @@ Pl_Range_To_String(Range *range)
 
   strcpy(buff, WRITE_BEGIN_RANGE);
 
+  if (Is_Interval_List(range))
+    {
+      IntervalList list = Range_List(range);
+      int i, nb = List_Nb_Itv(list);
+      char *p = buff + strlen(buff);
+
+      for (i = 0; i < nb; i++)
+	{
+	  if (p - buff > (int) sizeof(buff) - 64)	/* keep room for the end */
+	    {
+	      strcpy(p, "...");
+	      p += 3;
+	      break;
+	    }
+	  if (List_Min(list, i) == List_Max(list, i))
+	    p += sprintf(p, "%d", List_Min(list, i));
+	  else
+	    p += sprintf(p, "%d%s%d", List_Min(list, i),
+			 WRITE_LIMITS_SEPARATOR, List_Max(list, i));
+	  strcpy(p, (i < nb - 1) ? WRITE_INTERVALS_SEPARATOR : WRITE_END_RANGE);
+	  p += strlen(p);
+	}
+
+      if (i < nb)
+	strcpy(p, WRITE_END_RANGE);
+
+      if (range->extra_cstr)
+	strcat(buff, WRITE_EXTRA_CSTR_SYMBOL);
+
+      return buff;
+    }
+
   VECTOR_BEGIN_ENUM(range->vec, vec_elem);
   if (limit1 == -1)
     limit1 = limit2 = vec_elem;
@@ -1757,3 +2930,17 @@ Pl_Range_To_String(Range *range)
 
   return buff;
 }
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_VECTOR_LEAST_BIT                                                     *
+ *                                                                         *
+ * Used by VECTOR_BEGIN_ENUM if the compiler has no builtin (word != 0).   *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Vector_Least_Bit(VecWord word)
+{
+  return Pl_Least_Significant_Bit(word);
+}
@@ -51,6 +51,8 @@ typedef PlULong VecWord;
 
 typedef VecWord *Vector;
 
+typedef int *IntervalList;	/* see Interval List Management Macros */
+
 typedef struct			/* Ranges are always handled through pointers */
 {
   Bool extra_cstr;
@@ -156,6 +158,10 @@ void Pl_Range_Set_Value(Range *range, int n);
 
 void Pl_Range_Reset_Value(Range *range, int n);
 
+int Pl_Range_List_Capacity(int nb);
+
+void Pl_Range_List_Reset_Value(Range *range, int n);
+
 void Pl_Range_Becomes_Sparse(Range *range);
 
 void Pl_Range_From_Vector(Range *range);
@@ -186,6 +192,8 @@ void Pl_Range_Mod_Value(Range *range, int n);
 
 char *Pl_Range_To_String(Range *range);
 
+int Pl_Vector_Least_Bit(VecWord word);
+
 
 
 
@@ -200,6 +208,17 @@ char *Pl_Range_To_String(Range *range);
 
 
 
+	  /* index of the least significant bit set (word != 0) */
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define Vector_Least_Bit(word)     __builtin_ctzll((unsigned long long) (word))
+#else
+#define Vector_Least_Bit(word)     Pl_Vector_Least_Bit(word)
+#endif
+
+
+
+
 #define Vector_Test_Value(vec, n)  ((vec[Word_No(n)] & ((VecWord) 1 << Bit_No(n))) != 0)
 
 
@@ -218,7 +237,7 @@ char *Pl_Range_To_String(Range *range);
 #define Vector_Allocate_If_Necessary(vec)	\
   do						\
     {						\
-      if (vec == NULL)				\
+      if (vec == NULL || Is_List_Vec(vec))	\
 	Vector_Allocate(vec);			\
     }						\
   while (0)
@@ -246,17 +265,18 @@ char *Pl_Range_To_String(Range *range);
 
 #define VECTOR_BEGIN_ENUM(vec, vec_elem)                              	  \
 {									  \
-  Vector enum_end = vec + pl_vec_size, enum_i = vec;			  \
-  int enum_j;								  \
+  Vector enum_vec = vec, enum_end = enum_vec + pl_vec_size;		  \
+  Vector enum_i = enum_vec;						  \
   VecWord enum_word;							  \
 									  \
-  vec_elem = 0;								  \
   do									  \
     {									  \
       enum_word = *enum_i;						  \
-      for (enum_j = 0; enum_j++ < WORD_SIZE; enum_word >>= 1, vec_elem++) \
+      while (enum_word)		/* only visit set bits */		  \
 	{								  \
-	  if (enum_word & 1)						  \
+	  vec_elem = Word_No_And_Bit_No(enum_i - enum_vec,		  \
+					Vector_Least_Bit(enum_word));	  \
+	  enum_word &= enum_word - 1;	/* reset the least bit */	  \
 	    {
 
 
@@ -270,12 +290,43 @@ char *Pl_Range_To_String(Range *range);
 
 
 
+/*---------------------------------*
+ * Interval List Management Macros *
+ *---------------------------------*/
+
+	  /* A sparse range whose values do not fit in a vector (i.e. max > *
+	   * pl_vec_max_integer) is stored as a list of intervals: an int   *
+	   * array allocated on RANGE_TOP_STACK containing the number of    *
+	   * intervals (>= 2) followed by the min and max of each interval  *
+	   * (sorted, disjoint and not adjacent). The vec field of the      *
+	   * range points to this array tagged with LIST_TAG. Lists are     *
+	   * never modified once built (each operation creates a new list)  *
+	   * except in place by Pl_Range_List_Reset_Value. The array has    *
+	   * room for a power of 2 of intervals (see List_Size) so that a   *
+	   * list can grow in place.                                        */
+
+#define LIST_TAG                   ((PlULong) 1)
+
+#define Is_List_Vec(vec)           (((PlULong) (vec) & LIST_TAG) != 0)
+
+#define List_Nb_Itv(list)          ((list)[0])
+#define List_Min(list, i)          ((list)[2 * (i) + 1])	/* 0 <= i < nb */
+#define List_Max(list, i)          ((list)[2 * (i) + 2])
+
+#define List_Size(nb)              (((2 * Pl_Range_List_Capacity(nb) + 1) *	\
+                                      sizeof(int) + sizeof(VecWord) - 1) /	\
+                                     sizeof(VecWord))
+
+
+
+
 /*---------------------------------*
  * Range Management Macros         *
  *---------------------------------*/
 
 #define Is_Interval(range)         ((range)->vec == NULL)
-#define Is_Sparse(range)           ((range)->vec != NULL)
+#define Is_Interval_List(range)    Is_List_Vec((range)->vec)
+#define Is_Sparse(range)           ((range)->vec != NULL && !Is_Interval_List(range))
 #define Is_Empty(range)            ((range)->min >  (range)->max)
 #define Is_Not_Empty(range)        ((range)->max >= (range)->min)
 
@@ -283,6 +334,12 @@ char *Pl_Range_To_String(Range *range);
 #define Set_To_Empty(range) (range)->max = (int)(1 << (sizeof(int) * 8 - 1))
 
 
+#define Range_List(range)          ((IntervalList) ((PlULong) (range)->vec - LIST_TAG))
+#define Range_Set_List(range, list)((range)->vec = (Vector) ((PlULong) (list) + LIST_TAG))
+#define Range_List_End(range)      ((Vector) Range_List(range) +	\
+                                    List_Size(List_Nb_Itv(Range_List(range))))
+
+
 #define Range_Init_Interval(range, r_min, r_max)	\
   do							\
     {							\
@@ -293,3 +350,22 @@ char *Pl_Range_To_String(Range *range);
     }							\
   while (0)
 
+
+
+
+	  /* To enumerate any range (vector or list) use RANGE_BEGIN_ENUM / *
+	   * RANGE_END_ENUM (same usage as VECTOR_BEGIN_ENUM).              */
+
+#define RANGE_BEGIN_ENUM(range, elem)					  \
+{									  \
+  Range *enum_range = (range);						  \
+									  \
+  for (elem = Is_Empty(enum_range) ? -1 : enum_range->min; elem >= 0;	  \
+       elem = Pl_Range_Next_After(enum_range, elem))			  \
+    {
+
+
+#define RANGE_END_ENUM							\
+    }									\
+}
+
@@ -241,6 +241,12 @@
 
 
 
+#define fd_cf_idempotent				\
+  Pl_Fd_Idempotent_Constraint(CF);
+
+
+
+
 #define fd_add_dependency(fv, ch)				\
   Pl_Fd_Add_Dependency(Frame_Variable(fv), chain_##ch, CF);
 
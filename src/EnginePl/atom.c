@@ -209,6 +209,27 @@ Pl_Create_Allocate_Atom(char *name)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_CREATE_ATOM_FROM_BUFFER                                              *
+ *                                                                         *
+ * name is a mallocated buffer of len chars (ending with '\0'). If the atom*
+ * is new, the buffer itself becomes its name (*adopted = TRUE), else the  *
+ * buffer still belongs to the caller (*adopted = FALSE).                  *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Create_Atom_From_Buffer(char *name, int len, Bool *adopted)
+{
+  unsigned hash = Hash_String(name, len);
+  AtomInf *patom = Locate_Atom(name, hash);
+
+  *adopted = (patom != NULL && patom->name == NULL);
+
+  return Add_Atom(name, len, hash, patom, FALSE);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_CREATE_ATOM                                                          *
  *                                                                         *
@@ -96,7 +96,7 @@
 
 typedef struct			/* Atom properties                */
 {				/* ------------------------------ */
-  unsigned length:16;		/* its length (in characters)     */
+  int length;			/* its length (in characters)     */
   unsigned op_mask:4;		/* operator defined for the atom  */
   unsigned type:2;		/* IDENTIFIER GRAPHIC SOLO OTHER  */
   unsigned needs_quote:1;	/* needs ' around it ?            */
@@ -186,6 +186,8 @@ void Pl_Init_Atom(void);
 
 int Pl_Create_Allocate_Atom(char *name);
 
+int Pl_Create_Atom_From_Buffer(char *name, int len, Bool *adopted);
+
 int Pl_Create_Atom(char *name);
 
 WamWord FC Pl_Create_Atom_Tagged(char *name);
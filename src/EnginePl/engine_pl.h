@@ -53,4 +53,5 @@
 #include "stacks_sigsegv.h"
 #include "obj_chain.h"
 #include "wam_inst.h"
+#include "fact_table.h"
 #include "if_no_fd.h"
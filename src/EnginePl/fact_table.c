@@ -0,0 +1,352 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog engine                                                   *
+ * File  : fact_table.c                                                    *
+ * Descr.: fact tables (compiled ground facts)                             *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "engine_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct
+{
+  PlLong key;			/* the (tagged) atom or integer */
+  int start;			/* first position in the tuple array */
+  int nb;			/* number of tuples having this key */
+}
+FactKey;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static FactIndex *Fact_Table_Index(FactTbl *ft, int i);
+
+static int Fact_Table_Next(FactTbl *ft, int *tuple, int j, int nb);
+
+static Bool Fact_Table_Unify(FactTbl *ft, int t);
+
+
+
+#define Is_A_Variable(tag_mask)    (tag_mask == TAG_REF_MASK || tag_mask == TAG_FDV_MASK)
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A predicate made of many ground facts (whose arguments are atoms or     *
+ * integers) is compiled by pl2wam as a fact table instead of WAM code.    *
+ * The values are stored column by column (all 1st args, then all 2nd     *
+ * args,...) and loaded at initialization time from strings emitted by     *
+ * wam2ma (see Pl_Fact_Table_Load).                                        *
+ * At run-time, the bound arguments of a call are used to select the       *
+ * candidate tuples: for each such argument an index (hash table mapping a *
+ * value to the tuples containing it, in clause order) is built the first  *
+ * time it is needed and the argument with the smallest set of candidates  *
+ * is chosen. A choice-point is only created if another tuple matches.     *
+ * It records the args, the candidate array, its size and the position of  *
+ * the next matching tuple (FACT_TABLE_EXTRA_ARGS extra words).            *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_TABLE_CREATE                                                    *
+ *                                                                         *
+ * Called by compiled prolog code.                                         *
+ *-------------------------------------------------------------------------*/
+FactTbl * FC
+Pl_Fact_Table_Create(int arity, int nb_tuple, PlLong *atom_tbl)
+{
+  FactTbl *ft;
+
+  ft = (FactTbl *) Malloc(sizeof(FactTbl));
+  ft->arity = arity;
+  ft->nb_tuple = nb_tuple;
+  ft->nb_loaded = 0;
+  ft->atom_tbl = atom_tbl;
+  ft->col = (WamWord *) Malloc(sizeof(WamWord) * arity * nb_tuple);
+  ft->index = (FactIndex *) Calloc(arity, sizeof(FactIndex));
+
+  return ft;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_TABLE_LOAD                                                      *
+ *                                                                         *
+ * str is a sequence of values separated by a comma. A value is either     *
+ * aNNN (NNN is the no of the atom in the atom table of the object) or     *
+ * iNNN (NNN is an integer).                                               *
+ *                                                                         *
+ * Called by compiled prolog code.                                         *
+ *-------------------------------------------------------------------------*/
+void FC
+Pl_Fact_Table_Load(FactTbl *ft, char *str)
+{
+  WamWord *p = ft->col + ft->nb_loaded;
+  WamWord *end = ft->col + ft->arity * ft->nb_tuple;
+  char type;
+  PlLong n;
+
+  while (*str && p < end)
+    {
+      type = *str++;
+      n = Str_To_PlLong(str, &str, 10);
+      if (*str == ',')
+	str++;
+
+      *p++ = (type == 'a') ? Tag_ATM((int) ft->atom_tbl[n]) : Tag_INT(n);
+    }
+
+  ft->nb_loaded = p - ft->col;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FACT_TABLE_INDEX                                                        *
+ *                                                                         *
+ * Return the index associated to the ith arg (create it if needed).       *
+ *-------------------------------------------------------------------------*/
+static FactIndex *
+Fact_Table_Index(FactTbl *ft, int i)
+{
+  FactIndex *index = ft->index + i;
+  WamWord *col;
+  FactKey key, *k;
+  HashScan scan;
+  int nb_tuple, start, t;
+
+  if (index->key_tbl != NULL)
+    return index;
+
+  nb_tuple = ft->nb_tuple;
+  col = ft->col + i * nb_tuple;
+				/* odd size since keys are tagged words */
+  index->key_tbl = Pl_Hash_Alloc_Table(nb_tuple | 1, sizeof(FactKey));
+
+  key.start = 0;
+  key.nb = 0;
+  for (t = 0; t < nb_tuple; t++)	/* count the tuples of each key */
+    {
+      key.key = col[t];
+      k = (FactKey *) Pl_Hash_Insert(index->key_tbl, (char *) &key, FALSE);
+      k->nb++;
+    }
+
+  start = 0;
+  for (k = (FactKey *) Pl_Hash_First(index->key_tbl, &scan); k;
+       k = (FactKey *) Pl_Hash_Next(&scan))
+    {
+      k->start = start;
+      start += k->nb;
+      k->nb = 0;
+    }
+
+  index->tuple = (int *) Malloc(sizeof(int) * nb_tuple);
+  for (t = 0; t < nb_tuple; t++)	/* group tuples by key keeping their order */
+    {
+      k = (FactKey *) Pl_Hash_Find(index->key_tbl, col[t]);
+      index->tuple[k->start + k->nb++] = t;
+    }
+
+  return index;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_TABLE_CALL                                                      *
+ *                                                                         *
+ * Called by compiled prolog code (the whole code of the predicate).       *
+ *-------------------------------------------------------------------------*/
+Bool FC
+Pl_Fact_Table_Call(FactTbl *ft, CodePtr codep_alt)
+{
+  int arity = ft->arity;
+  WamWord word, tag_mask;
+  FactIndex *index;
+  FactKey *k, *best = NULL;
+  int *tuple = NULL;		/* NULL: all tuples are candidates */
+  int nb = ft->nb_tuple;
+  int i, j, j1;
+
+  for (i = 0; i < arity; i++)
+    {
+      DEREF(A(i), word, tag_mask);
+      A(i) = word;
+      if (Is_A_Variable(tag_mask))
+	continue;
+
+      if (tag_mask != TAG_ATM_MASK && tag_mask != TAG_INT_MASK)
+	return FALSE;
+
+      index = Fact_Table_Index(ft, i);
+      k = (FactKey *) Pl_Hash_Find(index->key_tbl, word);
+      if (k == NULL)
+	return FALSE;
+
+      if (best == NULL || k->nb < best->nb)
+	{
+	  best = k;
+	  tuple = index->tuple + k->start;
+	  nb = k->nb;
+	}
+    }
+
+  j = Fact_Table_Next(ft, tuple, 0, nb);
+  if (j == nb)
+    return FALSE;
+
+  j1 = Fact_Table_Next(ft, tuple, j + 1, nb);
+  if (j1 < nb)
+    {
+      A(arity) = (WamWord) tuple;
+      A(arity + 1) = nb;
+      A(arity + 2) = j1;
+      Pl_Create_Choice_Point(codep_alt, arity + FACT_TABLE_EXTRA_ARGS);
+    }
+
+  return Fact_Table_Unify(ft, (tuple) ? tuple[j] : j);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FACT_TABLE_RETRY                                                     *
+ *                                                                         *
+ * Called by compiled prolog code (on backtracking).                       *
+ *-------------------------------------------------------------------------*/
+Bool FC
+Pl_Fact_Table_Retry(FactTbl *ft)
+{
+  int arity = ft->arity;
+  int *tuple;
+  int nb, j, j1;
+
+  Pl_Update_Choice_Point(ALTB(B), arity + FACT_TABLE_EXTRA_ARGS);
+
+  tuple = (int *) A(arity);
+  nb = A(arity + 1);
+  j = A(arity + 2);
+
+  j1 = Fact_Table_Next(ft, tuple, j + 1, nb);
+  if (j1 < nb)
+    AB(B, arity + 2) = j1;
+  else
+    Delete_Last_Choice_Point();
+
+  return Fact_Table_Unify(ft, (tuple) ? tuple[j] : j);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FACT_TABLE_NEXT                                                         *
+ *                                                                         *
+ * Return the position (>= j) of the next candidate matching the bound     *
+ * args (in A(i), dereferenced) or nb if none.                             *
+ *-------------------------------------------------------------------------*/
+static int
+Fact_Table_Next(FactTbl *ft, int *tuple, int j, int nb)
+{
+  int arity = ft->arity;
+  int nb_tuple = ft->nb_tuple;
+  WamWord *col;
+  int i, t;
+
+  for (; j < nb; j++)
+    {
+      t = (tuple) ? tuple[j] : j;
+      for (i = 0, col = ft->col + t; i < arity; i++, col += nb_tuple)
+	if (!Is_A_Variable(Tag_Mask_Of(A(i))) && *col != A(i))
+	  break;
+
+      if (i == arity)
+	break;
+    }
+
+  return j;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FACT_TABLE_UNIFY                                                        *
+ *                                                                         *
+ * Unify the unbound args with the values of the tuple t.                  *
+ *-------------------------------------------------------------------------*/
+static Bool
+Fact_Table_Unify(FactTbl *ft, int t)
+{
+  int arity = ft->arity;
+  int nb_tuple = ft->nb_tuple;
+  WamWord *col;
+  int i;
+
+  for (i = 0, col = ft->col + t; i < arity; i++, col += nb_tuple)
+    if (Is_A_Variable(Tag_Mask_Of(A(i))) && !Pl_Unify(*col, A(i)))
+      return FALSE;
+
+  return TRUE;
+}
@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog engine                                                   *
+ * File  : fact_table.h                                                    *
+ * Descr.: fact tables (compiled ground facts) - header file               *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define FACT_TABLE_EXTRA_ARGS      3 /* words saved in the choice-point */
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct
+{
+  char *key_tbl;		/* hash table: value -> FactKey */
+  int *tuple;			/* tuple nos grouped by key (clause order) */
+}
+FactIndex;
+
+
+typedef struct
+{
+  int arity;			/* arity of the predicate */
+  int nb_tuple;			/* number of tuples (i.e. facts) */
+  int nb_loaded;		/* number of values already loaded */
+  PlLong *atom_tbl;		/* atom table of the object (at(...)) */
+  WamWord *col;			/* col[i * nb_tuple + t]: arg i of tuple t */
+  FactIndex *index;		/* one index per arg (created when needed) */
+}
+FactTbl;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+FactTbl * FC Pl_Fact_Table_Create(int arity, int nb_tuple, PlLong *atom_tbl);
+
+void FC Pl_Fact_Table_Load(FactTbl *ft, char *str);
+
+Bool FC Pl_Fact_Table_Call(FactTbl *ft, CodePtr codep_alt);
+
+Bool FC Pl_Fact_Table_Retry(FactTbl *ft);
@@ -195,6 +195,7 @@ extern int pl_representation_max_arity;
 extern int pl_representation_max_integer;
 extern int pl_representation_min_integer;
 extern int pl_representation_too_many_variables;
+extern int pl_representation_cyclic_term;
 
 extern int pl_evluation_float_overflow;
 extern int pl_evluation_int_overflow;
@@ -205,6 +206,8 @@ extern int pl_evluation_zero_divisor;
 
 extern int pl_resource_print_object_not_linked;
 extern int pl_resource_too_big_fd_constraint;
+extern int pl_resource_too_many_variables;
+extern int pl_resource_too_big_term;
 
 
 
@@ -667,6 +670,16 @@ char *Pl_Display_To_String(PlTerm term);
 
 PlTerm Pl_Read_From_String(const char *str);
 
+int Pl_Write_To_Buffer(PlTerm term, char *buff, int size);
+
+int Pl_Writeq_To_Buffer(PlTerm term, char *buff, int size);
+
+int Pl_Write_Canonical_To_Buffer(PlTerm term, char *buff, int size);
+
+int Pl_Display_To_Buffer(PlTerm term, char *buff, int size);
+
+PlTerm Pl_Read_From_Buffer(const char *buff, int size);
+
 
 
 
@@ -816,6 +829,7 @@ typedef PlFIOArg FIOArg;
 #define representation_max_integer pl_representation_max_integer
 #define representation_min_integer pl_representation_min_integer
 #define representation_too_many_variables pl_representation_too_many_variables
+#define representation_cyclic_term pl_representation_cyclic_term
 
 #define evluation_float_overflow pl_evluation_float_overflow
 #define evluation_int_overflow pl_evluation_int_overflow
@@ -826,6 +840,8 @@ typedef PlFIOArg FIOArg;
 
 #define resource_print_object_not_linked pl_resource_print_object_not_linked
 #define resource_too_big_fd_constraint pl_resource_too_big_fd_constraint
+#define resource_too_many_variables pl_resource_too_many_variables
+#define resource_too_big_term pl_resource_too_big_term
 
 
 
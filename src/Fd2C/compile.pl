@@ -121,7 +121,7 @@ e_body(by(LBloc, WaitSwt), LFctName1) :-
 	e_bloc_lst(LBloc, LFctName),
 	(   WaitSwt = ws(LUse, LCase) ->
 	    e_wait_swt(LUse, LCase, FctName1),
-	    e_fct_install_triggers(-1, LUse, -1, always, FctName1, FctName),
+	    e_fct_install_triggers(-1, LUse, -1, always, not_idempotent, FctName1, FctName),
 	    append(LFctName, [FctName], LFctName1)
 	;   LFctName1 = LFctName
 	).
@@ -198,9 +198,9 @@ e_bloc_lst([Bloc|LBloc], [FctName|LFctName]) :-
 
 
 
-e_bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always), FctName1) :-
+e_bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always, Idem), FctName1) :-
 	e_bloc(LUse, LWInst, FctName),
-	e_fct_install_triggers(BNo, LDep, TellFdv, Always, FctName, FctName1).
+	e_fct_install_triggers(BNo, LDep, TellFdv, Always, Idem, FctName, FctName1).
 
 
 
@@ -218,7 +218,7 @@ e_bloc(LUse, LWInst1, FctName) :-
 
 
 
-e_fct_install_triggers(BNo, LDep, TellFdv, Always, FctName, FctName1) :-
+e_fct_install_triggers(BNo, LDep, TellFdv, Always, Idem, FctName, FctName1) :-
 	e_has_dependencies(LDep), !,
 	(   Always = always ->
 	    Optim = 0
@@ -228,6 +228,10 @@ e_fct_install_triggers(BNo, LDep, TellFdv, Always, FctName, FctName1) :-
 	format(stream_c, '~nfd_begin_internal(~a)~n~n', [FctName1]),
 	format(stream_c, '   fd_local_cf_pointer~n', []),
 	format(stream_c, '   fd_create_c_frame(~a,~d,~d)~n', [FctName, TellFdv, Optim]),
+	(   Idem = idempotent ->
+	    format(stream_c, '   fd_cf_idempotent~n', [])
+	;   true
+	),
 	(   BNo = -1 ->
 	    true
 	;   format(stream_c, '   fd_cf_in_a_frame(~d)~n', [BNo])
@@ -238,7 +242,7 @@ e_fct_install_triggers(BNo, LDep, TellFdv, Always, FctName, FctName1) :-
 	format(stream_c, '   fd_return~n', []),
 	format(stream_c, '~nfd_end_internal~n', []).
 
-e_fct_install_triggers(_, _, _, _, FctName, FctName).
+e_fct_install_triggers(_, _, _, _, _, FctName, FctName).
 
 
 
@@ -398,10 +402,13 @@ simplif_code([fd_tell_interval(I, T1, T2)|LWInst], LWSimpl) :-
 	T1 == T2, !,
 	simplif_code([fd_tell_value(I, T1)|LWInst], LWSimpl).
 
-simplif_code([fd_range_full(R1), fd_range_reset_value(R2, T), fd_tell_range(I, R3)|LWInst], LWSimpl) :-
-	R1 == R2,
+simplif_code([fd_range_full(R1), fd_range_reset_value(R2, T)|LWInst], LWSimpl) :-
+	R1 == R2,                          % X in ~{T,...} = X #\= T, ...
+	simpl_get_not_values(LWInst, R1, LT, [fd_tell_range(I, R3)|LWInst1]),
 	R1 == R3, !,
-	simplif_code([fd_tell_not_value(I, T)|LWInst], LWSimpl).
+	simpl_tell_not_values([T|LT], I, LWTell),
+	append(LWTell, LWInst1, LWInst2),
+	simplif_code(LWInst2, LWSimpl).
 
 simplif_code([fd_range_empty(R1)|LWInst], LWSimpl1) :-
 	simpl_get_lst(LWInst, R1, LWReset, LWInst1),
@@ -439,6 +446,23 @@ simpl_get_lst(LWInst, _, [], LWInst).
 
 
 
+simpl_get_not_values([fd_range_reset_value(R2, T)|LWInst], R1, [T|LT], LWInst1) :-
+	R1 == R2, !,
+	simpl_get_not_values(LWInst, R1, LT, LWInst1).
+
+simpl_get_not_values(LWInst, _, [], LWInst).
+
+
+
+
+simpl_tell_not_values([], _, []).
+
+simpl_tell_not_values([T|LT], I, [fd_tell_not_value(I, T)|LWTell]) :-
+	simpl_tell_not_values(LT, I, LWTell).
+
+
+
+
 internal_fct_name(Kind, No, FctName) :-
 	g_read(name, Name),
 	number_atom(No, ANo),
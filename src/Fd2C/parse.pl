@@ -176,7 +176,7 @@ bloc_lst([]) -->
 
 
 
-bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always)) -->
+bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always, Idem)) -->
 	{ clause(hvar(LVar), _) },
 	foreach(LVar, LUse, LWInst1, LWInst, HasForEach),
 	terminal(start),
@@ -196,6 +196,7 @@ bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always)) -->
 	},
 	trig(LVar, LUse, LDep),
 	always(Always),
+	idempotent(Idem),
 	{ close_list(LDep), close_list(LUse) }.
 
 
@@ -280,6 +281,15 @@ always(optimized) -->
 
 
 
+idempotent(idempotent) -->
+	terminal(idempotent), !.
+
+idempotent(not_idempotent) -->
+	[].
+
+
+
+
 elem_lst(LVar, LUse, LWNext, LWInst) -->
 	elem_one(LVar, LUse, LWInst1, LWInst),
 	elem_lst(LVar, LUse, LWNext, LWInst1).
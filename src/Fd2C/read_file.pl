@@ -189,6 +189,7 @@ keyword(trigger).
 keyword(also).
 keyword(on).
 keyword(always).
+keyword(idempotent).
 keyword(fail).
 keyword(exit).
 keyword(if).
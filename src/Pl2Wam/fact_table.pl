@@ -0,0 +1,135 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog to WAM compiler                                          *
+ * File  : fact_table.pl                                                   *
+ * Descr.: compilation of ground fact tables                               *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2021 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------------*
+ * A static predicate whose clauses are all facts with atomic arguments    *
+ * (atoms or integers) and which has at least fact_table_min clauses is    *
+ * not compiled clause by clause (no try/retry chains, no switch tables).  *
+ * It gives rise to a table of values handled at run-time by the engine:   *
+ *                                                                         *
+ *   fact_table(NbTuple)                                                   *
+ *   fact_table_data([V,...])                                              *
+ *        :                                                                *
+ *   fact_table_data([V,...])                                              *
+ *                                                                         *
+ * The values are given column by column (all 1st args, then all 2nd args *
+ * ...) and split into chunks of at most 1024 values. The engine builds an *
+ * index on any argument the first time it is called with this argument   *
+ * bound (see EnginePl/fact_table.c).                                      *
+ *-------------------------------------------------------------------------*/
+
+fact_table_code(Pred, N, LSrcCl, [fact_table(NbTuple)|LChunk]) :-
+	g_read(fact_table_min, Min),
+	Min > 0,
+	N > 0,
+	N =< 252,                 % 3 extra words are saved in the choice-point
+	\+ test_pred_info(dyn, Pred, N),
+	\+ test_pred_info(multi, Pred, N),
+	length(LSrcCl, NbTuple),
+	NbTuple >= Min,
+	fact_table_heads(LSrcCl, Pred, N, LHead),
+	fact_table_columns(0, N, LHead, LValue),
+	fact_table_chunks(LValue, LChunk).
+
+
+
+
+fact_table_heads([], _, _, []).
+
+fact_table_heads([_ + Head|LSrcCl], Pred, N, [Head|LHead]) :-
+	functor(Head, Pred, N),
+	Head \= (_ :- _),
+	fact_table_atomic_args(N, Head), !,
+	fact_table_heads(LSrcCl, Pred, N, LHead).
+
+
+
+
+fact_table_atomic_args(0, _) :-
+	!.
+
+fact_table_atomic_args(I, Head) :-
+	arg(I, Head, A),
+	(   atom(A)
+	;   integer(A)
+	), !,
+	I1 is I - 1,
+	fact_table_atomic_args(I1, Head).
+
+
+
+
+fact_table_columns(N, N, _, []) :-
+	!.
+
+fact_table_columns(I, N, LHead, LValue) :-
+	I1 is I + 1,
+	fact_table_column(LHead, I1, LValue, LValue1),
+	fact_table_columns(I1, N, LHead, LValue1).
+
+
+
+
+fact_table_column([], _, LValue, LValue).
+
+fact_table_column([Head|LHead], I, [V|LValue], LValue1) :-
+	arg(I, Head, V),
+	fact_table_column(LHead, I, LValue, LValue1).
+
+
+
+
+fact_table_chunks([], []) :-
+	!.
+
+fact_table_chunks(LValue, [fact_table_data(LChunk)|LWam]) :-
+	fact_table_chunk(1024, LValue, LChunk, LValue1),
+	fact_table_chunks(LValue1, LWam).
+
+
+
+
+fact_table_chunk(0, LValue, [], LValue) :-
+	!.
+
+fact_table_chunk(_, [], [], []) :-
+	!.
+
+fact_table_chunk(K, [V|LValue], [V|LChunk], LValue1) :-
+	K1 is K - 1,
+	fact_table_chunk(K1, LValue, LChunk, LValue1).
@@ -81,9 +81,12 @@ pl2wam1(LArg) :-
 
 compile_and_emit_pred(t, Pred, N, LSrcCl) :-
 	compile_emit_inits(Pred, N, LSrcCl, PlFile, PlLine),
-	compile_lst_clause(LSrcCl, LCompCl),
-	indexing(LCompCl, WamCode),
-	add_counter(user_indexing, real_indexing),
+	(   fact_table_code(Pred, N, LSrcCl, WamCode) ->
+	    true
+	;   compile_lst_clause(LSrcCl, LCompCl),
+	    indexing(LCompCl, WamCode),
+	    add_counter(user_indexing, real_indexing)
+	),
 	emit_code(Pred, N, PlFile, PlLine, WamCode),
 	add_counter(user_wam_emit, real_wam_emit).
 
@@ -283,6 +286,7 @@ cmd_line_args(LArg, PlFile, WamFile) :-
 	g_assign(opt_last_subterm, t),
 	g_assign(keep_void_inst, f),
 	g_assign(fast_math, f),
+	g_assign(fact_table_min, 1000),
 	g_assign(statistics, f),
 	g_assign(compile_msg, f),
 	cmd_line_args(LArg),
@@ -379,6 +383,16 @@ cmd_line_arg1('--no-opt-last-subterm', LArg, LArg) :-
 cmd_line_arg1('--fast-math', LArg, LArg) :-
 	g_assign(fast_math, t).
 
+cmd_line_arg1('--fact-table-min', LArg, LArg1) :-
+	(   LArg = [Arg|LArg1],
+	    catch(number_atom(Min, Arg), _, fail),
+	    integer(Min),
+	    Min >= 0
+	;   format('N missing or invalid after --fact-table-min option~n', []),
+	    abort
+	),
+	g_assign(fact_table_min, Min).
+
 cmd_line_arg1('--keep-void-inst', LArg, LArg) :-
 	g_assign(keep_void_inst, t).
 
@@ -477,6 +491,7 @@ h('  --no-reg-opt                do not optimize registers').
 h('  --min-reg-opt               minimally optimize registers').
 h('  --no-opt-last-subterm       do not optimize last subterm compilation').
 h('  --fast-math                 fast mathematical mode (assume integer arithmetics)').
+h('  --fact-table-min N          compile ground facts as a table from N clauses (0: never)').
 h('  --keep-void-inst            keep void instructions in the output file').
 h('  --compile-msg               print a compile message').
 h('  --statistics                print statistics information').
@@ -89,6 +89,9 @@
  *   F=FctName, T0=Return, P/N=BipName/BipArity, K=ChcSize                 *
  *   Mi=mode (in/out/in_out), Ti=type                                      *
  *                                                                         *
+ * fact_table(N)              (whole code of a predicate with N facts)     *
+ * fact_table_data([W,...])   (values of a fact table, column by column)   *
+ *                                                                         *
  * V      : x(X) or y(Y)                                                   *
  * X, Y   : integer >= 0                                                   *
  * A      : integer                                                        *
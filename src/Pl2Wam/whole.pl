@@ -8,5 +8,6 @@
 :-	include(inst_codif).
 :-	include(first_arg).
 :-	include(indexing).
+:-	include(fact_table).
 :-	include(wam_emit).
 :-	include(pl2wam).
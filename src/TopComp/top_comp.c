@@ -1170,6 +1170,17 @@ Parse_Arguments(int argc, char *argv[])
 	      continue;
 	    }
 
+	  if (Check_Arg(i, "--fact-table-min"))
+	    {
+	      if (++i >= argc)
+		Pl_Fatal_Error("N missing after %s option", last_opt);
+
+	      Add_Last_Option(cmd_pl2wam.opt);
+	      last_opt = argv[i];
+	      Add_Last_Option(cmd_pl2wam.opt);
+	      continue;
+	    }
+
 	  if (Check_Arg(i, "--no-susp-warn") ||
 	      Check_Arg(i, "--no-singl-warn") ||
 	      Check_Arg(i, "--no-redef-error") ||
@@ -1525,6 +1536,7 @@ Display_Help(void)
   L("  --min-reg-opt               minimally optimize registers");
   L("  --no-opt-last-subterm       do not optimize last subterm compilation");
   L("  --fast-math                 fast mathematical mode (assume integer arithmetics)");
+  L("  --fact-table-min N          compile ground facts as a table from N clauses (0: never)");
   L("  --keep-void-inst            keep void instructions in the output file");
   L("  --compile-msg               print a compile message");
   L("  --statistics                print statistics information");
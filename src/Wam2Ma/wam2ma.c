@@ -85,6 +85,7 @@
 #define MAX_PRED_NAME_LENGTH       2048
 #define MAX_HEXA_LENGTH            MAX_PRED_NAME_LENGTH * 2 + 2 + 16
 #define MAX_LABEL_LENGTH           32
+#define MAX_FACT_TABLE_STR         8192
 
 
 #define ANY_SIZE                   1
@@ -150,6 +151,27 @@ SwtTbl;
 
 
 
+typedef struct fact_elt
+{
+  BTNode *atom;			/* NULL for an integer */
+  PlLong n;
+}
+FactElt;
+
+
+
+
+typedef struct fact_tbl
+{
+  int tbl_no;			/* sequential no of the table */
+  int nb_tuple;			/* number of tuples (facts) */
+  int nb_elem;			/* number of values read so far */
+  FactElt *elem;		/* values (column by column) */
+}
+FactTbl;
+
+
+
 typedef struct predinf *PredP;
 
 typedef struct predinf
@@ -163,6 +185,7 @@ typedef struct predinf
   BTNode *pl_file;
   int pl_line;
   SwtTbl *swt_tbl[3];
+  FactTbl *fact_tbl;
   PredP next;
 }
 Pred;
@@ -208,6 +231,8 @@ Direct *direct_end = &dummy_direct_start;
 
 int nb_swt_tbl = 0;
 
+int nb_fact_tbl = 0;
+
 Pred *cur_pred;
 int cur_pred_no = 0;
 int cur_arity;
@@ -228,6 +253,8 @@ SwtTbl *Create_Switch_Table(int type, int nb_elem);
 
 void Init_Foreign_Table(void);
 
+void Emit_Fact_Table(FactTbl *t, int arity);
+
 
 void Emit_Obj_Initializer(void);
 
@@ -562,6 +589,7 @@ F_predicate(ArgVal arg[])
   cur_pred->swt_tbl[0] = NULL;
   cur_pred->swt_tbl[1] = NULL;
   cur_pred->swt_tbl[2] = NULL;
+  cur_pred->fact_tbl = NULL;
   cur_pred->next = NULL;
 
   pred_end->next = cur_pred;
@@ -2013,6 +2041,94 @@ F_foreign_call_c(ArgVal arg[])
 
 
 
+/*-------------------------------------------------------------------------*
+ * F_FACT_TABLE                                                            *
+ *                                                                         *
+ * The whole code of a predicate compiled as a fact table (the values are  *
+ * given by the following fact_table_data instructions).                   *
+ *-------------------------------------------------------------------------*/
+void
+F_fact_table(ArgVal arg[])
+{
+  FactTbl *t;
+  char sl[MAX_LABEL_LENGTH];
+
+  Args1(INTEGER(nb_tuple));
+
+  t = (FactTbl *) malloc(sizeof(FactTbl));
+  if (t != NULL)
+    t->elem = (FactElt *) malloc(sizeof(FactElt) * (nb_tuple * cur_arity + 1));
+  if (t == NULL || t->elem == NULL)
+    {
+      fprintf(stderr, "Cannot allocate memory for fact table\n");
+      exit(1);
+    }
+
+  t->tbl_no = nb_fact_tbl++;
+  t->nb_tuple = nb_tuple;
+  t->nb_elem = 0;
+
+  cur_pred->fact_tbl = t;
+
+  sprintf(sl, FORMAT_SUB_LABEL(cur_sub_label++));
+
+  Inst_Printf("call_c", FAST "Pl_Fact_Table_Call(ft(%d),&%s)", t->tbl_no, sl);
+  Inst_Printf("fail_ret", "");
+  Inst_Printf("pl_ret", "");
+
+  Label_Printf("%s:", sl);
+  Inst_Printf("call_c", FAST "Pl_Fact_Table_Retry(ft(%d))", t->tbl_no);
+  Inst_Printf("fail_ret", "");
+  Inst_Printf("pl_ret", "");
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * F_FACT_TABLE_DATA                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+F_fact_table_data(ArgVal arg[])
+{
+  FactTbl *t = cur_pred->fact_tbl;
+  FactElt *elem;
+
+  DEF_INTEGER(arg_type);
+  DEF_ATOM(atom);
+  DEF_INTEGER(n);
+  Args1(INTEGER(nb_elem));
+
+  if (t == NULL)
+    Syntax_Error("fact_table expected before fact_table_data");
+
+  if (t->nb_elem + nb_elem > t->nb_tuple * cur_arity)
+    Syntax_Error("too many values in fact table");
+
+  for (elem = t->elem + t->nb_elem; nb_elem--; elem++)
+    {
+      LOAD_INTEGER(arg_type);
+      if (arg_type == INTEGER)
+	{
+	  LOAD_INTEGER(n);
+	  elem->atom = NULL;
+	  elem->n = n;
+	}
+      else if (arg_type == ATOM)
+	{
+	  LOAD_ATOM_0(atom);
+	  elem->atom = atom;
+	}
+      else
+	Syntax_Error("atom or integer expected in fact table");
+      t->nb_elem++;
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * EMIT_OBJ_INITIALIZER                                                    *
  *                                                                         *
@@ -2040,6 +2156,9 @@ Emit_Obj_Initializer(void)
   if (nb_swt_tbl)
     Label_Printf("long local st(%d)", nb_swt_tbl);
 
+  if (nb_fact_tbl)
+    Label_Printf("long local ft(%d)", nb_fact_tbl);
+
   Label_Printf("\n");
 
   Label_Printf("c_code  initializer Object_Initializer\n");
@@ -2119,6 +2238,9 @@ Emit_Obj_Initializer(void)
 		  }
 	      }
 	  }
+
+      if (p->fact_tbl)
+	Emit_Fact_Table(p->fact_tbl, p->arity);
     }
 
   Inst_Printf("c_ret", "");
@@ -2127,6 +2249,48 @@ Emit_Obj_Initializer(void)
 
 
 
+/*-------------------------------------------------------------------------*
+ * EMIT_FACT_TABLE                                                         *
+ *                                                                         *
+ * The values are passed as strings (see EnginePl/fact_table.c), cut into  *
+ * pieces of at most MAX_FACT_TABLE_STR chars.                             *
+ *-------------------------------------------------------------------------*/
+void
+Emit_Fact_Table(FactTbl *t, int arity)
+{
+  static char buff[MAX_FACT_TABLE_STR + 64];
+  char *q = buff;
+  FactElt *elem, *end;
+
+  if (t->nb_elem != t->nb_tuple * arity)
+    {
+      fprintf(stderr, "Incomplete fact table #%d (%d values instead of %d)\n",
+	      t->tbl_no, t->nb_elem, t->nb_tuple * arity);
+      exit(1);
+    }
+
+  Inst_Printf("call_c", FAST "Pl_Fact_Table_Create(%d,%d,&at(0))", arity, t->nb_tuple);
+  Inst_Printf("move_ret", "ft(%d)", t->tbl_no);
+
+  end = t->elem + t->nb_elem;
+  for (elem = t->elem; elem < end; elem++)
+    {
+      if (elem->atom)
+	q += sprintf(q, "a%d,", elem->atom->no);
+      else
+	q += sprintf(q, "i%" PL_FMT_d ",", elem->n);
+
+      if (q - buff >= MAX_FACT_TABLE_STR || elem == end - 1)
+	{
+	  Inst_Printf("call_c", FAST "Pl_Fact_Table_Load(ft(%d),\"%s\")", t->tbl_no, buff);
+	  q = buff;
+	}
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * EMIT_EXEC_DIRECTIVES                                                    *
  *                                                                         *
@@ -158,6 +158,9 @@ ParseInf inst[] = {
 
   {"call_c", F_call_c, 3, {ATOM, L1(ANY), L1(ANY)}},
 
+  {"fact_table", F_fact_table, 1, {INTEGER}},
+  {"fact_table_data", F_fact_table_data, 1, {L1(ANY)}},
+
   {"foreign_call_c", F_foreign_call_c, 5, {ATOM, ATOM, F_N, INTEGER,
 					   L2(ATOM, ATOM)}},
 
@@ -427,6 +430,14 @@ Read_Argument(ArgTyp arg_type, ArgVal **top)
     case ANY:
       t1 = Scanner(1);
       top1 = *top;		/* to update type if needed */
+      if (t1 == '(')		/* ( ATOM ) (useful for operators) */
+	{
+	  Read_Token(ATOM);
+	  Read_Token(')');
+	  Add_Arg(*top, PlLong, ATOM);
+	  Add_Arg(*top, char *, strdup(str_val));
+	  return;
+	}
       Add_Arg(*top, PlLong, t1);
 
       if (t1 == INTEGER)
@@ -440,6 +451,17 @@ Read_Argument(ArgTyp arg_type, ArgVal **top)
 
 				/* t1 is an ATOM */
 
+      if (*str_val == '-' && str_val[1] == '\0' && isdigit(*cur_line_p))
+	{			/* a negative number (- is a symbol char) */
+	  t1 = Scanner(0);
+	  Add_Arg(top1, PlLong, t1);
+	  int_val = -int_val;
+	  dbl_val = -dbl_val;
+	  if (t1 == INTEGER)
+	    goto load_integer;
+	  goto load_float;
+	}
+
       if ((*str_val == 'x' || *str_val == 'y') && str_val[1] == '\0' &&
 	  Peek_Char(0) == '(')
 	{
@@ -178,3 +178,7 @@ void F_function(ArgVal arg[]);
 void F_call_c(ArgVal arg[]);
 
 void F_foreign_call_c(ArgVal arg[]);
+
+void F_fact_table(ArgVal arg[]);
+
+void F_fact_table_data(ArgVal arg[]);